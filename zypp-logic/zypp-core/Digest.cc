@@ -13,6 +13,8 @@
 */
 
 #include <cstdio> // snprintf
+#include <fcntl.h>
+#include <unistd.h>
 
 #include <openssl/evp.h>
 #include <openssl/conf.h>
@@ -26,6 +28,7 @@
 #include <string>
 #include <string.h>
 
+#include <algorithm>
 #include <iostream>
 #include <sstream>
 
@@ -354,4 +357,160 @@ namespace zypp {
       return digest( name, is, bufsize );
     }
 
+    ///////////////////////////////////////////////////////////////////
+    // MultiDigest
+    ///////////////////////////////////////////////////////////////////
+
+    namespace
+    {
+      /** Data are fed into the digests in chunks of this size, so each chunk is still cached when passed to the next digest. */
+      constexpr size_t multiDigestChunk = 256 * 1024;
+    } // namespace
+
+    class MultiDigest::P
+    {
+      public:
+        std::vector<Digest> digests;
+        zypp::ByteCount bytesHashed;
+
+        Digest * find( const std::string & name_r )
+        {
+          for ( Digest & d : digests ) {
+            if ( d.name() == name_r )
+              return &d;
+          }
+          return nullptr;
+        }
+    };
+
+    MultiDigest::MultiDigest() : _dp( std::make_unique<P>() )
+    {}
+
+    MultiDigest::MultiDigest( const std::vector<std::string> & names_r ) : MultiDigest()
+    {
+      for ( const std::string & name : names_r )
+        add( name );
+    }
+
+    MultiDigest::~MultiDigest()
+    {}
+
+    MultiDigest::MultiDigest( MultiDigest && other ) noexcept : _dp( std::move(other._dp) )
+    {}
+
+    MultiDigest & MultiDigest::operator=( MultiDigest && other ) noexcept
+    {
+      _dp = std::move( other._dp );
+      return *this;
+    }
+
+    bool MultiDigest::add( const std::string & name_r )
+    {
+      if ( _dp->find( name_r ) )
+        return true;
+      Digest d;
+      if ( ! d.create( name_r ) )
+        return false;
+      _dp->digests.push_back( std::move(d) );
+      return true;
+    }
+
+    std::vector<std::string> MultiDigest::names() const
+    {
+      std::vector<std::string> ret;
+      ret.reserve( _dp->digests.size() );
+      for ( Digest & d : _dp->digests )
+        ret.push_back( d.name() );
+      return ret;
+    }
+
+    bool MultiDigest::empty() const
+    { return _dp->digests.empty(); }
+
+    bool MultiDigest::update( const char * bytes, size_t len )
+    {
+      if ( !bytes )
+        return false;
+
+      while ( len )
+      {
+        size_t chunk = std::min( len, multiDigestChunk );
+        for ( Digest & d : _dp->digests ) {
+          if ( !d.update( bytes, chunk ) )
+            return false;
+        }
+        _dp->bytesHashed += chunk;
+        bytes += chunk;
+        len -= chunk;
+      }
+      return true;
+    }
+
+    bool MultiDigest::update( std::istream & is, size_t bufsize )
+    {
+      if ( !is )
+        return false;
+
+      std::vector<char> buf( bufsize ? bufsize : multiDigestChunk );
+      while ( is.good() )
+      {
+        is.read( buf.data(), buf.size() );
+        size_t readed = is.gcount();
+        if ( readed && !update( buf.data(), readed ) )
+          return false;
+      }
+      return true;
+    }
+
+    bool MultiDigest::updateFile( const Pathname & file_r )
+    {
+      AutoFD fd { ::open( file_r.c_str(), O_RDONLY|O_CLOEXEC ) };
+      if ( fd == -1 )
+        return false;
+
+      // Files are not mapped into memory: a file truncated while being
+      // hashed would raise SIGBUS instead of a read error.
+      ::posix_fadvise( fd, 0, 0, POSIX_FADV_SEQUENTIAL );
+      std::vector<char> buf( multiDigestChunk );
+      while ( true )
+      {
+        ssize_t readed = ::read( fd, buf.data(), buf.size() );
+        if ( readed == 0 )
+          break;
+        if ( readed < 0 )
+        {
+          if ( errno == EINTR )
+            continue;
+          return false;
+        }
+        if ( !update( buf.data(), readed ) )
+          return false;
+      }
+      return true;
+    }
+
+    ByteCount MultiDigest::bytesHashed() const
+    { return _dp->bytesHashed; }
+
+    std::string MultiDigest::digest( const std::string & name_r )
+    {
+      Digest * d = _dp->find( name_r );
+      return d ? d->digest() : std::string();
+    }
+
+    std::map<std::string,std::string> MultiDigest::fileDigests( const std::vector<std::string> & names_r, const Pathname & file_r )
+    {
+      std::map<std::string,std::string> ret;
+      MultiDigest md( names_r );
+      if ( md.empty() || !md.updateFile( file_r ) )
+        return ret;
+
+      for ( const std::string & name : names_r ) {
+        std::string sum { md.digest( name ) };
+        if ( !sum.empty() )
+          ret[name] = std::move(sum);
+      }
+      return ret;
+    }
+
 } // namespace zypp
@@ -18,7 +18,9 @@
 #include <string>
 #include <iosfwd>
 #include <memory>
+#include <map>
 #include <optional>
+#include <vector>
 
 #include <zypp-core/Pathname.h>
 #include <zypp-core/ByteArray.h>
@@ -171,6 +173,81 @@ namespace zypp {
         static std::string digest( const std::string & name, const std::string & input, size_t bufsize = 4096 );
     };
 
+    /** \brief Compute several message digests in one pass over the data.
+     *
+     * Callers needing more than one digest of the same data (e.g. sha256
+     * for verification and md5 for a legacy check) should not read it
+     * once per algorithm. Each chunk passed to \ref update is fed into all
+     * digests while it is still in the CPU cache.
+     *
+     * \ref updateFile reads a file without an intermediate stream, using
+     * a large buffer.
+     *
+     * \code
+     *   MultiDigest md( { Digest::sha256(), Digest::md5() } );
+     *   if ( md.updateFile( file ) )
+     *     MIL << md.digest( Digest::sha256() ) << " " << md.digest( Digest::md5() ) << endl;
+     * \endcode
+     */
+    class MultiDigest
+    {
+      public:
+        MultiDigest();
+        /** Ctor adding the digest algorithms \a names_r (unsupported ones are ignored). */
+        explicit MultiDigest( const std::vector<std::string> & names_r );
+        ~MultiDigest();
+
+        MultiDigest( MultiDigest && other ) noexcept;
+        MultiDigest & operator=( MultiDigest && other ) noexcept;
+
+        /** \brief Add the digest algorithm \a name_r (no-op if already added).
+         * Data passed to \ref update before are not included.
+         * @return whether \a name_r is supported
+         */
+        bool add( const std::string & name_r );
+
+        /** The names of the digest algorithms added. */
+        std::vector<std::string> names() const;
+
+        /** Whether no digest algorithm was added. */
+        bool empty() const;
+
+        /** \brief feed data into all digests
+         * @return whether an error occured
+         */
+        bool update( const char * bytes, size_t len );
+
+        /** \brief feed data read from \a is into all digests
+         * @return whether an error occured
+         */
+        bool update( std::istream & is, size_t bufsize = 65536 );
+
+        /** \brief feed the content of \a file_r into all digests
+         * @return whether an error occured (e.g. \a file_r is not readable)
+         */
+        bool updateFile( const Pathname & file_r );
+
+        /** Returns the number of input bytes that have been added to the hashes. */
+        zypp::ByteCount bytesHashed() const;
+
+        /** \brief get hex string representation of the digest \a name_r
+         *
+         * This finalizes the computation of \a name_r. Empty if \a name_r
+         * was not added.
+         */
+        std::string digest( const std::string & name_r );
+
+        /** \brief compute the digests \a names_r of a file. convenience function
+         * @return the digests by name; empty if the file can't be read,
+         * unsupported algorithms are omitted.
+         */
+        static std::map<std::string,std::string> fileDigests( const std::vector<std::string> & names_r, const Pathname & file_r );
+
+      private:
+        class P;
+        std::unique_ptr<P> _dp;
+    };
+
 } // namespace zypp
 
 #endif
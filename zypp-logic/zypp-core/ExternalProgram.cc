@@ -22,6 +22,7 @@
 
 #include <cstring> // strsignal
 #include <iostream>
+#include <memory>
 #include <sstream>
 
 #include <zypp-core/AutoDispose.h>
@@ -395,9 +396,11 @@ namespace zypp {
             else if ( retval )
             {
               // Data is available now.
-              static size_t linebuffer_size = 0;      // static because getline allocs
-              static char * linebuffer = 0;           // and reallocs if buffer is too small
-              getline( &linebuffer, &linebuffer_size, inputfile );
+              static thread_local size_t linebuffer_size = 0;      // static because getline allocs
+              static thread_local std::unique_ptr<char, decltype(&::free)> linebuffer { nullptr, &::free };  // and reallocs if buffer is too small
+              char * buf = linebuffer.release();
+              getline( &buf, &linebuffer_size, inputfile );
+              linebuffer.reset( buf );
               // ::feof check is important as select returns
               // positive if the file was closed.
               if ( ::feof( inputfile ) )
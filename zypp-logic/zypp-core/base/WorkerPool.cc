@@ -0,0 +1,129 @@
+/*---------------------------------------------------------------------\
+|                          ____ _   __ __ ___                          |
+|                         |__  / \ / / . \ . \                         |
+|                           / / \ V /|  _/  _/                         |
+|                          / /__ | | | | | |                           |
+|                         /_____||_| |_| |_|                           |
+|                                                                      |
+\---------------------------------------------------------------------*/
+/** \file	zypp/base/WorkerPool.cc
+ */
+#include <zypp-core/base/WorkerPool_p.h>
+#include <zypp-core/base/Logger.h>
+#include <zypp-core/base/Exception.h>
+#include <zypp-core/ng/base/private/threaddata_p.h>
+#include <zypp-core/ng/base/private/linuxhelpers_p.h>
+
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace zypp
+{
+  struct WorkerPool::Impl
+  {
+    Impl( unsigned maxThreads_r )
+    : _maxThreads( maxThreads_r ? maxThreads_r : WorkerPool::defaultThreads() )
+    {}
+
+    ~Impl()
+    {
+      {
+        std::unique_lock<std::mutex> lk( _m );
+        _idle.wait( lk, [this]() { return _jobs.empty() && _busy == 0; } );
+        _stop = true;
+      }
+      _wakeup.notify_all();
+      for ( auto & t : _threads )
+        t.join();
+    }
+
+    void enqueue( Job && job_r )
+    {
+      {
+        std::lock_guard<std::mutex> lk( _m );
+        _jobs.push_back( std::move(job_r) );
+        // start another thread if all running ones are busy
+        if ( _threads.size() < _maxThreads && _busy + _jobs.size() > _threads.size() )
+          _threads.emplace_back( [this]() { run(); } );
+      }
+      _wakeup.notify_one();
+    }
+
+    void waitAll()
+    {
+      std::unique_lock<std::mutex> lk( _m );
+      _idle.wait( lk, [this]() { return _jobs.empty() && _busy == 0; } );
+    }
+
+    void run()
+    {
+      // force the kernel to pick another thread to handle signals
+      zyppng::blockAllSignalsForCurrentThread();
+      zyppng::ThreadData::current().setName("Zypp-Worker");
+
+      std::unique_lock<std::mutex> lk( _m );
+      while ( true )
+      {
+        _wakeup.wait( lk, [this]() { return _stop || ! _jobs.empty(); } );
+        if ( _jobs.empty() )
+          break;	// _stop
+
+        Job job { std::move(_jobs.front()) };
+        _jobs.pop_front();
+        ++_busy;
+        lk.unlock();
+        try
+        {
+          job();
+        }
+        catch ( const Exception & excpt )
+        {
+          ZYPP_CAUGHT( excpt );
+          ERR << "WorkerPool job failed: " << excpt << std::endl;
+        }
+        catch ( const std::exception & excpt )
+        {
+          ERR << "WorkerPool job failed: " << excpt.what() << std::endl;
+        }
+        lk.lock();
+        --_busy;
+        if ( _jobs.empty() && _busy == 0 )
+          _idle.notify_all();
+      }
+    }
+
+    const unsigned _maxThreads;
+
+    std::mutex _m;	// < locks all data below
+    std::condition_variable _wakeup;
+    std::condition_variable _idle;
+    std::deque<Job> _jobs;
+    std::vector<std::thread> _threads;
+    unsigned _busy = 0;
+    bool _stop = false;
+  };
+
+  WorkerPool::WorkerPool( unsigned maxThreads_r )
+  : _pimpl( new Impl( maxThreads_r ) )
+  {}
+
+  WorkerPool::~WorkerPool()
+  {}
+
+  unsigned WorkerPool::maxThreads() const
+  { return _pimpl->_maxThreads; }
+
+  void WorkerPool::enqueue( Job job_r )
+  { _pimpl->enqueue( std::move(job_r) ); }
+
+  void WorkerPool::waitAll()
+  { _pimpl->waitAll(); }
+
+  unsigned WorkerPool::defaultThreads()
+  { return std::max( 1U, std::thread::hardware_concurrency() ); }
+
+} // namespace zypp
@@ -0,0 +1,65 @@
+/*---------------------------------------------------------------------\
+|                          ____ _   __ __ ___                          |
+|                         |__  / \ / / . \ . \                         |
+|                           / / \ V /|  _/  _/                         |
+|                          / /__ | | | | | |                           |
+|                         /_____||_| |_| |_|                           |
+|                                                                      |
+\---------------------------------------------------------------------*/
+/** \file	zypp/base/WorkerPool_p.h
+ * This file contains private API, it will change without notice.
+ * You have been warned.
+*/
+#ifndef ZYPP_BASE_WORKERPOOL_P_H
+#define ZYPP_BASE_WORKERPOOL_P_H
+
+#include <functional>
+#include <memory>
+
+#include <zypp-core/Globals.h>
+#include <zypp-core/base/NonCopyable.h>
+
+namespace zypp
+{
+  ///////////////////////////////////////////////////////////////////
+  /// \class WorkerPool
+  /// \brief Bounded set of worker threads processing queued jobs.
+  ///
+  /// Threads are started on demand, up to \ref maxThreads. Jobs are
+  /// picked in the order they were enqueued. A job must not throw;
+  /// escaping exceptions are caught and logged.
+  ///
+  /// \note Jobs run outside the main thread. They must not send
+  /// callback reports or touch the pool/target.
+  ///////////////////////////////////////////////////////////////////
+  class ZYPP_LOCAL WorkerPool : private base::NonCopyable
+  {
+  public:
+    using Job = std::function<void()>;
+
+    /** Ctor; \a maxThreads_r \c 0 means \ref defaultThreads. */
+    explicit WorkerPool( unsigned maxThreads_r = 0 );
+
+    /** Dtor waits until all enqueued jobs are done. */
+    ~WorkerPool();
+
+    /** Max. number of threads working concurrently. */
+    unsigned maxThreads() const;
+
+    /** Queue a job for execution. */
+    void enqueue( Job job_r );
+
+    /** Block until all jobs enqueued so far are done. */
+    void waitAll();
+
+  public:
+    /** Number of hardware threads (at least 1). */
+    static unsigned defaultThreads();
+
+  private:
+    struct Impl;
+    std::unique_ptr<Impl> _pimpl;
+  };
+
+} // namespace zypp
+#endif // ZYPP_BASE_WORKERPOOL_P_H
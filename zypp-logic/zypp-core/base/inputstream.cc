@@ -20,6 +20,14 @@
   #include <zypp-core/base/ZckStream>
 #endif
 
+#ifdef ENABLE_ZSTD_COMPRESSION
+  #include <zypp-core/base/ZstdStream>
+#endif
+
+#ifdef ENABLE_XZ_COMPRESSION
+  #include <zypp-core/base/XzStream>
+#endif
+
 #include <zypp-core/fs/PathInfo.h>
 
 using std::endl;
@@ -42,10 +50,23 @@ namespace zypp
 
     inline shared_ptr<std::istream> streamForFile ( const Pathname & file_r )
     {
+      switch ( filesystem::zipType( file_r ) )
+      {
 #ifdef ENABLE_ZCHUNK_COMPRESSION
-      if ( const auto zType = filesystem::zipType( file_r ); zType == filesystem::ZT_ZCHNK )
-        return shared_ptr<std::istream>( new ifzckstream( file_r.asString().c_str() ) );
+        case filesystem::ZT_ZCHNK:
+          return shared_ptr<std::istream>( new ifzckstream( file_r.asString().c_str() ) );
+#endif
+#ifdef ENABLE_ZSTD_COMPRESSION
+        case filesystem::ZT_ZSTD:
+          return shared_ptr<std::istream>( new ifzstdstream( file_r.asString().c_str() ) );
+#endif
+#ifdef ENABLE_XZ_COMPRESSION
+        case filesystem::ZT_XZ:
+          return shared_ptr<std::istream>( new ifxzstream( file_r.asString().c_str() ) );
 #endif
+        default:
+          break;
+      }
 
       //fall back to gzstream
       return shared_ptr<std::istream>( new ifgzstream( file_r.asString().c_str() ) );
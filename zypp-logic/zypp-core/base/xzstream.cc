@@ -0,0 +1,204 @@
+/*---------------------------------------------------------------------\
+|                          ____ _   __ __ ___                          |
+|                         |__  / \ / / . \ . \                         |
+|                           / / \ V /|  _/  _/                         |
+|                          / /__ | | | | | |                           |
+|                         /_____||_| |_| |_|                           |
+|                                                                      |
+\---------------------------------------------------------------------*/
+#include "xzstream.h"
+#include <zypp-core/base/String.h>
+#include <zypp-core/base/WorkerPool_p.h>
+
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <errno.h>
+
+#include <lzma.h>
+
+namespace zypp {
+
+  namespace detail {
+
+    namespace {
+      uint32_t decoderThreads()
+      {
+        if ( const char * env = ::getenv( "ZYPP_XZ_THREADS" ) ) {
+          uint32_t threads = str::strtonum<uint32_t>( env );
+          if ( threads )
+            return threads;
+        }
+        return WorkerPool::defaultThreads();
+      }
+
+      const char * lzmaErrorString( lzma_ret ret_r )
+      {
+        switch ( ret_r ) {
+          case LZMA_MEM_ERROR:		return "Memory allocation failed";
+          case LZMA_MEMLIMIT_ERROR:	return "Memory usage limit reached";
+          case LZMA_FORMAT_ERROR:	return "File format not recognized";
+          case LZMA_OPTIONS_ERROR:	return "Unsupported options";
+          case LZMA_DATA_ERROR:		return "Compressed data is corrupt";
+          case LZMA_BUF_ERROR:		return "Unexpected end of input";
+          default:			break;
+        }
+        return "Unknown error";
+      }
+    } // namespace
+
+    struct xzstreambufimpl::Stream
+    {
+      ~Stream()
+      { ::lzma_end( &_strm ); }
+
+      lzma_stream _strm = LZMA_STREAM_INIT;
+    };
+
+    xzstreambufimpl::xzstreambufimpl()
+    {}
+
+    xzstreambufimpl::~xzstreambufimpl()
+    {
+      closeImpl();
+    }
+
+    bool xzstreambufimpl::openImpl( const char *name_r, std::ios_base::openmode mode_r )
+    {
+      if ( isOpen() )
+        return false;
+
+      if ( mode_r != std::ios_base::in ) {
+        _lastErr = str::Format("Xz backend does not support the given open mode.");
+        return false;
+      }
+
+      _fd = ::open( name_r, O_RDONLY | O_CLOEXEC );
+      if ( _fd < 0 ) {
+        const int errSrv = errno;
+        _lastErr = str::Format("Opening file failed: %1%") % ::strerror( errSrv );
+        return false;
+      }
+      ::posix_fadvise( _fd, 0, 0, POSIX_FADV_SEQUENTIAL );
+
+      _strm.reset( new Stream );
+      lzma_ret ret = LZMA_OK;
+#if LZMA_VERSION >= 50040002
+      lzma_mt mt {};
+      mt.flags = LZMA_CONCATENATED;
+      mt.threads = decoderThreads();
+      // Above memlimit_threading the decoder falls back to a single thread
+      uint64_t physmem = ::lzma_physmem();
+      mt.memlimit_threading = physmem ? physmem / 4 : UINT64_MAX;
+      mt.memlimit_stop = UINT64_MAX;
+      ret = ::lzma_stream_decoder_mt( &_strm->_strm, &mt );
+#else
+      ret = ::lzma_stream_decoder( &_strm->_strm, UINT64_MAX, LZMA_CONCATENATED );
+#endif
+      if ( ret != LZMA_OK ) {
+        _lastErr = str::Format("Xz: %1%") % lzmaErrorString( ret );
+        closeImpl();
+        return false;
+      }
+
+      _inbuf.resize( 64 * 1024 );
+      _eof = false;
+      _streamEnd = false;
+      _currfp = 0;
+      return true;
+    }
+
+    bool xzstreambufimpl::closeImpl()
+    {
+      if ( !isOpen() )
+        return true;
+
+      _strm.reset();
+      ::close( _fd );
+      _fd = -1;
+      return true;
+    }
+
+    std::streamsize xzstreambufimpl::readData(char *buffer_r, std::streamsize maxcount_r)
+    {
+      if ( !isOpen() || !canRead() )
+        return -1;
+
+      if ( _streamEnd )
+        return 0;
+
+      lzma_stream & strm { _strm->_strm };
+      strm.next_out = reinterpret_cast<uint8_t *>(buffer_r);
+      strm.avail_out = maxcount_r;
+
+      while ( strm.avail_out == size_t(maxcount_r) ) {
+        if ( strm.avail_in == 0 && !_eof ) {
+          ssize_t got = 0;
+          do {
+            got = ::read( _fd, _inbuf.data(), _inbuf.size() );
+          } while ( got < 0 && errno == EINTR );
+
+          if ( got < 0 ) {
+            const int errSrv = errno;
+            _lastErr = str::Format("Reading file failed: %1%") % ::strerror( errSrv );
+            return -1;
+          }
+          strm.next_in = reinterpret_cast<const uint8_t *>(_inbuf.data());
+          strm.avail_in = got;
+          _eof = ( got == 0 );
+        }
+
+        lzma_ret ret = ::lzma_code( &strm, _eof ? LZMA_FINISH : LZMA_RUN );
+        if ( ret == LZMA_STREAM_END ) {
+          _streamEnd = true;
+          break;
+        }
+        if ( ret != LZMA_OK ) {
+          _lastErr = str::Format("Xz: %1%") % lzmaErrorString( ret );
+          return -1;
+        }
+      }
+
+      std::streamsize got = maxcount_r - strm.avail_out;
+      _currfp += got;
+      return got;
+    }
+
+    bool xzstreambufimpl::writeData(const char *, std::streamsize)
+    {
+      return false;
+    }
+
+    bool xzstreambufimpl::isOpen() const
+    {
+      return ( _fd >= 0 );
+    }
+
+    bool xzstreambufimpl::canRead() const
+    {
+      return isOpen();
+    }
+
+    bool xzstreambufimpl::canWrite() const
+    {
+      return false;
+    }
+
+    bool xzstreambufimpl::canSeek( std::ios_base::seekdir ) const
+    {
+      return false;
+    }
+
+    off_t xzstreambufimpl::seekTo(off_t, std::ios_base::seekdir , std::ios_base::openmode)
+    {
+      return -1;
+    }
+
+    off_t xzstreambufimpl::tell() const
+    {
+      return _currfp;
+    }
+  }
+
+}
@@ -0,0 +1,81 @@
+/*---------------------------------------------------------------------\
+|                          ____ _   __ __ ___                          |
+|                         |__  / \ / / . \ . \                         |
+|                           / / \ V /|  _/  _/                         |
+|                          / /__ | | | | | |                           |
+|                         /_____||_| |_| |_|                           |
+|                                                                      |
+\---------------------------------------------------------------------*/
+#ifndef ZYPP_CORE_BASE_XZSTREAM_H
+#define ZYPP_CORE_BASE_XZSTREAM_H
+
+#include <iosfwd>
+#include <memory>
+#include <streambuf>
+#include <string>
+#include <vector>
+#include <zypp-core/base/SimpleStreambuf>
+#include <zypp-core/base/fXstream>
+
+namespace zypp {
+
+  namespace detail {
+
+    /**
+     * @short Streambuffer reading xz compressed files.
+     *
+     * Only read mode is supported. Seek is not supported. Concatenated
+     * streams are read one after the other.
+     *
+     * If liblzma provides it, the multi threaded decoder is used. It
+     * decodes independent blocks (\c xz \c -T) concurrently. The number
+     * of threads defaults to the number of hardware threads,
+     * \c $ZYPP_XZ_THREADS overrides it.
+     *
+     * This streambuf is used in @ref ifxzstream.
+     **/
+    class xzstreambufimpl {
+      public:
+
+        using error_type = std::string;
+
+        xzstreambufimpl();
+        ~xzstreambufimpl();
+
+        bool isOpen   () const;
+        bool canRead  () const;
+        bool canWrite () const;
+        bool canSeek  ( std::ios_base::seekdir way_r ) const;
+
+        std::streamsize readData ( char * buffer_r, std::streamsize maxcount_r  );
+        bool writeData( const char * buffer_r, std::streamsize count_r );
+        off_t seekTo( off_t off_r, std::ios_base::seekdir way_r, std::ios_base::openmode omode_r );
+        off_t tell() const;
+
+        error_type error() const { return _lastErr; }
+
+      protected:
+        bool openImpl( const char * name_r, std::ios_base::openmode mode_r );
+        bool closeImpl ();
+
+      private:
+        struct Stream;	///< the lzma_stream
+        int _fd = -1;
+        std::unique_ptr<Stream> _strm;
+        std::vector<char> _inbuf;
+        bool _eof = false;
+        bool _streamEnd = false;
+        off_t _currfp = 0;
+        error_type _lastErr;
+
+    };
+    using XzStreamBuf = detail::SimpleStreamBuf<detail::xzstreambufimpl>;
+  }
+
+  /**
+   * istream reading xz compressed files.
+   **/
+  using ifxzstream = detail::fXstream<std::istream,detail::XzStreamBuf>;
+}
+
+#endif
@@ -0,0 +1,167 @@
+/*---------------------------------------------------------------------\
+|                          ____ _   __ __ ___                          |
+|                         |__  / \ / / . \ . \                         |
+|                           / / \ V /|  _/  _/                         |
+|                          / /__ | | | | | |                           |
+|                         /_____||_| |_| |_|                           |
+|                                                                      |
+\---------------------------------------------------------------------*/
+#include "zstdstream.h"
+#include <zypp-core/base/String.h>
+
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <errno.h>
+
+#include <zstd.h>
+
+namespace zypp {
+
+  namespace detail {
+
+    zstdstreambufimpl::~zstdstreambufimpl()
+    {
+      closeImpl();
+    }
+
+    bool zstdstreambufimpl::openImpl( const char *name_r, std::ios_base::openmode mode_r )
+    {
+      if ( isOpen() )
+        return false;
+
+      if ( mode_r != std::ios_base::in ) {
+        _lastErr = str::Format("Zstd backend does not support the given open mode.");
+        return false;
+      }
+
+      _fd = ::open( name_r, O_RDONLY | O_CLOEXEC );
+      if ( _fd < 0 ) {
+        const int errSrv = errno;
+        _lastErr = str::Format("Opening file failed: %1%") % ::strerror( errSrv );
+        return false;
+      }
+      ::posix_fadvise( _fd, 0, 0, POSIX_FADV_SEQUENTIAL );
+
+      _dCtx = ::ZSTD_createDCtx();
+      if ( !_dCtx ) {
+        _lastErr = "ZSTD_createDCtx failed";
+        closeImpl();
+        return false;
+      }
+      // accept frames written with --long (ZSTD_WINDOWLOG_MAX needs ZSTD_STATIC_LINKING_ONLY)
+      ::ZSTD_DCtx_setParameter( _dCtx, ZSTD_d_windowLogMax, sizeof(size_t) == 4 ? 30 : 31 );
+
+      _inbuf.resize( ::ZSTD_DStreamInSize() );
+      _inpos = _inlen = 0;
+      _eof = false;
+      _frameDone = true;
+      _flushPending = false;
+      _currfp = 0;
+      return true;
+    }
+
+    bool zstdstreambufimpl::closeImpl()
+    {
+      if ( !isOpen() )
+        return true;
+
+      ::ZSTD_freeDCtx( _dCtx );
+      _dCtx = nullptr;
+      ::close( _fd );
+      _fd = -1;
+      return true;
+    }
+
+    bool zstdstreambufimpl::fillInput()
+    {
+      ssize_t got = 0;
+      do {
+        got = ::read( _fd, _inbuf.data(), _inbuf.size() );
+      } while ( got < 0 && errno == EINTR );
+
+      if ( got < 0 ) {
+        const int errSrv = errno;
+        _lastErr = str::Format("Reading file failed: %1%") % ::strerror( errSrv );
+        return false;
+      }
+      _inpos = 0;
+      _inlen = got;
+      _eof = ( got == 0 );
+      return true;
+    }
+
+    std::streamsize zstdstreambufimpl::readData(char *buffer_r, std::streamsize maxcount_r)
+    {
+      if ( !isOpen() || !canRead() )
+        return -1;
+
+      ZSTD_outBuffer out { buffer_r, size_t(maxcount_r), 0 };
+      while ( out.pos == 0 ) {
+        // If the last call filled the whole buffer, the decoder may hold
+        // more data to flush before new input is needed.
+        if ( _inpos == _inlen && !_flushPending ) {
+          if ( !_eof && !fillInput() )
+            return -1;
+          if ( _eof ) {
+            if ( !_frameDone ) {
+              _lastErr = "Zstd: unexpected end of file";
+              return -1;
+            }
+            return 0;
+          }
+        }
+
+        ZSTD_inBuffer in { _inbuf.data(), _inlen, _inpos };
+        size_t ret = ::ZSTD_decompressStream( _dCtx, &out, &in );
+        _inpos = in.pos;
+        if ( ::ZSTD_isError( ret ) ) {
+          _lastErr = str::Format("Zstd: %1%") % ::ZSTD_getErrorName( ret );
+          return -1;
+        }
+        _frameDone = ( ret == 0 );
+        _flushPending = ( out.pos == out.size );
+      }
+
+      _currfp += out.pos;
+      return out.pos;
+    }
+
+    bool zstdstreambufimpl::writeData(const char *, std::streamsize)
+    {
+      return false;
+    }
+
+    bool zstdstreambufimpl::isOpen() const
+    {
+      return ( _fd >= 0 );
+    }
+
+    bool zstdstreambufimpl::canRead() const
+    {
+      return isOpen();
+    }
+
+    bool zstdstreambufimpl::canWrite() const
+    {
+      return false;
+    }
+
+    bool zstdstreambufimpl::canSeek( std::ios_base::seekdir ) const
+    {
+      return false;
+    }
+
+    off_t zstdstreambufimpl::seekTo(off_t, std::ios_base::seekdir , std::ios_base::openmode)
+    {
+      return -1;
+    }
+
+    off_t zstdstreambufimpl::tell() const
+    {
+      return _currfp;
+    }
+  }
+
+}
@@ -0,0 +1,81 @@
+/*---------------------------------------------------------------------\
+|                          ____ _   __ __ ___                          |
+|                         |__  / \ / / . \ . \                         |
+|                           / / \ V /|  _/  _/                         |
+|                          / /__ | | | | | |                           |
+|                         /_____||_| |_| |_|                           |
+|                                                                      |
+\---------------------------------------------------------------------*/
+#ifndef ZYPP_CORE_BASE_ZSTDSTREAM_H
+#define ZYPP_CORE_BASE_ZSTDSTREAM_H
+
+#include <iosfwd>
+#include <streambuf>
+#include <string>
+#include <vector>
+#include <zypp-core/base/SimpleStreambuf>
+#include <zypp-core/base/fXstream>
+
+using ZSTD_DCtx = struct ZSTD_DCtx_s;
+
+namespace zypp {
+
+  namespace detail {
+
+    /**
+     * @short Streambuffer reading zstd compressed files.
+     *
+     * Only read mode is supported. Seek is not supported. Files may
+     * contain multiple frames, frames compressed with \c --long are
+     * supported up to the max. window size.
+     *
+     * This streambuf is used in @ref ifzstdstream.
+     **/
+    class zstdstreambufimpl {
+      public:
+
+        using error_type = std::string;
+
+        ~zstdstreambufimpl();
+
+        bool isOpen   () const;
+        bool canRead  () const;
+        bool canWrite () const;
+        bool canSeek  ( std::ios_base::seekdir way_r ) const;
+
+        std::streamsize readData ( char * buffer_r, std::streamsize maxcount_r  );
+        bool writeData( const char * buffer_r, std::streamsize count_r );
+        off_t seekTo( off_t off_r, std::ios_base::seekdir way_r, std::ios_base::openmode omode_r );
+        off_t tell() const;
+
+        error_type error() const { return _lastErr; }
+
+      protected:
+        bool openImpl( const char * name_r, std::ios_base::openmode mode_r );
+        bool closeImpl ();
+
+      private:
+        bool fillInput();
+
+        int _fd = -1;
+        ZSTD_DCtx *_dCtx = nullptr;
+        std::vector<char> _inbuf;
+        size_t _inpos = 0;
+        size_t _inlen = 0;
+        bool _eof = false;
+        bool _frameDone = true;	///< whether the last frame is complete
+        bool _flushPending = false;	///< whether the decoder may hold more output
+        off_t _currfp = 0;
+        error_type _lastErr;
+
+    };
+    using ZstdStreamBuf = detail::SimpleStreamBuf<detail::zstdstreambufimpl>;
+  }
+
+  /**
+   * istream reading zstd compressed files.
+   **/
+  using ifzstdstream = detail::fXstream<std::istream,detail::ZstdStreamBuf>;
+}
+
+#endif
@@ -11,19 +11,30 @@
 */
 
 #include <utime.h>     // for ::utime
+#include <sys/ioctl.h>
+#include <sys/sendfile.h>
 #include <sys/statvfs.h>
 #include <sys/sysmacros.h> // for ::minor, ::major macros
+#include <linux/fs.h>      // for FICLONE
 
+#include <algorithm>
+#include <atomic>
 #include <iostream>
 #include <fstream>
 #include <iomanip>
+#include <map>
+#include <mutex>
+#include <unordered_map>
 #include <utility>
+#include <vector>
 
 #include <zypp-core/fs/PathInfo.h>
+#include <zypp-core/fs/RememberedChecksums_p.h>
 #include <zypp-core/base/LogTools.h>
 #include <zypp-core/base/String.h>
 #include <zypp-core/base/IOStream.h>
 #include <zypp-core/base/Errno.h>
+#include <zypp-core/base/WorkerPool_p.h>
 
 #include <zypp-core/AutoDispose.h>
 #include <zypp-core/ExternalProgram.h>
@@ -460,12 +471,317 @@ namespace zypp
       return logResult( recursive_rmdir_1( path, false/* don't remove path itself */ ) );
     }
 
+    ///////////////////////////////////////////////////////////////////
+    namespace
+    {
+      /** Copy the data of \a in_r to \a out_r.
+       * Try a reflink (shares the data blocks on CoW filesystems),
+       * copy_file_range (in kernel copy, server side on NFS/CIFS), sendfile
+       * and finally read/write; whatever works first.
+       * \return \c 0 on success, errno on failure.
+       */
+      int copyFileData( int in_r, int out_r, off_t size_r )
+      {
+        static const size_t chunk = 16 * 1024 * 1024;
+
+        if ( size_r > 0 )	// files like those in /proc report size 0 but have content
+        {
+#ifdef FICLONE
+          if ( ::ioctl( out_r, FICLONE, in_r ) == 0 )
+            return 0;
+#endif
+          bool fallback = false;
+          for ( off_t done = 0; ! fallback; )
+          {
+            ssize_t n = ::copy_file_range( in_r, nullptr, out_r, nullptr, chunk, 0 );
+            if ( n > 0 )
+              done += n;
+            else if ( n == 0 )
+              return 0;
+            else if ( errno == EINTR )
+              continue;
+            else if ( done == 0 && ( errno == ENOSYS || errno == EXDEV || errno == EINVAL || errno == EOPNOTSUPP || errno == EBADF ) )
+              fallback = true;
+            else
+              return errno;
+          }
+
+          fallback = false;
+          for ( off_t done = 0; ! fallback; )
+          {
+            ssize_t n = ::sendfile( out_r, in_r, nullptr, chunk );
+            if ( n > 0 )
+              done += n;
+            else if ( n == 0 )
+              return 0;
+            else if ( errno == EINTR )
+              continue;
+            else if ( done == 0 && ( errno == ENOSYS || errno == EINVAL ) )
+              fallback = true;
+            else
+              return errno;
+          }
+        }
+
+        std::vector<char> buf( 128 * 1024 );
+        while ( true )
+        {
+          ssize_t n = ::read( in_r, buf.data(), buf.size() );
+          if ( n == 0 )
+            return 0;
+          if ( n == -1 )
+          {
+            if ( errno == EINTR )
+              continue;
+            return errno;
+          }
+          for ( const char * p = buf.data(); n > 0; )
+          {
+            ssize_t w = ::write( out_r, p, n );
+            if ( w == -1 )
+            {
+              if ( errno == EINTR )
+                continue;
+              return errno;
+            }
+            p += w;
+            n -= w;
+          }
+        }
+      }
+
+      /** Copy regular file \a src_r to \a dst_r.
+       * If \a dst_r does not exist it is created with \a mode_r (less umask).
+       * An existing \a dst_r is overwritten, or removed before if
+       * \a removeDestination_r is set.
+       * \return \c 0 on success, errno on failure (\c EEXIST if \a dst_r
+       * is \a src_r or a hardlink to it).
+       */
+      int copyFileTo( const Pathname & src_r, const Pathname & dst_r, mode_t mode_r, bool removeDestination_r )
+      {
+        AutoFD in { ::open( src_r.c_str(), O_RDONLY|O_CLOEXEC ) };
+        if ( in == -1 )
+          return errno;
+
+        struct ::stat st;
+        if ( ::fstat( in, &st ) == -1 )
+          return errno;
+
+        // Copying a file onto itself would truncate it.
+        auto sameFile = [&st]( const struct ::stat & dst_r ) {
+          return dst_r.st_dev == st.st_dev && dst_r.st_ino == st.st_ino;
+        };
+        struct ::stat dst;
+        if ( removeDestination_r )
+        {
+          if ( ::stat( dst_r.c_str(), &dst ) == 0 && sameFile( dst ) )
+            return EEXIST;
+          if ( ::unlink( dst_r.c_str() ) == -1 && errno != ENOENT )
+            return errno;
+        }
+
+        int out = ::open( dst_r.c_str(), O_WRONLY|O_CREAT|O_CLOEXEC, mode_r );
+        if ( out == -1 )
+          return errno;
+        if ( ::fstat( out, &dst ) == 0 && sameFile( dst ) )
+        {
+          ::close( out );
+          return EEXIST;
+        }
+
+        int ret = ( ::ftruncate( out, 0 ) == -1 ) ? errno : copyFileData( in, out, st.st_size );
+        if ( ::close( out ) == -1 && ret == 0 )
+          ret = errno;
+        if ( ret != 0 )
+          ::unlink( dst_r.c_str() );	// don't leave a partial copy
+        return ret;
+      }
+
+      /** Copy \a path_r and everything below it like 'cp -dR'.
+       * Directories, symlinks and special files are created while walking
+       * the tree. Regular files are copied by up to \c jobs_r threads.
+       * Files hardlinked in the source are hardlinked in the copy too.
+       * Like cp, the copy goes on if an entry fails; the first error is
+       * reported.
+       */
+      class TreeCopy
+      {
+      public:
+        explicit TreeCopy( unsigned jobs_r )
+        {
+          if ( jobs_r != 1 )
+            _pool.reset( new WorkerPool( jobs_r ) );
+        }
+
+        /** Copy \a src_r to \a dst_r. Unless \a deref_r, a symlink \a src_r is copied as symlink.
+         * An existing directory \a dst_r receives the content of \a src_r.
+         */
+        int run( const Pathname & src_r, const Pathname & dst_r, bool deref_r )
+        {
+          struct ::stat st;
+          if ( ( deref_r ? ::stat( src_r.c_str(), &st ) : ::lstat( src_r.c_str(), &st ) ) == -1 )
+            return errno;
+          copyEntry( src_r, dst_r, st, /*top*/true );
+
+          if ( _pool )
+            _pool->waitAll();
+
+          for ( const auto & link : _links )
+          {
+            if ( ( ::unlink( link.second.c_str() ) == -1 && errno != ENOENT )
+                 || ::link( link.first.c_str(), link.second.c_str() ) == -1 )
+              fail( errno, link.second );
+          }
+          // Fix the modes of directories which were not writable for us.
+          for ( auto it = _dirModes.rbegin(); it != _dirModes.rend(); ++it )
+          {
+            if ( ::chmod( it->first.c_str(), it->second ) == -1 )
+              fail( errno, it->first );
+          }
+          return _error;
+        }
+
+      private:
+        void fail( int error_r, const Pathname & path_r )
+        {
+          WAR << "copy " << path_r << " FAILED: " << str::strerror( error_r ) << endl;
+          int none = 0;
+          _error.compare_exchange_strong( none, error_r );
+        }
+
+        /** Remove \a dst_r unless it is a directory or does not exist. */
+        bool clearDestination( const Pathname & dst_r )
+        {
+          struct ::stat st;
+          if ( ::lstat( dst_r.c_str(), &st ) == -1 )
+            return true;
+          if ( S_ISDIR(st.st_mode) )
+          {
+            fail( EISDIR, dst_r );
+            return false;
+          }
+          if ( ::unlink( dst_r.c_str() ) == -1 )
+          {
+            fail( errno, dst_r );
+            return false;
+          }
+          return true;
+        }
+
+        void copyEntry( const Pathname & src_r, const Pathname & dst_r, const struct ::stat & st_r, bool top_r = false )
+        {
+          if ( S_ISDIR(st_r.st_mode) )
+            copyDir( src_r, dst_r, st_r, top_r );
+
+          else if ( S_ISREG(st_r.st_mode) )
+          {
+            if ( st_r.st_nlink > 1 )
+            {
+              auto ins = _hardlinks.insert( { { st_r.st_dev, st_r.st_ino }, dst_r } );
+              if ( ! ins.second )
+              {
+                _links.push_back( { ins.first->second, dst_r } );
+                return;
+              }
+            }
+
+            struct ::stat dst;
+            bool removeDestination = false;
+            if ( ::lstat( dst_r.c_str(), &dst ) == 0 )
+            {
+              if ( S_ISDIR(dst.st_mode) )
+                return fail( EISDIR, dst_r );
+              removeDestination = ! S_ISREG(dst.st_mode);	// don't write through a symlink
+            }
+
+            if ( _pool )
+              _pool->enqueue( [this,src_r,dst_r,mode=st_r.st_mode & 0777,removeDestination]() {
+                if ( int res = copyFileTo( src_r, dst_r, mode, removeDestination ) )
+                  fail( res, dst_r );
+              } );
+            else if ( int res = copyFileTo( src_r, dst_r, st_r.st_mode & 0777, removeDestination ) )
+              fail( res, dst_r );
+          }
+
+          else if ( S_ISLNK(st_r.st_mode) )
+          {
+            std::string target( st_r.st_size ? st_r.st_size : PATH_MAX, '\0' );
+            ssize_t len = ::readlink( src_r.c_str(), &target[0], target.size() );
+            if ( len == -1 )
+              return fail( errno, src_r );
+            target.resize( len );
+            if ( clearDestination( dst_r ) && ::symlink( target.c_str(), dst_r.c_str() ) == -1 )
+              fail( errno, dst_r );
+          }
+
+          else	// fifo, socket, device
+          {
+            if ( clearDestination( dst_r ) && ::mknod( dst_r.c_str(), st_r.st_mode & ( S_IFMT | 0777 ), st_r.st_rdev ) == -1 )
+              fail( errno, dst_r );
+          }
+        }
+
+        void copyDir( const Pathname & src_r, const Pathname & dst_r, const struct ::stat & st_r, bool top_r )
+        {
+          struct ::stat dst;
+          if ( ::stat( dst_r.c_str(), &dst ) == 0 )
+          {
+            if ( ! S_ISDIR(dst.st_mode) )
+              return fail( ENOTDIR, dst_r );
+            // existing directories are reused as they are
+          }
+          else
+          {
+            // We need to write the directory, so create it accessible for us
+            // and set the final mode when all is done.
+            if ( ::mkdir( dst_r.c_str(), ( st_r.st_mode & 0777 ) | S_IRWXU ) == -1 || ::stat( dst_r.c_str(), &dst ) == -1 )
+              return fail( errno, dst_r );
+            if ( ( st_r.st_mode & S_IRWXU ) != S_IRWXU )
+              _dirModes.push_back( { dst_r, dst.st_mode & 07777 & ~( S_IRWXU & ~st_r.st_mode ) } );
+          }
+          if ( top_r )
+            _top = { dst.st_dev, dst.st_ino };
+          else if ( _top == std::make_pair( st_r.st_dev, st_r.st_ino ) )
+            return fail( EINVAL, src_r );	// won't copy a directory into itself
+
+          AutoDispose<DIR *> dir( ::opendir( src_r.c_str() ), []( DIR * dir_r ) { if ( dir_r ) ::closedir( dir_r ); } );
+          if ( ! dir )
+            return fail( errno, src_r );
+
+          for ( struct dirent * entry = ::readdir( dir ); entry; entry = ::readdir( dir ) )
+          {
+            if ( entry->d_name[0] == '.' && ( entry->d_name[1] == '\0' || ( entry->d_name[1] == '.' && entry->d_name[2] == '\0' ) ) )
+              continue;
+
+            Pathname src { src_r / entry->d_name };
+            struct ::stat st;
+            if ( ::lstat( src.c_str(), &st ) == -1 )
+              fail( errno, src );
+            else
+              copyEntry( src, dst_r / entry->d_name, st );
+          }
+        }
+
+      private:
+        std::unique_ptr<WorkerPool> _pool;	///< copy files in parallel
+        std::atomic<int> _error { 0 };
+        std::pair<dev_t,ino_t> _top;	///< the top destination directory
+        std::map<std::pair<dev_t,ino_t>,Pathname> _hardlinks;	///< hardlinked source file and its first copy
+        std::vector<std::pair<Pathname,Pathname>> _links;	///< hardlinks to create when the files are copied
+        std::vector<std::pair<Pathname,mode_t>> _dirModes;	///< directory modes to set when all is done
+      };
+    } // namespace
+    ///////////////////////////////////////////////////////////////////
+
     ///////////////////////////////////////////////////////////////////
     //
     //	METHOD NAME : copy_dir
     //	METHOD TYPE : int
     //
     int copy_dir( const Pathname & srcpath, const Pathname & destpath )
+    { return copy_dir( srcpath, destpath, 1 ); }
+
+    int copy_dir( const Pathname & srcpath, const Pathname & destpath, unsigned jobs )
     {
       MIL << "copy_dir " << srcpath << " -> " << destpath << ' ';
 
@@ -484,21 +800,7 @@ namespace zypp
         return logResult( EEXIST );
       }
 
-
-      const char *const argv[] = {
-        "/bin/cp",
-        "-dR",
-        "--",
-        srcpath.asString().c_str(),
-        destpath.asString().c_str(),
-        NULL
-      };
-      ExternalProgram prog( argv, ExternalProgram::Stderr_To_Stdout );
-      for ( string output( prog.receiveLine() ); output.length(); output = prog.receiveLine() ) {
-        MIL << "  " << output;
-      }
-      int ret = prog.close();
-      return logResult( ret, "returned" );
+      return logResult( TreeCopy( jobs ).run( srcpath, tp.path(), /*deref*/false ) );
     }
 
     ///////////////////////////////////////////////////////////////////
@@ -506,7 +808,10 @@ namespace zypp
     //	METHOD NAME : copy_dir_content
     //	METHOD TYPE : int
     //
-    int copy_dir_content(const Pathname & srcpath, const Pathname & destpath)
+    int copy_dir_content( const Pathname & srcpath, const Pathname & destpath )
+    { return copy_dir_content( srcpath, destpath, 1 ); }
+
+    int copy_dir_content( const Pathname & srcpath, const Pathname & destpath, unsigned jobs )
     {
       MIL << "copy_dir " << srcpath << " -> " << destpath << ' ';
 
@@ -524,22 +829,7 @@ namespace zypp
         return logResult( EEXIST );
       }
 
-      std::string src( srcpath.asString());
-      src += "/.";
-      const char *const argv[] = {
-        "/bin/cp",
-        "-dR",
-        "--",
-        src.c_str(),
-        destpath.asString().c_str(),
-        NULL
-      };
-      ExternalProgram prog( argv, ExternalProgram::Stderr_To_Stdout );
-      for ( string output( prog.receiveLine() ); output.length(); output = prog.receiveLine() ) {
-        MIL << "  " << output;
-      }
-      int ret = prog.close();
-      return logResult( ret, "returned" );
+      return logResult( TreeCopy( jobs ).run( srcpath, destpath, /*deref*/true ) );
     }
 
     ///////////////////////////////////////////////////////////////////////
@@ -671,16 +961,53 @@ namespace zypp
       return ((name == rhs.name ) && (type == rhs.type));
     }
 
+    namespace
+    {
+      /** Determine the type of the \a entries_r in \a dir_r by stat'ing them.
+       * Large directories are stat'ed by a bounded number of threads, which
+       * pays on network filesystems where each stat is a round trip.
+       */
+      void statDirEntries( const Pathname & dir_r, const std::vector<DirEntry *> & entries_r, PathInfo::Mode statmode_r )
+      {
+        static constexpr size_t chunk = 64;	// entries stat'ed per job
+        static constexpr unsigned maxJobs = 8;
+
+        auto statRange = [&]( size_t begin_r, size_t end_r ) {
+          for ( size_t i = begin_r; i < end_r; ++i )
+            entries_r[i]->type = PathInfo( dir_r/entries_r[i]->name, statmode_r ).fileType();
+        };
+
+        if ( entries_r.size() <= chunk || WorkerPool::defaultThreads() == 1 ) {
+          statRange( 0, entries_r.size() );
+          return;
+        }
+
+        WorkerPool pool( std::min( WorkerPool::defaultThreads(), maxJobs ) );
+        for ( size_t begin = 0; begin < entries_r.size(); begin += chunk )
+          pool.enqueue( [&statRange,begin,&entries_r]() { statRange( begin, std::min( begin + chunk, entries_r.size() ) ); } );
+        pool.waitAll();
+      }
+    } // namespace
+
     int readdir( DirContent & retlist_r, const Pathname & path_r, bool dots_r, PathInfo::Mode statmode_r )
     {
       retlist_r.clear();
-      return dirForEach( path_r,
-                         [&]( const Pathname & dir_r, const char *const name_r )->bool
-                         {
-                           if ( dots_r || name_r[0] != '.' )
-                             retlist_r.push_back( DirEntry( name_r, PathInfo( dir_r/name_r, statmode_r ).fileType() ) );
-                           return true;
-                         } );
+      // Use the type reported by readdir if it's what stat would tell.
+      // Only the remaining entries need to be stat'ed.
+      std::vector<DirEntry *> unknown;
+      int ret = dirForEachExt( path_r,
+                               [&]( const Pathname & dir_r, const DirEntry & entry_r )->bool
+                               {
+                                 if ( dots_r || entry_r.name[0] != '.' )
+                                 {
+                                   retlist_r.push_back( entry_r );
+                                   if ( entry_r.type == FT_NOT_AVAIL || ( entry_r.type == FT_LINK && statmode_r == PathInfo::STAT ) )
+                                     unknown.push_back( &retlist_r.back() );
+                                 }
+                                 return true;
+                               } );
+      statDirEntries( path_r, unknown, statmode_r );
+      return ret;
     }
 
     std::ostream & operator<<( std::ostream & str, const DirContent & obj )
@@ -836,20 +1163,7 @@ namespace zypp
         return logResult( EISDIR );
       }
 
-      const char *const argv[] = {
-        "/bin/cp",
-        "--remove-destination",
-        "--",
-        file.asString().c_str(),
-        dest.asString().c_str(),
-        NULL
-      };
-      ExternalProgram prog( argv, ExternalProgram::Stderr_To_Stdout );
-      for ( string output( prog.receiveLine() ); output.length(); output = prog.receiveLine() ) {
-        MIL << "  " << output;
-      }
-      int ret = prog.close();
-      return logResult( ret, "returned" );
+      return logResult( copyFileTo( file, dest, sp.st_mode() & 0777, /*removeDestination*/true ) );
     }
 
     ///////////////////////////////////////////////////////////////////
@@ -1006,19 +1320,98 @@ namespace zypp
         return logResult( ENOTDIR );
       }
 
-      const char *const argv[] = {
-        "/bin/cp",
-        "--",
-        file.asString().c_str(),
-        dest.asString().c_str(),
-        NULL
+      return logResult( copyFileTo( file, dest / file.basename(), sp.st_mode() & 0777, /*removeDestination*/false ) );
+    }
+
+    ///////////////////////////////////////////////////////////////////
+    namespace
+    {
+      /** The checksums remembered for a file and what tells us it's unchanged. */
+      struct RememberedFile
+      {
+        RememberedFile()
+        {}
+
+        RememberedFile( const struct ::stat & st_r )
+        : _dev( st_r.st_dev )
+        , _ino( st_r.st_ino )
+        , _size( st_r.st_size )
+        , _mtime( st_r.st_mtim.tv_sec * 1000000000LL + st_r.st_mtim.tv_nsec )
+        , _ctime( st_r.st_ctim.tv_sec * 1000000000LL + st_r.st_ctim.tv_nsec )
+        {}
+
+        bool sameFile( const RememberedFile & rhs ) const
+        { return _dev == rhs._dev && _ino == rhs._ino && _size == rhs._size && _mtime == rhs._mtime && _ctime == rhs._ctime; }
+
+        dev_t _dev = 0;
+        ino_t _ino = 0;
+        off_t _size = 0;
+        long long _mtime = 0;
+        long long _ctime = 0;
+        std::vector<CheckSum> _checksums;
       };
-      ExternalProgram prog( argv, ExternalProgram::Stderr_To_Stdout );
-      for ( string output( prog.receiveLine() ); output.length(); output = prog.receiveLine() ) {
-        MIL << "  " << output;
+
+      constexpr size_t rememberedFilesMax = 4096;	// < forget all if there are more
+
+      std::mutex rememberedFilesLock;
+      std::unordered_map<std::string,RememberedFile> rememberedFiles;
+    } // namespace
+
+    void rememberChecksum( const Pathname & file_r, const CheckSum & checksum_r )
+    {
+      struct ::stat st;
+      if ( checksum_r.empty() || ::stat( file_r.c_str(), &st ) != 0 || ! S_ISREG(st.st_mode) )
+        return;
+
+      RememberedFile now( st );
+      std::lock_guard<std::mutex> lk( rememberedFilesLock );
+      if ( rememberedFiles.size() >= rememberedFilesMax )
+        rememberedFiles.clear();
+
+      RememberedFile & entry { rememberedFiles[file_r.asString()] };
+      if ( ! entry.sameFile( now ) )
+        entry = std::move(now);
+      for ( CheckSum & cs : entry._checksums )
+      {
+        if ( cs.type() == checksum_r.type() )
+        {
+          cs = checksum_r;
+          return;
+        }
       }
-      int ret = prog.close();
-      return logResult( ret, "returned" );
+      entry._checksums.push_back( checksum_r );
+    }
+
+    std::string rememberedChecksum( const Pathname & file_r, const std::string & type_r )
+    {
+      std::lock_guard<std::mutex> lk( rememberedFilesLock );
+      if ( rememberedFiles.empty() )
+        return string();
+
+      auto it = rememberedFiles.find( file_r.asString() );
+      if ( it == rememberedFiles.end() )
+        return string();
+
+      struct ::stat st;
+      if ( ::stat( file_r.c_str(), &st ) != 0 || ! it->second.sameFile( RememberedFile( st ) ) )
+      {
+        rememberedFiles.erase( it );	// changed or gone
+        return string();
+      }
+
+      const std::string & type { str::toLower( type_r ) };
+      for ( const CheckSum & cs : it->second._checksums )
+      {
+        if ( cs.type() == type )
+          return cs.checksum();
+      }
+      return string();
+    }
+
+    void clearRememberedChecksums()
+    {
+      std::lock_guard<std::mutex> lk( rememberedFilesLock );
+      rememberedFiles.clear();
     }
 
     ///////////////////////////////////////////////////////////////////
@@ -1028,14 +1421,7 @@ namespace zypp
     //
     std::string md5sum( const Pathname & file )
     {
-      if ( ! PathInfo( file ).isFile() ) {
-        return string();
-      }
-      std::ifstream istr( file.asString().c_str() );
-      if ( ! istr ) {
-        return string();
-      }
-      return Digest::digest( "MD5", istr );
+      return checksum(file, "MD5");
     }
 
     ///////////////////////////////////////////////////////////////////
@@ -1055,14 +1441,31 @@ namespace zypp
     //
     std::string checksum( const Pathname & file, const std::string &algorithm )
     {
+      auto sums { checksums( file, { algorithm } ) };
+      return sums.empty() ? string() : std::move( sums.begin()->second );
+    }
+
+    std::map<std::string,std::string> checksums( const Pathname & file, const std::vector<std::string> & algorithms )
+    {
+      std::map<std::string,std::string> ret;
       if ( ! PathInfo( file ).isFile() ) {
-        return string();
+        return ret;
       }
-      std::ifstream istr( file.asString().c_str() );
-      if ( ! istr ) {
-        return string();
+      std::vector<std::string> missing;
+      for ( const std::string & algorithm : algorithms ) {
+        std::string remembered { rememberedChecksum( file, algorithm ) };
+        if ( remembered.empty() )
+          missing.push_back( algorithm );
+        else {
+          DBG << "Using the " << algorithm << " checksum computed while downloading " << file << endl;
+          ret[algorithm] = std::move(remembered);
+        }
+      }
+      if ( ! missing.empty() ) {
+        for ( auto & [algorithm, sum] : MultiDigest::fileDigests( missing, file ) )
+          ret[algorithm] = std::move(sum);
       }
-      return Digest::digest( algorithm, istr );
+      return ret;
     }
 
     bool is_checksum( const Pathname & file, const CheckSum &checksum )
@@ -1146,7 +1549,10 @@ namespace zypp
             ret = ZT_BZ2;
           } else if ( magic[0] == '\0' && magic[1] == 'Z' && magic[2] == 'C' && magic[3] == 'K' && magic[4] == '1') {
             ret = ZT_ZCHNK;
-
+          } else if ( magic[0] == 0x28 && magic[1] == 0xB5 && magic[2] == 0x2F && magic[3] == 0xFD ) {
+            ret = ZT_ZSTD;
+          } else if ( magic[0] == 0xFD && magic[1] == '7' && magic[2] == 'z' && magic[3] == 'X' && magic[4] == 'Z' ) {
+            ret = ZT_XZ;
           }
         }
         close( fd );
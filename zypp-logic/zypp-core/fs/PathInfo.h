@@ -27,6 +27,7 @@ extern "C"
 #include <set>
 #include <map>
 #include <utility>
+#include <vector>
 
 #include <zypp-core/Pathname.h>
 #include <zypp-core/ByteCount.h>
@@ -443,24 +444,41 @@ namespace zypp
     int clean_dir( const Pathname & path ) ZYPP_API;
 
     /**
-     * Like 'cp -a srcpath destpath'. Copy directory tree. srcpath/destpath must be
+     * Like 'cp -dR srcpath destpath'. Copy directory tree. srcpath/destpath must be
      * directories. 'basename srcpath' must not exist in destpath.
      *
+     * Symlinks are copied as symlinks, files hardlinked in srcpath are
+     * hardlinked in the copy. Like all copy functions here it does not
+     * run cp, but copies in process (reflink if the filesystem supports it).
+     *
      * @return 0 on success, ENOTDIR if srcpath/destpath is not a directory, EEXIST if
-     * 'basename srcpath' exists in destpath, otherwise the commands return value.
+     * 'basename srcpath' exists in destpath, otherwise the errno of the first failure.
      **/
     int copy_dir( const Pathname & srcpath, const Pathname & destpath ) ZYPP_API;
 
     /**
-     * Like 'cp -a srcpath/. destpath'. Copy the content of srcpath recursively
+     * Like \ref copy_dir, but copy the files using up to \a jobs threads
+     * (\c 0 means one per CPU). Worth it for trees of many files, esp. if
+     * on network or flash storage.
+     **/
+    int copy_dir( const Pathname & srcpath, const Pathname & destpath, unsigned jobs ) ZYPP_API;
+
+    /**
+     * Like 'cp -dR srcpath/. destpath'. Copy the content of srcpath recursively
      * into destpath. Both \p srcpath and \p destpath has to exists.
      *
      * @return 0 on success, ENOTDIR if srcpath/destpath is not a directory,
-     * EEXIST if srcpath and destpath are equal, otherwise the commands
-     * return value.
+     * EEXIST if srcpath and destpath are equal, otherwise the errno of the
+     * first failure.
      */
     int copy_dir_content( const Pathname & srcpath, const Pathname & destpath) ZYPP_API;
 
+    /**
+     * Like \ref copy_dir_content, but copy the files using up to \a jobs
+     * threads (\c 0 means one per CPU).
+     */
+    int copy_dir_content( const Pathname & srcpath, const Pathname & destpath, unsigned jobs ) ZYPP_API;
+
     /**
      * Invoke callback function \a fnc_r for each entry in directory \a dir_r.
      *
@@ -533,7 +551,11 @@ namespace zypp
      * are never reported.
      *
      * The type of individual directory entries is determined accoding to
-     * statmode (i.e. via stat or lstat).
+     * statmode (i.e. via stat or lstat). The type reported by \c ::readdir
+     * is used if it's the same stat would tell; only the remaining entries
+     * (e.g. symlinks if statmode is STAT) are stat'ed, in large directories
+     * by a few threads in parallel. The order of the entries is the one
+     * \c ::readdir returns.
      *
      * @return 0 on success, errno on failure.
      **/
@@ -625,10 +647,11 @@ namespace zypp
     int exchange( const Pathname & lpath, const Pathname & rpath );
 
     /**
-     * Like 'cp file dest'. Copy file to destination file.
+     * Like 'cp --remove-destination file dest'. Copy file to destination file.
      *
      * @return 0 on success, EINVAL if file is not a file, EISDIR if
-     * destiantion is a directory, otherwise the commands return value.
+     * destiantion is a directory, EEXIST if destination is the same
+     * file (or a hardlink to it), otherwise errno.
      **/
     int copy( const Pathname & file, const Pathname & dest ) ZYPP_API;
 
@@ -688,7 +711,7 @@ namespace zypp
      * Like 'cp file dest'. Copy file to dest dir.
      *
      * @return 0 on success, EINVAL if file is not a file, ENOTDIR if dest
-     * is no directory, otherwise the commands return value.
+     * is no directory, EEXIST if the target is the same file, otherwise errno.
      **/
     int copy_file2dir( const Pathname & file, const Pathname & dest );
     //@}
@@ -720,6 +743,14 @@ namespace zypp
      **/
     std::string checksum( const Pathname & file, const std::string &algorithm );
 
+    /**
+     * Compute several checksums of a file, reading it just once.
+     *
+     * @return the checksums by algorithm; unsupported algorithms are
+     * omitted. Empty if the file can't be read.
+     **/
+    std::map<std::string,std::string> checksums( const Pathname & file, const std::vector<std::string> & algorithms );
+
     /**
      * check files checksum
      *
@@ -764,11 +795,11 @@ namespace zypp
     /** \name Misc. */
     //@{
     /**
-     * Test whether a file is compressed (gzip/bzip2).
+     * Test whether a file is compressed (gzip/bzip2/zchunk/zstd/xz).
      *
-     * @return ZT_GZ, ZT_BZ2 if file is compressed, otherwise ZT_NONE.
+     * @return ZT_GZ, ZT_BZ2, ... if file is compressed, otherwise ZT_NONE.
      **/
-    enum ZIP_TYPE { ZT_NONE, ZT_GZ, ZT_BZ2, ZT_ZCHNK };
+    enum ZIP_TYPE { ZT_NONE, ZT_GZ, ZT_BZ2, ZT_ZCHNK, ZT_ZSTD, ZT_XZ };
 
     ZIP_TYPE zipType( const Pathname & file );
 
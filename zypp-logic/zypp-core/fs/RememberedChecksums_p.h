@@ -0,0 +1,46 @@
+/*---------------------------------------------------------------------\
+|                          ____ _   __ __ ___                          |
+|                         |__  / \ / / . \ . \                         |
+|                           / / \ V /|  _/  _/                         |
+|                          / /__ | | | | | |                           |
+|                         /_____||_| |_| |_|                           |
+|                                                                      |
+\---------------------------------------------------------------------*/
+/** \file	zypp/fs/RememberedChecksums_p.h
+ * This file contains private API, it will change without notice.
+ * You have been warned.
+*/
+#ifndef ZYPP_FS_REMEMBEREDCHECKSUMS_P_H
+#define ZYPP_FS_REMEMBEREDCHECKSUMS_P_H
+
+#include <zypp-core/Globals.h>
+#include <zypp-core/Pathname.h>
+#include <zypp-core/CheckSum.h>
+
+namespace zypp
+{
+  namespace filesystem
+  {
+    /** Remember the \a checksum_r of \a file_r, computed while the file was written.
+     *
+     * Downloaders hash the data on the fly. Remembering the result lets
+     * \ref checksum and \ref is_checksum (and so all the \ref FileChecker
+     * verifying a download) answer without reading the file again. The
+     * checksum is used as long as the file is unchanged, i.e. its inode,
+     * size, mtime and ctime are the same as when it was remembered. So
+     * call this after the file got its final name and mode.
+     *
+     * Nothing is remembered if \a checksum_r is empty or \a file_r can't
+     * be stat'ed.
+     */
+    ZYPP_LOCAL void rememberChecksum( const Pathname & file_r, const CheckSum & checksum_r );
+
+    /** The remembered checksum of type \a type_r for \a file_r or an empty string. */
+    ZYPP_LOCAL std::string rememberedChecksum( const Pathname & file_r, const std::string & type_r );
+
+    /** Forget all remembered checksums. */
+    ZYPP_LOCAL void clearRememberedChecksums();
+
+  } // namespace filesystem
+} // namespace zypp
+#endif // ZYPP_FS_REMEMBEREDCHECKSUMS_P_H
@@ -17,6 +17,7 @@
 
 #include <zypp-core/base/Logger.h>
 #include <zypp-core/base/String.h>
+#include <zypp-core/base/StringV.h>
 #include <zypp-core/base/IOStream.h>
 #include <zypp-core/base/UserRequestException>
 
@@ -91,10 +92,13 @@ void IniParser::parse( const InputStream & input_r, const ProgressData::Receiver
   ticks.sendTo(progress);
   ticks.toMin();
 
+  // The buffers are reused, sparing some allocations per line.
+  std::string key;
+  std::string value;
   iostr::EachLine line( input_r );
   for ( ; line; line.next() )
   {
-    std::string trimmed = str::trim(*line);
+    std::string_view trimmed { strv::trim( *line, " \t\n" ) };
 
     if (trimmed.empty() || trimmed[0] == ';' || trimmed[0] == '#')
       continue ; /* Comment lines */
@@ -104,14 +108,14 @@ void IniParser::parse( const InputStream & input_r, const ProgressData::Receiver
       std::string::size_type pos = trimmed.rfind(']');
       if ( pos != std::string::npos )
       {
-        std::string section = trimmed.substr(1, pos-1);
+        std::string section( trimmed.substr(1, pos-1) );
         consume(section);
         section.swap(_current_section);
       }
       else
       {
         _line_nr = line.lineNo();
-        garbageLine( _current_section, trimmed );
+        garbageLine( _current_section, std::string(trimmed) );
       }
       continue;
     }
@@ -120,17 +124,17 @@ void IniParser::parse( const InputStream & input_r, const ProgressData::Receiver
     if ( pos == std::string::npos || trimmed.find_first_of( keyGarbage() ) < pos )
     {
       _line_nr = line.lineNo();
-      garbageLine( _current_section, trimmed );	// may or may not throw
+      garbageLine( _current_section, std::string(trimmed) );	// may or may not throw
     }
     else
     {
-      std::string key = str::rtrim(trimmed.substr(0, pos));
-      std::string value = str::ltrim(trimmed.substr(pos+1));
+      key = strv::rtrim( trimmed.substr(0, pos), " \t\n" );
+      value = strv::ltrim( trimmed.substr(pos+1), " \t\n" );
       consume( _current_section, key, value);
     }
 
-    // set progress and allow cancel
-    if ( ! ticks.set( input_r.stream().tellg() ) )
+    // set progress and allow cancel (tellg may cost a syscall)
+    if ( progress && ! ticks.set( input_r.stream().tellg() ) )
       ZYPP_THROW(AbortRequestException());
   }
   ticks.toMax();
@@ -102,6 +102,7 @@ zypp_add_sources( zypp_base_HEADERS
 
 zypp_add_sources( zypp_base_SRCS
   base/CleanerThread.cc
+  base/WorkerPool.cc
   base/Exception.cc
   base/ExternalDataSource.cc
   base/filestreambuf.cc
@@ -134,6 +135,32 @@ IF (ENABLE_ZCHUNK_COMPRESSION)
 
 ENDIF(ENABLE_ZCHUNK_COMPRESSION)
 
+IF (ENABLE_ZSTD_COMPRESSION)
+
+  zypp_add_sources( zypp_base_SRCS
+    base/zstdstream.cc
+  )
+
+  zypp_add_sources( zypp_base_HEADERS
+    base/ZstdStream
+    base/zstdstream.h
+  )
+
+ENDIF(ENABLE_ZSTD_COMPRESSION)
+
+IF (ENABLE_XZ_COMPRESSION)
+
+  zypp_add_sources( zypp_base_SRCS
+    base/xzstream.cc
+  )
+
+  zypp_add_sources( zypp_base_HEADERS
+    base/XzStream
+    base/xzstream.h
+  )
+
+ENDIF(ENABLE_XZ_COMPRESSION)
+
 if( ${arg_INSTALL_HEADERS} )
   INSTALL(  FILES ${zypp_base_HEADERS} DESTINATION "${INCLUDE_INSTALL_DIR}/zypp-core/base" )
 endif()
@@ -491,6 +518,10 @@ IF (ENABLE_ZSTD_COMPRESSION)
   TARGET_LINK_LIBRARIES( ${arg_TARGETNAME} INTERFACE ${ZSTD_LIBRARY})
 ENDIF (ENABLE_ZSTD_COMPRESSION)
 
+IF (ENABLE_XZ_COMPRESSION)
+  TARGET_LINK_LIBRARIES( ${arg_TARGETNAME} INTERFACE ${LZMA_LIBRARY})
+ENDIF (ENABLE_XZ_COMPRESSION)
+
 IF (ENABLE_ZCHUNK_COMPRESSION)
   TARGET_LINK_LIBRARIES( ${arg_TARGETNAME} INTERFACE ${ZCHUNK_LDFLAGS})
 ENDIF(ENABLE_ZCHUNK_COMPRESSION)
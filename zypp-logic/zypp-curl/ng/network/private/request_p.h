@@ -112,7 +112,8 @@ namespace zyppng {
 
     struct FileVerifyInfo {
       zypp::Digest _fileDigest;
-      zypp::CheckSum _fileChecksum;
+      zypp::CheckSum _fileChecksum;	///< the expected checksum, empty if just computing
+      zypp::CheckSum _computed;		///< the checksum of the downloaded file
     };
     std::optional<FileVerifyInfo>       _fileVerification; ///< The digest for the full file
 
@@ -514,7 +514,8 @@ namespace zyppng {
             } else {
               constexpr size_t bufSize = 4096;
               char buf[bufSize];
-              while( auto cnt = fread(buf, 1, bufSize, rmode._outFile ) > 0 ) {
+              size_t cnt = 0;
+              while( ( cnt = fread(buf, 1, bufSize, rmode._outFile ) ) > 0 ) {
                 _fileVerification->_fileDigest.update(buf, cnt);
               }
             }
@@ -525,8 +526,10 @@ namespace zyppng {
       // finally check the file digest if we have one
       if ( _fileVerification && resState._result.type() == NetworkRequestError::NoError ) {
         const UByteArray &calcSum = _fileVerification->_fileDigest.digestVector ();
+        _fileVerification->_computed = zypp::CheckSum( _fileVerification->_fileDigest.name(), zypp::Digest::digestVectorToString( calcSum ) );
         const UByteArray &expSum  = zypp::Digest::hexStringToUByteArray( _fileVerification->_fileChecksum.checksum () );
-        if ( calcSum != expSum  ) {
+        if ( !_fileVerification->_fileChecksum.empty() && calcSum != expSum  ) {
+          _fileVerification->_computed = zypp::CheckSum();
              resState._result = NetworkRequestErrorPrivate::customError(
                    NetworkRequestError::InvalidChecksum
                    , (zypp::str::Format("Invalid file checksum %1%, expected checksum %2%")
@@ -549,8 +552,10 @@ namespace zyppng {
     _errorBuf.fill( 0 );
     _runningMode = pending_t();
 
-    if ( _fileVerification )
+    if ( _fileVerification ) {
       _fileVerification->_fileDigest.reset ();
+      _fileVerification->_computed = zypp::CheckSum();
+    }
 
     std::for_each( _requestedRanges.begin (), _requestedRanges.end(), []( CurlMultiPartHandler::Range &range ) {
         range.restart();
@@ -834,6 +839,29 @@ namespace zyppng {
     return true;
   }
 
+  bool NetworkRequest::setFileChecksumType( const std::string &type )
+  {
+    Z_D();
+    if ( state() == Running )
+      return false;
+
+    zypp::Digest fDig;
+    if ( !fDig.create( type ) )
+      return false;
+
+    d->_fileVerification = NetworkRequestPrivate::FileVerifyInfo{
+        ._fileDigest   = std::move(fDig),
+        ._fileChecksum = zypp::CheckSum()
+    };
+    return true;
+  }
+
+  zypp::CheckSum NetworkRequest::fileChecksum() const
+  {
+    const auto &fv = d_func()->_fileVerification;
+    return fv ? fv->_computed : zypp::CheckSum();
+  }
+
   void NetworkRequest::resetRequestRanges()
   {
     Z_D();
@@ -139,6 +139,22 @@ namespace zyppng {
      */
     bool setExpectedFileChecksum( const zypp::CheckSum &expected );
 
+    /*!
+     * Compute a checksum of type \a type for the full file while it is
+     * written. Unlike \ref setExpectedFileChecksum a mismatch is no error,
+     * the caller decides what to do with \ref fileChecksum.
+     * \returns false if the type is not supported.
+     * \note This will not change a running download
+     */
+    bool setFileChecksumType( const std::string &type );
+
+    /*!
+     * The checksum computed for the full file if \ref setExpectedFileChecksum
+     * or \ref setFileChecksumType was used and the download finished without error.
+     * Empty otherwise.
+     */
+    zypp::CheckSum fileChecksum() const;
+
     /*!
      * Clears all requested ranges, the next download will get the complete file
      * \note This will not change a running download
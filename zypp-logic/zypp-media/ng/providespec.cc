@@ -143,8 +143,21 @@ namespace zyppng
     return *this;
   }
 
+  bool ProvideMediaSpec::localTreeRequired() const
+  { return _pimpl->_customHeaders.value( ATTACH_LOCAL_TREE, false ).asBool(); }
+
+  ProvideMediaSpec &ProvideMediaSpec::setLocalTreeRequired( bool val )
+  {
+    _pimpl->_customHeaders.set( std::string(ATTACH_LOCAL_TREE), val );
+    return *this;
+  }
+
   zypp::TriBool ProvideMediaSpec::isSameMedium( const ProvideMediaSpec &other ) const
   {
+    // a medium attached for on demand access can't serve a caller reading the local tree
+    if ( localTreeRequired() != other.localTreeRequired() )
+      return false;
+
     // first check if we have the same media data
     if ( _pimpl->_verifyDataPath != other._pimpl->_verifyDataPath )
       return false;
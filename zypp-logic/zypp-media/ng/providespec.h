@@ -12,6 +12,7 @@
 #define ZYPP_MEDIA_PROVIDESPEC_H_INCLUDED
 
 #include <iosfwd>
+#include <string_view>
 
 #include <zypp-core/Url.h>
 #include <zypp-core/ByteCount.h>
@@ -26,6 +27,11 @@
 namespace zyppng
 {
 
+  /*!
+   * Custom header set on attach requests by \ref ProvideMediaSpec::setLocalTreeRequired.
+   */
+  constexpr std::string_view ATTACH_LOCAL_TREE("zypp-attach-local-tree");
+
   class ProvideMediaSpec
   {
   public:
@@ -80,6 +86,19 @@ namespace zyppng
      */
     ProvideMediaSpec &addCustomHeaderValue (  const std::string &key, const HeaderValueMap::Value &val );
 
+    /*!
+     * Whether the attached medium must be readable as a whole through its local
+     * mount point, because the caller reads it directly (e.g. plaindir repos).
+     * Otherwise a worker may make files available on demand only, when they are provided.
+     */
+    bool localTreeRequired() const;
+
+    /*!
+     * Request a medium that is readable as a whole through its local mount point.
+     * \see \ref localTreeRequired
+     */
+    ProvideMediaSpec &setLocalTreeRequired( bool val = true );
+
     zypp::TriBool isSameMedium ( const ProvideMediaSpec &other ) const;
 
     static bool isSameMedium ( const zypp::MirroredOrigin &originA, const ProvideMediaSpec &specA, const zypp::MirroredOrigin &originB, const ProvideMediaSpec &specB );
@@ -13,12 +13,14 @@
 #include <fstream>
 #include <list>
 #include <map>
+#include <vector>
 
 #include <zypp-core/base/Easy.h>
 #include <zypp-core/base/LogControl.h>
 #include <zypp-core/base/LogTools.h>
 #include <zypp-core/base/PtrTypes.h>
 #include <zypp-core/base/DefaultIntegral>
+#include <zypp-core/base/Env.h>
 #include <zypp-core/base/String.h>
 #include <zypp-media/MediaException>
 #include <zypp/Fetcher.h>
@@ -35,6 +37,19 @@
 namespace zypp
 { /////////////////////////////////////////////////////////////////
 
+  namespace
+  {
+    /** Whether files are downloaded in parallel before they are provided (\c ZYPP_FETCHER_PRECACHE=0 to disable). */
+    inline bool precacheEnabled()
+    {
+      static const bool _val = [](){
+        TriBool envstate = env::getenvBool( "ZYPP_FETCHER_PRECACHE" );
+        return indeterminate(envstate) || bool(envstate);
+      }();
+      return _val;
+    }
+  } // namespace
+
   /**
    * class that represents indexes which add metadata
    * to fetcher jobs and therefore need to be retrieved
@@ -225,10 +240,20 @@ namespace zypp
                            MediaSetAccess &media,
                            const OnMediaLocation &resource,
                            const Pathname &dest_dir );
+      /**
+       * Let the media backend start downloading the files of \a jobs_r
+       * not found in a cache in parallel (if it supports it), so
+       * \ref provideToDest does not need to wait for them one by one.
+       * The files found in a cache are remembered in \a cached_r.
+       */
+      void precacheJobs( MediaSetAccess & media_r, const Pathname & destDir_r, const std::vector<FetcherJob_Ptr> & jobs_r,
+                         std::map<FetcherJob_Ptr,ManagedFile> & cached_r );
       /**
        * Provide the resource to \ref dest_dir
+       * If \a cached_r is empty, the file is looked up in the caches.
        */
-      void provideToDest( MediaSetAccess & media_r, const Pathname & destDir_r , const FetcherJob_Ptr & jobp_r );
+      void provideToDest( MediaSetAccess & media_r, const Pathname & destDir_r , const FetcherJob_Ptr & jobp_r,
+                          ManagedFile cached_r = ManagedFile() );
 
   private:
     friend Impl * rwcowClone<Impl>( const Impl * rhs );
@@ -252,9 +277,6 @@ namespace zypp
 
   void Fetcher::Impl::enqueueDigested( const OnMediaLocation &resource, const FileChecker & )
   {
-    if ( _mediaSetAccess )
-      _mediaSetAccess->precacheFiles( {resource} );
-
     FetcherJob_Ptr job;
     job.reset(new FetcherJob(resource));
     job->flags |= FetcherJob:: AlwaysVerifyChecksum;
@@ -306,9 +328,6 @@ namespace zypp
 
   void Fetcher::Impl::enqueue( const OnMediaLocation &resource, const FileChecker &checker )
   {
-    if ( _mediaSetAccess )
-      _mediaSetAccess->precacheFiles( {resource} );
-
     FetcherJob_Ptr job;
     job.reset(new FetcherJob(resource));
     if ( checker )
@@ -530,7 +549,49 @@ namespace zypp
       }
   }
 
-  void Fetcher::Impl::provideToDest( MediaSetAccess & media_r, const Pathname & destDir_r , const FetcherJob_Ptr & jobp_r )
+  void Fetcher::Impl::precacheJobs( MediaSetAccess & media_r, const Pathname & destDir_r, const std::vector<FetcherJob_Ptr> & jobs_r,
+                                    std::map<FetcherJob_Ptr,ManagedFile> & cached_r )
+  {
+    if ( jobs_r.size() < 2 || ! precacheEnabled() )
+      return;
+
+    std::vector<OnMediaLocation> files;
+    for ( const FetcherJob_Ptr & jobp : jobs_r )
+    {
+      OnMediaLocation resource( jobp->location );
+      if ( resource.checksum().empty() )
+      {
+        // let the media backend verify the checksum from the index as well
+        auto it = _checksums.find( resource.filename().asString() );
+        if ( it != _checksums.end() )
+          resource.setChecksum( it->second );
+      }
+
+      ManagedFile cached { locateInCache( resource, destDir_r ) };
+      if ( ! cached->empty() )
+      {
+        cached_r[jobp] = std::move(cached);	// so provideToDest needs not compute the checksum again
+        continue;
+      }
+      files.push_back( std::move(resource) );
+    }
+    if ( files.size() < 2 )
+      return;
+
+    // Just a shortcut; whatever fails here is retried and reported by provideToDest.
+    try
+    {
+      media_r.prefetch( files );
+    }
+    catch ( const Exception & excpt )
+    {
+      ZYPP_CAUGHT( excpt );
+      WAR << "Prefetching " << files.size() << " files failed. Providing them one by one." << endl;
+    }
+  }
+
+  void Fetcher::Impl::provideToDest( MediaSetAccess & media_r, const Pathname & destDir_r , const FetcherJob_Ptr & jobp_r,
+                                     ManagedFile cached_r )
   {
     const OnMediaLocation & resource( jobp_r->location );
 
@@ -539,7 +600,7 @@ namespace zypp
       scoped_ptr<MediaSetAccess::ReleaseFileGuard> releaseFileGuard; // will take care provided files get released
 
       // get cached file (by checksum) or provide from media
-      ManagedFile managedTmpFile = locateInCache( resource, destDir_r );
+      ManagedFile managedTmpFile = cached_r->empty() ? locateInCache( resource, destDir_r ) : std::move(cached_r);
 
       Pathname tmpFile = managedTmpFile;
       if ( tmpFile.empty() )
@@ -761,6 +822,9 @@ namespace zypp
 
     downloadAndReadIndexList(media, dest_dir);
 
+    // Expand the directories and collect the checkers first, so all
+    // files can be prefetched in parallel while they are provided.
+    std::vector<FetcherJob_Ptr> fileJobs;
     for ( const FetcherJob_Ptr & jobp : _resources )
     {
       if ( jobp->flags & FetcherJob::Directory )
@@ -830,10 +894,23 @@ namespace zypp
           ChecksumFileChecker digest_check(jobp->location.checksum());
           jobp->checkers.push_back(digest_check);
       }
+      fileJobs.push_back( jobp );
+    }
+
+    std::map<FetcherJob_Ptr,ManagedFile> cached;
+    precacheJobs( media, dest_dir, fileJobs, cached );
 
+    for ( const FetcherJob_Ptr & jobp : fileJobs )
+    {
       // Provide and validate the file. If the file was not transferred
       // and no exception was thrown, it was an optional file.
-      provideToDest( media, dest_dir, jobp );
+      ManagedFile cachedFile;
+      if ( auto it = cached.find( jobp ); it != cached.end() )
+      {
+        cachedFile = std::move(it->second);
+        cached.erase( it );
+      }
+      provideToDest( media, dest_dir, jobp, std::move(cachedFile) );
 
       if ( ! progress.incr() )
         ZYPP_THROW(AbortRequestException());
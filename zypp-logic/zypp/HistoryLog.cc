@@ -27,6 +27,7 @@
 
 #include <zypp/HistoryLog.h>
 #include <zypp/HistoryLogData.h>
+#include <zypp/parser/private/historylogindex_p.h>
 
 using std::endl;
 using std::string;
@@ -126,6 +127,9 @@ namespace zypp
     {
       _log.clear();
       _log.close();
+      // index the lines we appended
+      if ( _fname != "/dev/null" )
+        parser::HistoryLogIndex::update( _fname );
     }
 
     inline void refUp()
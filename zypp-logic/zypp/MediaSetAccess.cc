@@ -9,6 +9,7 @@
 
 #include <iostream>
 #include <fstream>
+#include <map>
 
 #include <zypp-core/base/LogTools.h>
 #include <zypp-core/base/Regex.h>
@@ -278,22 +279,29 @@ public:
   }
 
   void MediaSetAccess::precacheFiles(const std::vector<OnMediaLocation> &files)
+  { prefetch( files ); }
+
+  void MediaSetAccess::prefetch( const std::vector<OnMediaLocation> & files )
   {
     media::MediaManager media_mgr;
 
+    std::map<unsigned, std::vector<OnMediaLocation>> filesPerMedia;
     for ( const auto &resource : files ) {
-           unsigned media_nr(resource.medianr());
+      filesPerMedia[resource.medianr()].push_back( resource );
+    }
+
+    for ( const auto & [media_nr, resources] : filesPerMedia ) {
       media::MediaAccessId media = getMediaAccessId( media_nr );
 
       if ( !media_mgr.isOpen( media ) ) {
-        MIL << "Skipping precache of file " << resource.filename() << " media is not open";
+        MIL << "Skipping prefetch of " << resources.size() << " files, media " << media_nr << " is not open" << endl;
         continue;
       }
 
       if ( ! media_mgr.isAttached(media) )
         media_mgr.attach(media);
 
-      media_mgr.precacheFiles( media, { resource } );
+      media_mgr.precacheFiles( media, resources );
     }
   }
 
@@ -139,15 +139,30 @@ namespace zypp
       ZYPP_DECLARE_FLAGS(ProvideFileOptions,ProvideFileOption);
 
       /**
-         * Tries to fetch the given files and precaches them. Those files
-         * need to be queried using provideFile and can be read from the cache directly.
-         * The implementation is not allowed to block but needs to use seperate means to
-         * download the files concurrently.
-         * A backend can choose to completely ignore this functionaly, the default implementation
-         * does nothing.
-         *
-         * \param files List of files that should be precached
-         */
+       * Hand a batch of files to the media backend in advance.
+       *
+       * Files on the same media are passed to the backend in one go. A
+       * network backend starts downloading them in parallel in the
+       * background and returns immediately. A later \ref provideFile
+       * for one of these files just waits for its download (if it is
+       * still running) and returns the file from the attach point. So
+       * code providing files one by one gets pipelined downloads without
+       * being rewritten:
+       * \code
+       *   media.prefetch( files );
+       *   for ( const auto & file : files )
+       *     process( media.provideFile( file ) );
+       * \endcode
+       *
+       * Prefetching is just a hint. Backends not supporting it ignore it.
+       * A file failing to prefetch is downloaded again by \ref provideFile,
+       * which reports errors, asks for credentials, etc. as usual.
+       *
+       * \param files List of files that will be provided soon
+       */
+      void prefetch( const std::vector<OnMediaLocation> & files );
+
+      /** Same as \ref prefetch. */
       void precacheFiles(const std::vector<OnMediaLocation> &files);
 
       /**
@@ -171,6 +171,13 @@ namespace zypp
   void RepoManager::loadFromCache( const RepoInfo &info, const ProgressData::ReceiverFnc & progressrcv )
   { return _pimpl->ngMgr().loadFromCache( info, nullptr ).unwrap(); }
 
+  void RepoManager::loadFromCache( const std::vector<RepoInfo> & infos, const ProgressData::ReceiverFnc & progressrcv )
+  {
+    callback::SendReport<ProgressReport> report;
+    auto adapt = zyppng::ProgressObserverAdaptor( progressrcv, report );
+    return _pimpl->ngMgr().loadFromCache( infos, adapt.observer() ).unwrap();
+  }
+
   void RepoManager::cleanCacheDirGarbage( const ProgressData::ReceiverFnc & progressrcv )
   { return _pimpl->ngMgr().cleanCacheDirGarbage( nullptr ).unwrap(); }
 
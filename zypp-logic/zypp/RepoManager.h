@@ -14,6 +14,7 @@
 
 #include <iosfwd>
 #include <list>
+#include <vector>
 
 #include <zypp-core/base/PtrTypes.h>
 #include <zypp-core/base/Iterator.h>
@@ -342,6 +343,19 @@ namespace zypp
    void loadFromCache( const RepoInfo &info,
                        const ProgressData::ReceiverFnc & progressrcv = ProgressData::ReceiverFnc() );
 
+   /**
+    * \short Load multiple repos into the pool
+    *
+    * Same as calling \ref loadFromCache for each repo in the given
+    * order, but the solv files are read ahead concurrently.
+    * Stops at the first repo which fails to load.
+    *
+    * \throws repo::RepoNoAliasException if can't figure an alias to look in cache
+    * \throw RepoNotCachedException When a source is not cached.
+    */
+   void loadFromCache( const std::vector<RepoInfo> & infos,
+                       const ProgressData::ReceiverFnc & progressrcv = ProgressData::ReceiverFnc() );
+
    /**
     * Remove any subdirectories of cache directories which no longer belong
     * to any of known repositories.
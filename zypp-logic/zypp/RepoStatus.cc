@@ -12,8 +12,10 @@
 #include <iostream>
 #include <sstream>
 #include <fstream>
+#include <map>
 #include <optional>
 #include <set>
+#include <sys/stat.h>
 #include <zypp-core/base/Logger.h>
 #include <zypp-core/base/String.h>
 #include <zypp/RepoStatus.h>
@@ -28,16 +30,21 @@ namespace zypp
   ///////////////////////////////////////////////////////////////////
   namespace
   {
-    /** Recursive computation of max dir timestamp. */
+    /** Recursive computation of max dir timestamp.
+     * Only directories are stat'ed, so plaindir repos with many files
+     * (maybe on NFS) are scanned fast.
+     */
     void recursiveTimestamp( const Pathname & dir_r, time_t & max_r )
     {
-      std::list<std::string> dircontent;
-      if ( filesystem::readdir( dircontent, dir_r, false/*no dots*/ ) != 0 )
+      filesystem::DirContent dircontent;
+      if ( filesystem::readdir( dircontent, dir_r, false/*no dots*/, PathInfo::LSTAT ) != 0 )
         return; // readdir logged the error
 
       for_( it, dircontent.begin(), dircontent.end() )
       {
-        PathInfo pi( dir_r + *it, PathInfo::LSTAT );
+        if ( it->type != filesystem::FT_DIR )
+          continue;
+        PathInfo pi( dir_r + it->name, PathInfo::LSTAT );
         if ( pi.isDir() )
         {
           if ( pi.mtime() > max_r )
@@ -46,6 +53,42 @@ namespace zypp
         }
       }
     }
+
+    ///////////////////////////////////////////////////////////////////
+    /// \class Fingerprint
+    /// \brief Identifies a file's content without reading it.
+    ///
+    /// If inode, size, mtime and ctime (nanoseconds) are unchanged, the
+    /// file's checksum remembered in a cookie file can be reused.
+    ///////////////////////////////////////////////////////////////////
+    struct Fingerprint
+    {
+      Fingerprint()
+      {}
+
+      Fingerprint( const struct ::stat & st_r )
+      : _ino( st_r.st_ino )
+      , _size( st_r.st_size )
+      , _mtime( st_r.st_mtim.tv_sec * 1000000000LL + st_r.st_mtim.tv_nsec )
+      , _ctime( st_r.st_ctim.tv_sec * 1000000000LL + st_r.st_ctim.tv_nsec )
+      {}
+
+      bool sameFile( const Fingerprint & rhs ) const
+      { return _ino == rhs._ino && _size == rhs._size && _mtime == rhs._mtime && _ctime == rhs._ctime; }
+
+      unsigned long long _ino = 0;
+      long long _size = -1;
+      long long _mtime = 0;	// < ns
+      long long _ctime = 0;	// < ns
+      std::string _checksum;	// < SHA256 of the file content (no magic)
+    };
+
+    /** Cookie file lines following the status line (ignored by older versions):
+     * \code
+     * #fingerprint <checksum> <ino> <size> <mtime_ns> <ctime_ns> <path>
+     * \endcode
+     */
+    const std::string fingerprintTag { "#fingerprint" };
   } // namespace
   ///////////////////////////////////////////////////////////////////
 
@@ -101,6 +144,8 @@ namespace zypp
 
       if ( rhs._timestamp > _timestamp )
         _timestamp = rhs._timestamp;
+
+      _fingerprints.insert( rhs._fingerprints.begin(), rhs._fingerprints.end() );
     }
 
     bool empty() const
@@ -134,6 +179,28 @@ namespace zypp
     { return str << ( empty() ? "NO_REPOSTATUS" : checksum() ) << " " << time_t(_timestamp); }
 
   public:
+    /** Checksum of file \a path_r; reused from \a hint_r if the fingerprint is unchanged. */
+    std::string fileChecksum( const Pathname & path_r, const Impl & hint_r )
+    {
+      struct ::stat st;
+      if ( ::stat( path_r.c_str(), &st ) != 0 )
+        return filesystem::checksum( path_r, "SHA256" );
+
+      Fingerprint fp( st );
+      auto it { hint_r._fingerprints.find( path_r.asString() ) };
+      if ( it != hint_r._fingerprints.end() && it->second.sameFile( fp ) )
+      {
+        DBG << "Unchanged fingerprint " << path_r << endl;
+        fp._checksum = it->second._checksum;
+      }
+      else
+        fp._checksum = filesystem::checksum( path_r, "SHA256" );
+
+      if ( ! fp._checksum.empty() )
+        _fingerprints[path_r.asString()] = fp;
+      return fp._checksum;
+    }
+
     void assignFromCookieFile( const Pathname & path_r, bool useMtime_r = false )
     {
       std::ifstream file( path_r.c_str() );
@@ -147,11 +214,31 @@ namespace zypp
 
       Date stmp { useMtime_r ? PathInfo( path_r ).mtime() : str::strtonum<time_t>( time ) };
       inject( std::move(line), std::move(stmp) );	// raw inject to avoid magic being added
+
+      for ( line = str::getline( file ); file; line = str::getline( file ) )
+      {
+        std::istringstream fields( line );
+        std::string tag;
+        Fingerprint fp;
+        fields >> tag >> fp._checksum >> fp._ino >> fp._size >> fp._mtime >> fp._ctime;
+        std::string path { str::trim( str::getline( fields ) ) };
+        if ( ! fields.fail() && tag == fingerprintTag && ! path.empty() )
+          _fingerprints[path] = fp;
+      }
+    }
+
+    void saveToCookieFile( std::ostream & str ) const
+    {
+      str << checksum() << " " << time_t(_timestamp) << endl;
+      for ( const auto & [path,fp] : _fingerprints )
+        str << fingerprintTag << " " << fp._checksum << " " << fp._ino << " " << fp._size
+            << " " << fp._mtime << " " << fp._ctime << " " << path << endl;
     }
 
   private:
     Checksums _checksums;
     Date _timestamp;
+    std::map<std::string,Fingerprint> _fingerprints;	// < files checksummed by the ctor
 
     mutable std::optional<std::string> _cachedchecksum;
 
@@ -174,6 +261,10 @@ namespace zypp
   {}
 
   RepoStatus::RepoStatus( const Pathname & path_r )
+    : RepoStatus( path_r, RepoStatus() )
+  {}
+
+  RepoStatus::RepoStatus( const Pathname & path_r, const RepoStatus & hint_r )
     : _pimpl( new Impl() )
   {
     PathInfo info( path_r );
@@ -181,7 +272,7 @@ namespace zypp
     {
       if ( info.isFile() )
       {
-        _pimpl->assignFromCtor( filesystem::checksum( path_r, "SHA256" ), Date( info.mtime() ) );
+        _pimpl->assignFromCtor( _pimpl->fileChecksum( path_r, *hint_r._pimpl ), Date( info.mtime() ) );
       }
       else if ( info.isDir() )
       {
@@ -227,7 +318,7 @@ namespace zypp
     if (!file) {
       ZYPP_THROW (Exception( "Can't open " + path_r.asString() ) );
     }
-    file << _pimpl->checksum() << " " << time_t(_pimpl->timestamp()) << endl;
+    _pimpl->saveToCookieFile( file );
     file.close();
   }
 
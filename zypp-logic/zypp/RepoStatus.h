@@ -56,6 +56,15 @@ namespace zypp
      */
     explicit RepoStatus( const Pathname & path_r );
 
+    /** Compute status for single file or directory like above.
+     *
+     * A file is not checksummed again, if \a hint_r (usually read
+     * from a cookie file) remembers the same inode, size, mtime and
+     * ctime for it. The fingerprints are stored in the cookie file
+     * by \ref saveToCookieFile.
+     */
+    RepoStatus( const Pathname & path_r, const RepoStatus & hint_r );
+
     /** Compute status of a \a RepoInfo to track changes requiring a refresh. */
     explicit RepoStatus( const RepoInfo & info_r );
 
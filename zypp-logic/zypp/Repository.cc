@@ -20,6 +20,7 @@
 
 #include <zypp-core/AutoDispose.h>
 #include <zypp-core/Pathname.h>
+#include <zypp-core/fs/PathInfo.h>
 
 #include <zypp/sat/detail/PoolImpl.h>
 #include <zypp/Repository.h>
@@ -322,6 +323,12 @@ namespace zypp
     {
       NO_REPOSITORY_THROW( Exception( "Can't add solvables to norepo." ) );
 
+      // A writer replaces the ext file before the solv-file. Opening them in
+      // the same order and checking the ext file is still in place afterwards
+      // ensures they belong together.
+      const Pathname & extpath { file_r.extend( ".ext" ) };
+      AutoFILE extfile { ::fopen( extpath.c_str(), "re" ) };
+
       AutoDispose<FILE*> file( ::fopen( file_r.c_str(), "re" ), ::fclose );
       if ( file == NULL )
       {
@@ -329,7 +336,18 @@ namespace zypp
         ZYPP_THROW( Exception( "Can't open solv-file: "+file_r.asString() ) );
       }
 
-      if ( myPool()._addSolv( _repo, file ) != 0 )
+      if ( extfile != nullptr )
+      {
+        struct ::stat st;
+        PathInfo pi( extpath );
+        if ( ::fstat( ::fileno( extfile ), &st ) != 0 || pi.ino() != st.st_ino || pi.dev() != st.st_dev )
+        {
+          WAR << extpath << " was replaced while loading " << file_r << "; not using it" << endl;
+          extfile = AutoFILE();
+        }
+      }
+
+      if ( myPool()._addSolv( _repo, file, extpath, std::move(extfile) ) != 0 )
       {
         ZYPP_THROW( Exception( "Error reading solv-file: "+file_r.asString() ) );
       }
@@ -337,6 +355,37 @@ namespace zypp
       MIL << *this << " after adding " << file_r << endl;
     }
 
+    void Repository::writeSolv( const Pathname & file_r, const Pathname & extfile_r ) const
+    {
+      NO_REPOSITORY_THROW( Exception( "Can't write norepo." ) );
+
+      AutoDispose<FILE*> file( ::fopen( file_r.c_str(), "we" ), ::fclose );
+      if ( file == NULL )
+      {
+        file.resetDispose();
+        ZYPP_THROW( Exception( "Can't open solv-file for writing: "+file_r.asString() ) );
+      }
+
+      AutoDispose<FILE*> extfile;
+      if ( ! extfile_r.empty() )
+      {
+        extfile = AutoDispose<FILE*>( ::fopen( extfile_r.c_str(), "we" ), ::fclose );
+        if ( extfile == NULL )
+        {
+          extfile.resetDispose();
+          ZYPP_THROW( Exception( "Can't open solv-file for writing: "+extfile_r.asString() ) );
+        }
+      }
+
+      if ( myPool().writeSolv( _repo, file, extfile ) != 0
+           || ::fflush( file ) != 0 || ( extfile && ::fflush( extfile ) != 0 ) )
+      {
+        ZYPP_THROW( Exception( "Error writing solv-file: "+file_r.asString() ) );
+      }
+
+      MIL << *this << " written to " << file_r << endl;
+    }
+
     void Repository::addHelix( const Pathname & file_r )
     {
       NO_REPOSITORY_THROW( Exception( "Can't add solvables to norepo." ) );
@@ -289,6 +289,16 @@ namespace zypp
          */
         void addSolv( const Pathname & file_r );
 
+        /** Write the \ref Repository content to a solv-file.
+         * If \a extfile_r is not empty, rarely used attributes like descriptions,
+         * changelogs or update references are written to \a extfile_r. They are
+         * loaded on demand, if the solv-file is later loaded by \ref addSolv
+         * from the same directory as \c file_r.ext.
+         * \throws Exception if this is \ref noRepository
+         * \throws Exception if writing the solv-file fails.
+         */
+        void writeSolv( const Pathname & file_r, const Pathname & extfile_r = Pathname() ) const;
+
          /** Load \ref Solvables from a helix-file.
          * Supports loading of gzip compressed files (.gz). In case of an exception
          * the repository remains in the \ref Pool.
@@ -82,9 +82,15 @@ namespace zypp
   bool Target::providesFile (const std::string & name_str, const std::string & path_str) const
   { return _pimpl->providesFile (name_str, path_str); }
 
+  std::vector<bool> Target::providesFile( const std::string & name_str, const std::vector<std::string> & paths_r ) const
+  { return _pimpl->providesFile( paths_r, name_str ); }
+
   std::string Target::whoOwnsFile (const std::string & path_str) const
   { return _pimpl->whoOwnsFile (path_str); }
 
+  std::vector<std::string> Target::whoOwnsFile( const std::vector<std::string> & paths_r ) const
+  { return _pimpl->whoOwnsFile( paths_r ); }
+
   std::ostream & Target::dumpOn( std::ostream & str ) const
   { return _pimpl->dumpOn( str ); }
 
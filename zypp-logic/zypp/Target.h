@@ -13,6 +13,7 @@
 #define ZYPP_TARGET_H
 
 #include <iosfwd>
+#include <vector>
 
 #include <zypp/base/ReferenceCounted.h>
 #include <zypp-core/base/NonCopyable.h>
@@ -86,11 +87,21 @@ namespace zypp
      Needed to evaluate split provides during Resolver::Upgrade() */
     bool providesFile (const std::string & name_str, const std::string & path_str) const;
 
+    /** Batch version of \ref providesFile looking up all paths in
+     * one rpm database access. Results are in the order of \a paths_r.
+     **/
+    std::vector<bool> providesFile( const std::string & name_str, const std::vector<std::string> & paths_r ) const;
+
     /** Return name of package owning \a path_str
      * or empty string if no installed package owns \a path_str.
      **/
     std::string whoOwnsFile (const std::string & path_str) const;
 
+    /** Batch version of \ref whoOwnsFile looking up all paths in
+     * one rpm database access. Results are in the order of \a paths_r.
+     **/
+    std::vector<std::string> whoOwnsFile( const std::vector<std::string> & paths_r ) const;
+
     /** Return the root set for this target */
     Pathname root() const;
 
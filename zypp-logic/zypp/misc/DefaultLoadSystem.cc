@@ -64,6 +64,7 @@ namespace zypp
       {
         RepoManager repoManager( sysRoot_r );
         RepoInfoList repos = repoManager.knownRepositories();
+        std::vector<RepoInfo> toload;
         for_( it, repos.begin(), repos.end() )
         {
           RepoInfo & nrepo( *it );
@@ -90,17 +91,20 @@ namespace zypp
             repoManager.buildCache( nrepo );
           }
 
-          MIL << str::form( "*** load repo '%s'\t", nrepo.name().c_str() ) << std::flush;
-          try
-          {
-            repoManager.loadFromCache( nrepo );
+          toload.push_back( nrepo );
+        }
+
+        MIL << str::form( "*** load %zu repos", toload.size() ) << endl;
+        try
+        {
+          repoManager.loadFromCache( toload );
+          for ( const RepoInfo & nrepo : toload )
             MIL << satpool.reposFind( nrepo.alias() ) << endl;
-          }
-          catch ( const Exception & exp )
-          {
-            ERR << "*** load repo failed: " << exp.asString() + "\n" + exp.historyAsString() << endl;
-            ZYPP_RETHROW ( exp );
-          }
+        }
+        catch ( const Exception & exp )
+        {
+          ERR << "*** load repo failed: " << exp.asString() + "\n" + exp.historyAsString() << endl;
+          ZYPP_RETHROW ( exp );
         }
       }
       MIL << str::form( "*** Read system at '%s'", sysRoot_r.c_str() ) << endl;
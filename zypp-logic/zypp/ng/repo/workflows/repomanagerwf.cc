@@ -11,6 +11,7 @@
 #include "zypp/parser/xml/Reader.h"
 
 #include <zypp-core/ManagedFile.h>
+#include <zypp-core/fs/TmpPath.h>
 #include <zypp-core/MirroredOrigin.h>
 #include <zypp-core/ng/io/Process>
 #include <zypp-core/ng/pipelines/MTry>
@@ -27,6 +28,7 @@
 #include <zypp/ng/repo/workflows/repodownloaderwf.h>
 #include <zypp/ng/repomanager.h>
 #include <zypp/ZConfig.h>
+#include <zypp/repo/private/plaindirsolv_p.h>
 
 #include <utility>
 #include <fstream>
@@ -479,7 +481,9 @@ namespace zyppng::RepoManagerWorkflow {
 
       // the actual logic pipeline, attaches the medium and tries to refresh from it
       auto refreshPipeline = [ refCtx, progressObserver ]( zypp::MirroredOrigin origin ){
-        return refCtx->zyppContext()->provider()->prepareMedia( origin, zyppng::ProvideMediaSpec() )
+        // the plaindir status is computed from the local tree
+        const bool localTree = ( refCtx->repoInfo().type() == zypp::repo::RepoType::RPMPLAINDIR );
+        return refCtx->zyppContext()->provider()->prepareMedia( origin, zyppng::ProvideMediaSpec().setLocalTreeRequired( localTree ) )
             | and_then( [ refCtx , progressObserver]( auto mediaHandle ) mutable { return refreshMetadata ( std::move(refCtx), std::move(mediaHandle), progressObserver ); } );
       };
 
@@ -694,8 +698,26 @@ namespace zyppng::RepoManagerWorkflow {
 
           ProgressObserver::start( _progressObserver );
 
+          // cleanCache removes the whole solv dir. A plaindir repos solv file
+          // and index are moved aside, so buildPlaindirSolv reads just the
+          // new and changed rpms.
+          std::optional<zypp::filesystem::TmpDir> oldPlaindirSolv;
           if (needs_cleaning)
           {
+            expected<zypp::Pathname> oldbase = solv_path_for_repoinfo( _refCtx->repoManagerOptions(), info );
+            if ( oldbase && zypp::PathInfo( zypp::repo::plaindirSolvIndex( *oldbase / "solv" ) ).isFile() )
+            {
+              oldPlaindirSolv = zypp::filesystem::TmpDir::makeSibling( *oldbase );
+              if ( oldPlaindirSolv->path().empty()
+                   || zypp::filesystem::rename( *oldbase / "solv", oldPlaindirSolv->path() / "solv" ) != 0
+                   || zypp::filesystem::rename( zypp::repo::plaindirSolvIndex( *oldbase / "solv" ),
+                                                zypp::repo::plaindirSolvIndex( oldPlaindirSolv->path() / "solv" ) ) != 0 )
+              {
+                WAR << "Can't keep the plaindir solv file of " << info.alias() << ", all rpms will be read" << std::endl;
+                oldPlaindirSolv.reset();
+              }
+            }
+
             auto r = _refCtx->repoManager()->cleanCache(info);
             if ( !r )
               return makeReadyResult( expected<void>::error(r.error()) );
@@ -738,7 +760,7 @@ namespace zyppng::RepoManagerWorkflow {
           MIL << "repo type is " << repokind << std::endl;
 
           return mountIfRequired( repokind, info )
-          | and_then([this, repokind, solvfile = std::move(solvfile) ]( std::optional<MediaHandle> forPlainDirs ) mutable {
+          | and_then([this, repokind, solvfile = std::move(solvfile), oldPlaindirSolv = std::move(oldPlaindirSolv) ]( std::optional<MediaHandle> forPlainDirs ) mutable {
 
             const auto &info = _refCtx->repoInfo();
 
@@ -765,15 +787,27 @@ namespace zyppng::RepoManagerWorkflow {
 
                 if ( repokind == zypp::repo::RepoType::RPMPLAINDIR )
                 {
-                  // recusive for plaindir as 2nd arg!
-                  cmd.push_back( "-R" );
-
                   std::optional<zypp::Pathname> localPath = forPlainDirs.has_value() ? forPlainDirs->localPath() : zypp::Pathname();
                   if ( !localPath )
                     return makeReadyResult( expected<void>::error( ZYPP_EXCPT_PTR( zypp::repo::RepoException( zypp::str::Format(_("Failed to cache repo %1%")) % _refCtx->repoInfo() ))) );
 
                   // FIXME this does only work for dir: URLs
-                  cmd.push_back( (*localPath / info.path().absolutename()).c_str() );
+                  const zypp::Pathname plaindir { *localPath / info.path().absolutename() };
+
+                  // Index in process, re-reading only new or changed rpms. repo2solv is the fallback.
+                  try {
+                    zypp::repo::buildPlaindirSolv( plaindir, solvfile, oldPlaindirSolv ? oldPlaindirSolv->path() / "solv" : zypp::Pathname() );
+                    guard.resetDispose();
+                    return makeReadyResult( mtry( zypp::sat::updateSolvFileIndex, solvfile ) );
+                  }
+                  catch ( const zypp::Exception & excpt ) {
+                    ZYPP_CAUGHT( excpt );
+                    WAR << "Indexing " << plaindir << " failed, using repo2solv: " << excpt.asUserString() << std::endl;
+                  }
+
+                  // recusive for plaindir as 2nd arg!
+                  cmd.push_back( "-R" );
+                  cmd.push_back( plaindir.c_str() );
                 }
                 else
                   cmd.push_back( _productdatapath.asString() );
@@ -813,7 +847,8 @@ namespace zyppng::RepoManagerWorkflow {
         if ( repokind != zypp::repo::RepoType::RPMPLAINDIR )
           return makeReadyResult( make_expected_success( std::optional<MediaHandle>() ));
 
-        return _refCtx->zyppContext()->provider()->attachMedia( info.url(), ProvideMediaSpec() )
+        // buildPlaindirSolv reads the rpms via the local path
+        return _refCtx->zyppContext()->provider()->attachMedia( info.url(), ProvideMediaSpec().setLocalTreeRequired() )
         | and_then( []( MediaHandle handle ) {
           return makeReadyResult( make_expected_success( std::optional<MediaHandle>( std::move(handle)) ));
         });
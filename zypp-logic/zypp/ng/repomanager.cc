@@ -14,7 +14,9 @@
 
 #include <zypp-core/AutoDispose.h>
 #include <zypp-core/base/Regex.h>
+#include <zypp-core/base/WorkerPool_p.h>
 #include <zypp-core/fs/PathInfo.h>
+#include <zypp-core/fs/TmpPath.h>
 #include <zypp-core/ng/pipelines/MTry>
 #include <zypp-core/ng/pipelines/Transform>
 #include <zypp-core/ng/ui/ProgressObserver>
@@ -35,9 +37,14 @@
 #include <zypp/ng/repo/workflows/repomanagerwf.h>
 #include <zypp/ng/repo/workflows/serviceswf.h>
 
+#include <atomic>
 #include <fstream>
+#include <optional>
 #include <utility>
 
+#include <fcntl.h>
+#include <unistd.h>
+
 #undef ZYPP_BASE_LOGGER_LOGGROUP
 #define ZYPP_BASE_LOGGER_LOGGROUP "zypp::repomanager"
 
@@ -56,6 +63,20 @@ namespace zyppng
       const char * env = getenv("ZYPP_PLUGIN_APPDATA_FORCE_COLLECT");
       return( env && zypp::str::strToBool( env, true ) );
     }
+
+    /** To keep an arch filtered snapshot of each repos solv file */
+    inline bool ZYPP_POOL_SNAPSHOT()
+    {
+      const char * env = getenv("ZYPP_POOL_SNAPSHOT");
+      return( env && zypp::str::strToBool( env, true ) );
+    }
+
+    /** To load descriptions, changelogs, etc. from the solv snapshot on demand */
+    inline bool ZYPP_SOLV_LAZY_ATTRS()
+    {
+      const char * env = getenv("ZYPP_SOLV_LAZY_ATTRS");
+      return( env && zypp::str::strToBool( env, true ) );
+    }
   } // namespace env
 
   namespace {
@@ -95,6 +116,139 @@ namespace zyppng
         }
       }
     }
+
+    ///////////////////////////////////////////////////////////////////
+    /// \class SolvSnapshot
+    /// \brief Arch filtered copy of a repos solv file (\c $ZYPP_POOL_SNAPSHOT).
+    ///
+    /// Adding a repo to the pool drops all solvables not matching the
+    /// system architecture. The snapshot is written after the solv file
+    /// was loaded and filtered. Loading it later saves parsing the dropped
+    /// solvables again.
+    ///
+    /// In \a lazy_r mode (\c $ZYPP_SOLV_LAZY_ATTRS) descriptions, changelogs
+    /// and update references are written to a separate \c solv.snapshot.ext.
+    /// Loading the snapshot then reads just the core data; the rest is
+    /// loaded on demand, if a lookup asks for it.
+    ///
+    /// A key file remembers the solv file (inode, size, mtime), the system
+    /// architecture, the libsolv tool version and the mode the snapshot was
+    /// built from. If any of them change the snapshot is stale and rewritten
+    /// on the next load. In lazy mode the key file also remembers the ext
+    /// file, so a missing or replaced ext file invalidates the snapshot too.
+    /// The pool keeps the ext file open from when the snapshot is loaded,
+    /// so a concurrent rewrite does not mix the files. An ext file found
+    /// corrupt when loading from it is removed by the pool, so the snapshot
+    /// is rebuilt on the next load. The snapshot is removed
+    /// together with the solv file by \ref RepoManager::cleanCache.
+    ///////////////////////////////////////////////////////////////////
+    class SolvSnapshot
+    {
+    public:
+      SolvSnapshot( const zypp::Pathname & solvfile_r, bool lazy_r )
+      : _file( solvfile_r.extend( ".snapshot" ) )
+      , _keyfile( solvfile_r.extend( ".snapshot.key" ) )
+      , _lazy( lazy_r )
+      {
+        zypp::PathInfo pi( solvfile_r );
+        _key = ( zypp::str::Str() << pi.ino() << ":" << pi.size() << ":" << pi.mtime()
+                                  << ":" << zypp::ZConfig::instance().systemArchitecture()
+                                  << ":" << LIBSOLV_TOOLVERSION
+                                  << ":" << ( _lazy ? "lazy" : "full" ) ).str();
+      }
+
+      /** The snapshot file. */
+      const zypp::Pathname & file() const
+      { return _file; }
+
+      /** Whether the snapshot (and in lazy mode its ext file) exists and matches the solv file. */
+      bool valid() const
+      {
+        if ( ! zypp::PathInfo( _file ).isFile() )
+          return false;
+        std::ifstream in( _keyfile.c_str() );
+        std::string key;
+        if ( ! ( std::getline( in, key ) && key == _key ) )
+          return false;
+        if ( ! _lazy )
+          return true;
+        std::string extkey { extKey() };
+        return ! extkey.empty() && std::getline( in, key ) && key == extkey;
+      }
+
+      /** Write the snapshot of the loaded and filtered \a repo_r. */
+      void write( const zypp::Repository & repo_r ) const
+      {
+        zypp::filesystem::unlink( _keyfile );
+        zypp::Pathname extfile { _file.extend( ".ext" ) };
+        zypp::filesystem::TmpFile tmp( _file.dirname(), _file.basename() );
+        zypp::filesystem::TmpFile tmpext( _file.dirname(), extfile.basename() );
+        repo_r.writeSolv( tmp.path(), _lazy ? tmpext.path() : zypp::Pathname() );
+
+        // The ext file must be replaced first (see Repository::addSolv).
+        if ( _lazy )
+        {
+          if ( zypp::filesystem::rename( tmpext.path(), extfile ) != 0 )
+            ZYPP_THROW( zypp::Exception( "Can't rename solv snapshot to "+extfile.asString() ) );
+          tmpext.autoCleanup( false );
+        }
+        else
+          zypp::filesystem::unlink( extfile );
+
+        if ( zypp::filesystem::rename( tmp.path(), _file ) != 0 )
+          ZYPP_THROW( zypp::Exception( "Can't rename solv snapshot to "+_file.asString() ) );
+        tmp.autoCleanup( false );
+
+        std::ofstream out( _keyfile.c_str() );
+        out << _key << std::endl;
+        if ( _lazy )
+          out << extKey() << std::endl;
+        if ( ! out )
+          ZYPP_THROW( zypp::Exception( "Can't write "+_keyfile.asString() ) );
+        MIL << "Wrote solv snapshot " << _file << std::endl;
+      }
+
+    private:
+      /** Identifies the ext file (inode, size, mtime); empty if there is none. */
+      std::string extKey() const
+      {
+        zypp::PathInfo pi( _file.extend( ".ext" ) );
+        if ( ! pi.isFile() )
+          return std::string();
+        return ( zypp::str::Str() << pi.ino() << ":" << pi.size() << ":" << pi.mtime() ).str();
+      }
+
+    private:
+      zypp::Pathname _file;
+      zypp::Pathname _keyfile;
+      bool _lazy;
+      std::string _key;
+    };
+
+    /** The snapshot of \a solvfile_r, if snapshots are enabled (\c $ZYPP_POOL_SNAPSHOT, \c $ZYPP_SOLV_LAZY_ATTRS). */
+    std::optional<SolvSnapshot> solvSnapshotFor( const zypp::Pathname & solvfile_r )
+    {
+      std::optional<SolvSnapshot> ret;
+      if ( env::ZYPP_POOL_SNAPSHOT() || env::ZYPP_SOLV_LAZY_ATTRS() )
+        ret.emplace( solvfile_r, env::ZYPP_SOLV_LAZY_ATTRS() );
+      return ret;
+    }
+
+    /** Read \a file_r into the page cache (runs in a worker thread); gives up as soon as \a stop_r is set. */
+    void readAhead( const zypp::Pathname & file_r, const std::atomic<bool> & stop_r )
+    {
+      if ( stop_r )
+        return;
+      int fd = ::open( file_r.c_str(), O_RDONLY|O_CLOEXEC );
+      if ( fd == -1 )
+        return;
+      zypp::AutoDispose<int> guard( fd, ::close );
+      ::posix_fadvise( fd, 0, 0, POSIX_FADV_SEQUENTIAL );
+
+      std::vector<char> buf( 256 * 1024 );
+      while ( ! stop_r && ::read( fd, buf.data(), buf.size() ) > 0 )
+        ;
+    }
   } // namespace
 
   std::ostream & operator<<( std::ostream & str, zypp::RepoManagerFlags::RawMetadataRefreshPolicy obj )
@@ -329,17 +483,23 @@ namespace zyppng
         // if the metadata cache is empty. So additional components like the
         // RepoInfos status are joined after the switch IFF the status is not
         // empty.huhu
+        // The solv cookie remembers the fingerprints of the files, so
+        // they are not checksummed again if they are unchanged.
+        RepoStatus hint;
+        if ( expected<RepoStatus> cached { cacheStatus( info, options ) } )
+          hint = *cached;
+
         RepoStatus status;
         switch ( repokind.toEnum() )
         {
           case zypp::repo::RepoType::RPMMD_e :
-            status = RepoStatus( productdatapath/"repodata/repomd.xml");
+            status = RepoStatus( productdatapath/"repodata/repomd.xml", hint );
             if ( info.requireStatusWithMediaFile() )
-              status = status && RepoStatus( mediarootpath/"media.1/media" );
+              status = status && RepoStatus( mediarootpath/"media.1/media", hint );
             break;
 
           case zypp::repo::RepoType::YAST2_e :
-            status = RepoStatus( productdatapath/"content" ) && RepoStatus( mediarootpath/"media.1/media" );
+            status = RepoStatus( productdatapath/"content", hint ) && RepoStatus( mediarootpath/"media.1/media", hint );
             break;
 
           case zypp::repo::RepoType::RPMPLAINDIR_e :
@@ -531,7 +691,10 @@ namespace zyppng
 
       ProgressObserver::increase ( myProgress );
 
-      zypp::Repository repo = _zyppContext->satPool().addRepoSolv( solvfile, info );
+      std::optional<SolvSnapshot> snapshot { solvSnapshotFor( solvfile ) };
+      bool useSnapshot = snapshot && snapshot->valid();
+
+      zypp::Repository repo = _zyppContext->satPool().addRepoSolv( useSnapshot ? snapshot->file() : solvfile, info );
 
       ProgressObserver::increase ( myProgress );
 
@@ -542,6 +705,19 @@ namespace zyppng
         repo.eraseFromPool();
         ZYPP_THROW(zypp::Exception(zypp::str::Str() << "Solv-file was created by '"<<toolversion<<"'-parser (want "<<LIBSOLV_TOOLVERSION<<")."));
       }
+      // (Re)write a missing or outdated content digest for zypper bash completion.
+      // Not from the loaded repo: incompatible architectures were dropped from it.
+      zypp::sat::updateSolvFileIndex( solvfile );
+
+      if ( snapshot && ! useSnapshot ) {
+        try {
+          snapshot->write( repo );
+        }
+        catch ( const zypp::Exception & excpt ) {
+          ZYPP_CAUGHT( excpt );
+          WAR << "No solv snapshot for " << info.alias() << ": " << excpt.asUserString() << std::endl;
+        }
+      }
     })
     | or_else( [this, info, myProgress]( std::exception_ptr exp ) {
       ZYPP_CAUGHT( exp );
@@ -566,6 +742,40 @@ namespace zyppng
   }
 
 
+  expected<void> RepoManager::loadFromCache( const std::vector<RepoInfo> & infos, ProgressObserverRef myProgress )
+  {
+    ProgressObserver::setup( myProgress, _("Loading from cache"), infos.size() );
+    ProgressObserver::start( myProgress );
+
+    // libsolv can't parse into the pool concurrently, but reading the
+    // files is done ahead while the previous repos are added. The file
+    // read is the one loadFromCache is going to load.
+    std::atomic<bool> stop { false };
+    zypp::WorkerPool readers;
+    for ( const RepoInfo & info : infos ) {
+      expected<zypp::Pathname> solvpath { solv_path_for_repoinfo( _options, info ) };
+      if ( ! solvpath )
+        continue;
+      zypp::Pathname solvfile { *solvpath / "solv" };
+      std::optional<SolvSnapshot> snapshot { solvSnapshotFor( solvfile ) };
+      if ( snapshot && snapshot->valid() )
+        solvfile = snapshot->file();
+      readers.enqueue( [solvfile,&stop]() { readAhead( solvfile, stop ); } );
+    }
+
+    for ( const RepoInfo & info : infos ) {
+      expected<void> res { loadFromCache( info, ProgressObserver::makeSubTask( myProgress ) ) };
+      if ( ! res ) {
+        stop = true;	// the readers still queued are not needed
+        ProgressObserver::finish( myProgress, ProgressObserver::Error );
+        return res;
+      }
+    }
+
+    ProgressObserver::finish( myProgress );
+    return expected<void>::success();
+  }
+
   expected<RepoInfo> RepoManager::addProbedRepository( RepoInfo info, zypp::repo::RepoType probedType )
   {
     try {
@@ -831,7 +1041,9 @@ namespace zyppng
       | and_then( [this, origin, policy]( zyppng::repo::RefreshContextRef &&refCtx ) {
         refCtx->setPolicy ( static_cast<zyppng::repo::RawMetadataRefreshPolicy>( policy ) );
 
-        return _zyppContext->provider()->prepareMedia( origin, zyppng::ProvideMediaSpec() )
+        // the plaindir status is computed from the local tree
+        const bool localTree = ( refCtx->repoInfo().type() == zypp::repo::RepoType::RPMPLAINDIR );
+        return _zyppContext->provider()->prepareMedia( origin, zyppng::ProvideMediaSpec().setLocalTreeRequired( localTree ) )
             | and_then( [ r = std::move(refCtx) ]( auto mediaHandle ) mutable { return zyppng::RepoManagerWorkflow::checkIfToRefreshMetadata ( std::move(r), std::move(mediaHandle), nullptr ); } );
       })
         );
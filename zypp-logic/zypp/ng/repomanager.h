@@ -14,6 +14,7 @@
 
 #include <utility>
 #include <optional>
+#include <vector>
 
 #include <zypp/RepoManagerFlags.h>
 #include <zypp/RepoManagerOptions.h>
@@ -360,6 +361,12 @@ namespace zyppng {
 
     expected<void> loadFromCache( const RepoInfo & info, ProgressObserverRef myProgress = nullptr );
 
+    /** Load multiple repos in the given order.
+     * The solv files are read ahead concurrently, while the repos are
+     * added to the pool one after the other. Stops at the first failure.
+     */
+    expected<void> loadFromCache( const std::vector<RepoInfo> & infos, ProgressObserverRef myProgress = nullptr );
+
     expected<RepoInfo> addProbedRepository( RepoInfo info, zypp::repo::RepoType probedType );
 
     expected<void> removeRepository( const RepoInfo & info, ProgressObserverRef myProgress = nullptr );
@@ -19,6 +19,7 @@
 #include <zypp-core/parser/ParseException>
 
 #include <zypp/parser/HistoryLogReader.h>
+#include <zypp/parser/private/historylogindex_p.h>
 
 using std::endl;
 
@@ -47,6 +48,11 @@ namespace zypp
     void readAll( const ProgressData::ReceiverFnc & progress_r );
     void readFrom( const Date & date_r, const ProgressData::ReceiverFnc & progress_r );
     void readFromTo( const Date & fromDate_r, const Date & toDate_r, const ProgressData::ReceiverFnc & progress_r );
+    void readPackage( const std::string & name_r, const ProgressData::ReceiverFnc & progress_r );
+
+    /** Read the mapped log from \a start_r on; \see readFrom and readFromTo. */
+    void readMapped( const MappedHistoryLog & log_r, HistoryLogIndex::Position start_r,
+                     const Date & fromDate_r, const Date * toDate_r, const ProgressData::ReceiverFnc & progress_r );
 
     void addActionFilter( const HistoryActionID & action_r )
     {
@@ -131,8 +137,57 @@ namespace zypp
     pd.toMax();
   }
 
+  void HistoryLogReader::Impl::readMapped( const MappedHistoryLog & log_r, HistoryLogIndex::Position start_r,
+                                           const Date & fromDate_r, const Date * toDate_r, const ProgressData::ReceiverFnc & progress_r )
+  {
+    ProgressData pd;
+    pd.sendTo( progress_r );
+    pd.toMin();
+
+    bool pastFromDate = false;
+    for ( HistoryLogIndex::Position pos { start_r }; pos.offset < log_r.data().size(); ++pos.line, pd.tick() )
+    {
+      unsigned lineNo = pos.line;
+      std::string_view line { log_r.nextLine( pos.offset ) };
+
+      // ignore comments
+      if ( line.empty() || line[0] == '#' )
+        continue;
+
+      if ( toDate_r || !pastFromDate )
+      {
+        Date logDate { HistoryLogIndex::lineDate( line ) };
+
+        // past toDate - stop reading
+        if ( toDate_r && logDate >= *toDate_r )
+          break;
+
+        // past fromDate - start reading
+        if ( !pastFromDate && logDate > fromDate_r )
+          pastFromDate = true;
+      }
+
+      if ( pastFromDate )
+      {
+        if ( ! parseLine( std::string( line ), lineNo ) )
+          break;	// requested by consumer callback
+      }
+    }
+
+    pd.toMax();
+  }
+
   void HistoryLogReader::Impl::readFrom( const Date & date_r, const ProgressData::ReceiverFnc & progress_r )
   {
+    HistoryLogIndex::update( _filename, /*create_r*/true );
+    MappedHistoryLog log( _filename );
+    if ( ! log.data().empty() )
+    {
+      HistoryLogIndex index( log, _filename );
+      readMapped( log, index.positionBefore( date_r ), date_r, nullptr, progress_r );
+      return;
+    }
+
     InputStream is( _filename );
     iostr::EachLine line( is );
 
@@ -171,6 +226,15 @@ namespace zypp
 
   void HistoryLogReader::Impl::readFromTo( const Date & fromDate_r, const Date & toDate_r, const ProgressData::ReceiverFnc & progress_r )
   {
+    HistoryLogIndex::update( _filename, /*create_r*/true );
+    MappedHistoryLog log( _filename );
+    if ( ! log.data().empty() )
+    {
+      HistoryLogIndex index( log, _filename );
+      readMapped( log, index.positionBefore( fromDate_r ), fromDate_r, &toDate_r, progress_r );
+      return;
+    }
+
     InputStream is( _filename );
     iostr::EachLine line( is );
 
@@ -207,6 +271,55 @@ namespace zypp
     pd.toMax();
   }
 
+  void HistoryLogReader::Impl::readPackage( const std::string & name_r, const ProgressData::ReceiverFnc & progress_r )
+  {
+    ProgressData pd;
+    pd.sendTo( progress_r );
+    pd.toMin();
+
+    HistoryLogIndex::update( _filename, /*create_r*/true );
+    MappedHistoryLog log( _filename );
+    if ( log.data().empty() )
+    {
+      InputStream is( _filename );
+      for ( iostr::EachLine line( is ); line; line.next(), pd.tick() )
+      {
+        if ( HistoryLogIndex::packageName( *line ) == name_r && ! parseLine( *line, line.lineNo() ) )
+          break;	// requested by consumer callback
+      }
+      pd.toMax();
+      return;
+    }
+
+    HistoryLogIndex index( log, _filename, name_r );
+    for ( const auto & pos : index.positionsFor( name_r ) )
+    {
+      std::string_view line { log.lineAt( pos.offset ) };
+      if ( HistoryLogIndex::packageName( line ) != name_r )
+      {
+        WAR << "Ignore stale index entry for " << name_r << " on line #" << pos.line << endl;
+        continue;
+      }
+      if ( ! parseLine( std::string( line ), pos.line ) )
+      {
+        pd.toMax();
+        return;	// requested by consumer callback
+      }
+      pd.tick();
+    }
+
+    // scan the lines not yet indexed
+    for ( HistoryLogIndex::Position pos { index.indexedEnd() }; pos.offset < log.data().size(); ++pos.line, pd.tick() )
+    {
+      unsigned lineNo = pos.line;
+      std::string_view line { log.nextLine( pos.offset ) };
+      if ( HistoryLogIndex::packageName( line ) == name_r && ! parseLine( std::string( line ), lineNo ) )
+        break;	// requested by consumer callback
+    }
+
+    pd.toMax();
+  }
+
   /////////////////////////////////////////////////////////////////////
   //
   //	class HistoryLogReader
@@ -235,6 +348,9 @@ namespace zypp
   void HistoryLogReader::readFromTo( const Date & fromDate_r, const Date & toDate_r, const ProgressData::ReceiverFnc & progress_r )
   { _pimpl->readFromTo( fromDate_r, toDate_r, progress_r ); }
 
+  void HistoryLogReader::readPackage( const std::string & name_r, const ProgressData::ReceiverFnc & progress_r )
+  { _pimpl->readPackage( name_r, progress_r ); }
+
   void HistoryLogReader::addActionFilter( const HistoryActionID & action_r )
   { _pimpl->addActionFilter( action_r ); }
 
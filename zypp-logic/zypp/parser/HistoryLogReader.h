@@ -62,6 +62,10 @@ namespace zypp
   /// \endcode
   /// \see \ref HistoryLogData for how to access the individual data fields.
   ///
+  /// Uncompressed logs are mapped into memory. If \ref HistoryLog maintains
+  /// an index for the log (<tt>\<log\>.idx</tt>), \ref readFrom, \ref readFromTo
+  /// and \ref readPackage use it to skip the parts of the log not asked for.
+  ///
   ///////////////////////////////////////////////////////////////////
   class ZYPP_API HistoryLogReader
   {
@@ -125,6 +129,19 @@ namespace zypp
      */
     void readFromTo( const Date & fromDate, const Date & toDate, const ProgressData::ReceiverFnc & progress = ProgressData::ReceiverFnc() );
 
+    /**
+     * Read the log entries mentioning package \a name (install, remove
+     * and patch entries).
+     *
+     * If the log is indexed (see \ref HistoryLog), just the indexed
+     * entries are read and the lines appended to the log afterwards
+     * are scanned. Otherwise the whole log is scanned.
+     *
+     * \param name     Name of the package.
+     * \param progress An optional progress data receiver function.
+     */
+    void readPackage( const std::string & name, const ProgressData::ReceiverFnc & progress = ProgressData::ReceiverFnc() );
+
     /**
      * Set the reader to ignore invalid log entries and continue with the rest.
      *
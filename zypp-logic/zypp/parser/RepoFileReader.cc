@@ -114,7 +114,8 @@ namespace zypp
         void storeUrl( std::list<Url> & store_r, const std::string & line_r )
         {
           // #285: Fedora/dnf allows WS separated urls (and an optional comma)
-          strv::splitRx( line_r, "[,[:blank:]]*[[:blank:]][,[:blank:]]*", [&store_r]( std::string_view w ) {
+          static const str::regex rxSep( "[,[:blank:]]*[[:blank:]][,[:blank:]]*" );
+          strv::splitRx( line_r, rxSep, [&store_r]( std::string_view w ) {
             if ( ! w.empty() )
               store_r.push_back( Url(std::string(w)) );
           });
@@ -39,7 +39,6 @@ namespace zypp
   namespace parser
   {
     using xml::Reader;
-    using xml::XmlString;
 
     ///////////////////////////////////////////////////////////////////
     namespace
@@ -140,12 +139,16 @@ namespace zypp
     DefaultIntegral<Date::Duration,0> _ttl;
 
   private:
-    bool getAttrValue( const std::string & key_r, Reader & reader_r, std::string & value_r )
+    /** Lookup in the current node's \ref _attrs. */
+    bool getAttrValue( std::string_view key_r, std::string & value_r )
     {
-      const XmlString & s( reader_r->getAttribute( key_r ) );
-      if ( s.get() )
+      const std::string * s { _attrs.find( key_r ) };
+      if ( s )
       {
-        value_r = _replacer.replace( s.asString() );
+        if ( s->find( "%{" ) == std::string::npos )
+          value_r.assign( *s );	// reuse value_r's buffer
+        else
+          value_r = _replacer.replace( *s );
         return !value_r.empty();
       }
       value_r.clear();
@@ -156,6 +159,7 @@ namespace zypp
     /** Function for processing collected data. Passed-in through constructor. */
     ProcessResource _callback;
     VarReplacer _replacer;
+    xml::NodeAttributes _attrs;	///< attributes of the current repo node (buffers reused)
   };
   ///////////////////////////////////////////////////////////////////////
 
@@ -186,7 +190,7 @@ namespace zypp
     if ( reader_r->nodeType() == XML_READER_TYPE_ELEMENT )
     {
       // xpath: /repoindex
-      if ( reader_r->name() == "repoindex" )
+      if ( reader_r->nameView() == "repoindex" )
       {
         while ( reader_r.nextNodeAttribute() )
         {
@@ -201,7 +205,7 @@ namespace zypp
       }
 
       // xpath: /repoindex/data (+)
-      if ( reader_r->name() == "repo" )
+      if ( reader_r->nameView() == "repo" )
       {
         // TODO: Ideally the repo values here are interpreted the same way as
         // corresponding ones in the RepoFileReader. Check whether we can introduce
@@ -215,10 +219,11 @@ namespace zypp
 
         std::string attrValue;
         _replacer.clearSectionVars();
+        _attrs.collect( reader_r );
 
         // required alias
         // mandatory, so we can allow it in var replacement without reset
-        if ( getAttrValue( "alias", reader_r, attrValue ) )
+        if ( getAttrValue( "alias", attrValue ) )
         {
           info.setAlias( attrValue );
           _replacer.setSectionVar( "alias", attrValue );
@@ -231,8 +236,8 @@ namespace zypp
         {
           std::string urlstr;
           std::string pathstr;
-          getAttrValue( "url", reader_r, urlstr );
-          getAttrValue( "path", reader_r, pathstr );
+          getAttrValue( "url", urlstr );
+          getAttrValue( "path", pathstr );
           if ( urlstr.empty() )
           {
             if ( pathstr.empty() )
@@ -259,47 +264,47 @@ namespace zypp
         }
 
         // optional name
-        if ( getAttrValue( "name", reader_r, attrValue ) )
+        if ( getAttrValue( "name", attrValue ) )
           info.setName( attrValue );
 
         // optional targetDistro
-        if ( getAttrValue( "distro_target", reader_r, attrValue ) )
+        if ( getAttrValue( "distro_target", attrValue ) )
           info.setTargetDistribution( attrValue );
 
         // optional priority
-        if ( getAttrValue( "priority", reader_r, attrValue ) )
+        if ( getAttrValue( "priority", attrValue ) )
           info.setPriority( str::strtonum<unsigned>( attrValue ) );
 
         // optional enabled
-        if ( getAttrValue( "enabled", reader_r, attrValue ) )
+        if ( getAttrValue( "enabled", attrValue ) )
           info.setEnabled( str::strToBool( attrValue, info.enabled() ) );
 
         // optional autorefresh
-        if ( getAttrValue( "autorefresh", reader_r, attrValue ) )
+        if ( getAttrValue( "autorefresh", attrValue ) )
           info.setAutorefresh( str::strToBool( attrValue, info.autorefresh() ) );
 
         // optional *gpgcheck
-        if ( getAttrValue( "gpgcheck", reader_r, attrValue ) )
+        if ( getAttrValue( "gpgcheck", attrValue ) )
           info.setGpgCheck( str::strToTriBool( attrValue ) );
-        if ( getAttrValue( "repo_gpgcheck", reader_r, attrValue ) )
+        if ( getAttrValue( "repo_gpgcheck", attrValue ) )
           info.setRepoGpgCheck( str::strToTrue( attrValue ) );
-        if ( getAttrValue( "pkg_gpgcheck", reader_r, attrValue ) )
+        if ( getAttrValue( "pkg_gpgcheck", attrValue ) )
           info.setPkgGpgCheck( str::strToTrue( attrValue ) );
 
         // optional keeppackages
-        if ( getAttrValue( "keeppackages", reader_r, attrValue ) )
+        if ( getAttrValue( "keeppackages", attrValue ) )
           info.setKeepPackages( str::strToTrue( attrValue ) );
 
         // optional gpgkey
-        if ( getAttrValue( "gpgkey", reader_r, attrValue ) )
+        if ( getAttrValue( "gpgkey", attrValue ) )
           info.setGpgKeyUrl( Url(attrValue) );
 
         // optional mirrorlist
-        if ( getAttrValue( "mirrorlist", reader_r, attrValue ) )
+        if ( getAttrValue( "mirrorlist", attrValue ) )
           info.setMirrorlistUrl( Url(attrValue) );
 
         // optional metalink
-        if ( getAttrValue( "metalink", reader_r, attrValue ) )
+        if ( getAttrValue( "metalink", attrValue ) )
           info.setMetalinkUrl( Url(attrValue) );
 
         DBG << info << endl;
@@ -0,0 +1,370 @@
+/*---------------------------------------------------------------------\
+|                          ____ _   __ __ ___                          |
+|                         |__  / \ / / . \ . \                         |
+|                           / / \ V /|  _/  _/                         |
+|                          / /__ | | | | | |                           |
+|                         /_____||_| |_| |_|                           |
+|                                                                      |
+\---------------------------------------------------------------------*/
+/** \file	zypp/parser/historylogindex.cc
+ *
+*/
+#include <sys/file.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <optional>
+#include <sstream>
+
+#include <zypp/parser/private/historylogindex_p.h>
+#include <zypp-core/AutoDispose.h>
+#include <zypp-core/base/Logger.h>
+#include <zypp-core/base/String.h>
+#include <zypp/PathInfo.h>
+#include <zypp/HistoryLogData.h>
+
+using std::endl;
+
+///////////////////////////////////////////////////////////////////
+namespace zypp
+{
+  ///////////////////////////////////////////////////////////////////
+  namespace parser
+  {
+    namespace
+    {
+      constexpr const char * indexMagic = "#zypp-history-index";
+      constexpr unsigned indexVersion = 1;
+      constexpr unsigned datePointEvery = 64;	// < remember the date of every 64th line
+
+      /** The \a n_r-th '|' separated field of \a line_r (unescaped fields only). */
+      std::string_view field( std::string_view line_r, unsigned n_r )
+      {
+        for ( ; n_r; --n_r )
+        {
+          std::string_view::size_type sep = line_r.find( '|' );
+          if ( sep == std::string_view::npos )
+            return std::string_view();
+          line_r.remove_prefix( sep+1 );
+        }
+        return line_r.substr( 0, line_r.find( '|' ) );
+      }
+
+      /** Whether \a line_r is the index header for a log with inode \a ino_r. */
+      bool isIndexHeader( std::string_view line_r, unsigned long long ino_r )
+      {
+        std::vector<std::string> words;
+        str::split( std::string( line_r ), std::back_inserter(words) );
+        return words.size() == 3 && words[0] == indexMagic
+               && str::strtonum<unsigned>( words[1] ) == indexVersion
+               && str::strtonum<unsigned long long>( words[2] ) == ino_r;
+      }
+
+      /** Whether the log was indexed up to \a offset_r, i.e. it was not truncated since. */
+      bool isLineStart( const MappedHistoryLog & log_r, HistoryLogIndex::Offset offset_r )
+      { return offset_r <= log_r.data().size() && ( ! offset_r || log_r.data()[offset_r-1] == '\n' ); }
+
+      /** How far the valid index \a idxfile_r covers \a log_r.
+       * Just the header and the last \c S record are read, not the whole index.
+       */
+      std::optional<HistoryLogIndex::Position> readIndexedEnd( const Pathname & idxfile_r, const MappedHistoryLog & log_r )
+      {
+        AutoFD fd { ::open( idxfile_r.c_str(), O_RDONLY | O_CLOEXEC ) };
+        struct ::stat st;
+        if ( fd == -1 || ::fstat( fd, &st ) != 0 )
+          return std::nullopt;
+
+        std::string chunk( std::min<off_t>( st.st_size, 256 ), '\0' );
+        if ( ::pread( fd, chunk.data(), chunk.size(), 0 ) != ssize_t(chunk.size())
+             || ! isIndexHeader( std::string_view( chunk ).substr( 0, chunk.find( '\n' ) ), log_r.ino() ) )
+          return std::nullopt;
+
+        // An incomplete last line can't be appended to; rebuild.
+        char last = 0;
+        if ( ::pread( fd, &last, 1, st.st_size-1 ) != 1 || last != '\n' )
+          return std::nullopt;
+
+        // Search backwards for the last "S <offset> <line>" (a crashed update may have left records after it).
+        std::string tail;
+        for ( off_t end = st.st_size; end > 0; )
+        {
+          off_t begin = std::max<off_t>( 0, end - 4096 );
+          chunk.assign( end - begin, '\0' );
+          if ( ::pread( fd, chunk.data(), chunk.size(), begin ) != ssize_t(chunk.size()) )
+            return std::nullopt;
+          tail.insert( 0, chunk );
+          end = begin;
+
+          for ( std::string::size_type pos = tail.rfind( "\nS " ); pos != std::string::npos; pos = pos ? tail.rfind( "\nS ", pos-1 ) : std::string::npos )
+          {
+            std::string::size_type eol = tail.find( '\n', pos+1 );
+            std::istringstream str( tail.substr( pos+3, eol-pos-3 ) );
+            HistoryLogIndex::Position ret;
+            if ( ! ( str >> ret.offset >> ret.line ) || ! ret.line )
+              continue;
+            if ( ! isLineStart( log_r, ret.offset ) )
+              return std::nullopt;	// log was truncated
+            return ret;
+          }
+        }
+        return std::nullopt;
+      }
+    } // namespace
+
+    ///////////////////////////////////////////////////////////////////
+    //
+    //	class MappedHistoryLog
+    //
+    ///////////////////////////////////////////////////////////////////
+
+    MappedHistoryLog::MappedHistoryLog( const Pathname & file_r )
+    {
+      if ( filesystem::zipType( file_r ) != filesystem::ZT_NONE )
+        return;	// the stream based reader will handle it
+
+      int fd = ::open( file_r.c_str(), O_RDONLY | O_CLOEXEC );
+      if ( fd == -1 )
+        return;
+
+      struct ::stat st;
+      if ( ::fstat( fd, &st ) == 0 && S_ISREG(st.st_mode) && st.st_size > 0 )
+      {
+        void * addr = ::mmap( nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0 );
+        if ( addr != MAP_FAILED )
+        {
+          _data = std::string_view( static_cast<const char *>(addr), st.st_size );
+          _ino = st.st_ino;
+        }
+        else
+          WAR << "Can't mmap " << file_r << ": " << str::strerror( errno ) << endl;
+      }
+      ::close( fd );
+    }
+
+    MappedHistoryLog::~MappedHistoryLog()
+    {
+      if ( ! _data.empty() )
+        ::munmap( const_cast<char *>(_data.data()), _data.size() );
+    }
+
+    std::string_view MappedHistoryLog::nextLine( std::string_view::size_type & offset_r ) const
+    {
+      if ( offset_r >= _data.size() )
+        return std::string_view();
+
+      std::string_view::size_type eol = _data.find( '\n', offset_r );
+      if ( eol == std::string_view::npos )
+        eol = _data.size();
+      std::string_view ret { _data.substr( offset_r, eol - offset_r ) };
+      offset_r = eol + 1;
+      return ret;
+    }
+
+    ///////////////////////////////////////////////////////////////////
+    //
+    //	class HistoryLogIndex
+    //
+    ///////////////////////////////////////////////////////////////////
+
+    std::string_view HistoryLogIndex::packageName( std::string_view line_r )
+    {
+      std::string_view action { field( line_r, HistoryLogData::ACTION_INDEX ) };
+      while ( ! action.empty() && action.back() == ' ' )
+        action.remove_suffix( 1 );	// the writer is padding the action field
+
+      if ( action == "install" || action == "remove" || action == "patch" )
+        return field( line_r, HistoryLogData::ACTION_INDEX+1 );
+      return std::string_view();
+    }
+
+    Date HistoryLogIndex::lineDate( std::string_view line_r )
+    { return Date( std::string( field( line_r, HistoryLogData::DATE_INDEX ) ), HISTORY_LOG_DATE_FORMAT ); }
+
+    HistoryLogIndex::HistoryLogIndex( const MappedHistoryLog & log_r, const Pathname & logfile_r, std::string_view package_r )
+    {
+      std::string_view data { log_r.data() };
+      if ( data.empty() )
+        return;
+
+      MappedHistoryLog idx( indexFile( logfile_r ) );
+      Offset next = 0;
+      if ( ! isIndexHeader( idx.nextLine( next ), log_r.ino() ) )
+      {
+        if ( ! idx.data().empty() )
+          DBG << "Ignore stale index " << indexFile( logfile_r ) << endl;
+        return;
+      }
+
+      // Records are taken over when the S record completing them is read.
+      // A crashed update may have left an incomplete tail.
+      std::vector<std::pair<Position,Date::ValueType>> dates;
+      std::vector<std::pair<Position,std::string_view>> packages;
+      while ( next < idx.data().size() )
+      {
+        std::string_view line { idx.nextLine( next ) };
+        if ( line.size() < 3 || line[1] != ' ' )
+          continue;
+
+        // D/P/S <offset> <line> <rest>
+        std::vector<std::string_view> words;
+        words.reserve( 4 );
+        for ( std::string_view::size_type pos = 2; words.size() < 3; )
+        {
+          std::string_view::size_type sep = line.find( ' ', pos );
+          words.push_back( line.substr( pos, sep == std::string_view::npos ? sep : sep - pos ) );
+          if ( sep == std::string_view::npos )
+            break;
+          pos = sep + 1;
+        }
+        if ( words.size() < 2 )
+          continue;
+
+        Position pos;
+        pos.offset = str::strtonum<Offset>( std::string( words[0] ) );
+        pos.line = str::strtonum<unsigned>( std::string( words[1] ) );
+        if ( ! pos.line )
+          continue;
+
+        switch ( line[0] )
+        {
+          case 'D':
+            if ( words.size() == 3 )
+              dates.push_back( { pos, str::strtonum<Date::ValueType>( std::string( words[2] ) ) } );
+            break;
+
+          case 'P':
+            if ( words.size() == 3 && ! words[2].empty() && ( package_r.empty() || words[2] == package_r ) )
+              packages.push_back( { pos, words[2] } );
+            break;
+
+          case 'S':
+            if ( ! isLineStart( log_r, pos.offset ) )
+            {
+              DBG << "Ignore index " << indexFile( logfile_r ) << ": log was truncated" << endl;
+              _dates.clear();
+              _packages.clear();
+              return;
+            }
+            if ( _indexedEnd < pos )
+              _indexedEnd = pos;
+            _dates.insert( _dates.end(), dates.begin(), dates.end() );
+            dates.clear();
+            for ( const auto & el : packages )
+              _packages[std::string(el.second)].push_back( el.first );
+            packages.clear();
+            break;
+        }
+      }
+
+      // Concurrent updates may have added some records twice.
+      std::sort( _dates.begin(), _dates.end() );
+      _dates.erase( std::unique( _dates.begin(), _dates.end() ), _dates.end() );
+      for ( auto & el : _packages )
+      {
+        std::sort( el.second.begin(), el.second.end() );
+        el.second.erase( std::unique( el.second.begin(), el.second.end() ), el.second.end() );
+      }
+      _valid = true;
+    }
+
+    HistoryLogIndex::Position HistoryLogIndex::positionBefore( const Date & date_r ) const
+    {
+      // Lines are appended in chronological order, so all lines before
+      // a date point not newer than date_r are not newer either.
+      Position ret;
+      for ( const auto & el : _dates )
+      {
+        if ( el.second > Date::ValueType(date_r) )
+          break;
+        ret = el.first;
+      }
+      return ret;
+    }
+
+    const std::vector<HistoryLogIndex::Position> & HistoryLogIndex::positionsFor( const std::string & name_r ) const
+    {
+      static const std::vector<Position> _none;
+      auto it = _packages.find( name_r );
+      return it == _packages.end() ? _none : it->second;
+    }
+
+    void HistoryLogIndex::update( const Pathname & log_r, bool create_r )
+    {
+      // Serialize concurrent updates. The lock is taken on the log, as a
+      // stale index file is replaced.
+      AutoFD lock { ::open( log_r.c_str(), O_RDONLY | O_CLOEXEC ) };
+      if ( lock == -1 || ::flock( lock, LOCK_EX ) != 0 )
+        return;
+
+      MappedHistoryLog log( log_r );
+      std::string_view data { log.data() };
+      if ( data.empty() )
+        return;
+
+      // index complete lines only
+      Offset end = data.rfind( '\n' );
+      if ( end == std::string_view::npos )
+        return;
+      ++end;
+
+      const Pathname & idxfile { indexFile( log_r ) };
+      std::optional<Position> indexed { readIndexedEnd( idxfile, log ) };
+      if ( ! indexed && ! create_r )
+        return;	// the next reader builds it
+      Position pos { indexed ? *indexed : Position() };
+      if ( pos.offset == end )
+        return;
+
+      std::ostringstream out;
+      if ( ! indexed )
+        out << indexMagic << " " << indexVersion << " " << log.ino() << "\n";
+
+      unsigned entries = 0;
+      for ( ; pos.offset < end; ++pos.line )
+      {
+        Position here { pos };
+        std::string_view line { log.nextLine( pos.offset ) };
+        if ( line.empty() || line[0] == '#' )
+          continue;
+
+        if ( entries % datePointEvery == 0 )
+        {
+          Date date { lineDate( line ) };
+          if ( date )
+            out << "D " << here.offset << " " << here.line << " " << Date::ValueType(date) << "\n";
+          else
+            --entries;	// try the next line
+        }
+        ++entries;
+
+        std::string_view name { packageName( line ) };
+        if ( ! name.empty() )
+          out << "P " << here.offset << " " << here.line << " " << name << "\n";
+      }
+      out << "S " << pos.offset << " " << pos.line << "\n";
+
+      // Append to a valid index, otherwise replace it (readers may have the old one mapped).
+      const std::string & records { out.str() };
+      const Pathname & target { indexed ? idxfile : idxfile.extend( ".new" ) };
+      AutoFD fd { ::open( target.c_str(), O_WRONLY | O_CREAT | O_CLOEXEC | ( indexed ? O_APPEND : O_TRUNC ), 0644 ) };
+      bool ok = ( fd != -1 && ::write( fd, records.data(), records.size() ) == ssize_t(records.size()) );
+      if ( ok && ! indexed )
+        ok = ( ::fsync( fd ) == 0 && filesystem::rename( target, idxfile ) == 0 );
+      if ( ! ok )
+      {
+        // e.g. a user reading root's history
+        DBG << "Can't write history log index " << idxfile << ": " << str::strerror( errno ) << endl;
+        if ( ! indexed )
+          filesystem::unlink( target );
+        return;
+      }
+      DBG << "Indexed " << entries << " history log entries in " << idxfile << endl;
+    }
+
+  } // namespace parser
+  ///////////////////////////////////////////////////////////////////
+} // namespace zypp
+///////////////////////////////////////////////////////////////////
@@ -0,0 +1,158 @@
+/*---------------------------------------------------------------------\
+|                          ____ _   __ __ ___                          |
+|                         |__  / \ / / . \ . \                         |
+|                           / / \ V /|  _/  _/                         |
+|                          / /__ | | | | | |                           |
+|                         /_____||_| |_| |_|                           |
+|                                                                      |
+\---------------------------------------------------------------------*/
+/** \file	zypp/parser/private/historylogindex_p.h
+ * This file contains private API, it will change without notice.
+ * You have been warned.
+*/
+#ifndef ZYPP_PARSER_PRIVATE_HISTORYLOGINDEX_P_H
+#define ZYPP_PARSER_PRIVATE_HISTORYLOGINDEX_P_H
+
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include <zypp-core/Pathname.h>
+#include <zypp-core/Date.h>
+#include <zypp-core/base/NonCopyable.h>
+
+///////////////////////////////////////////////////////////////////
+namespace zypp
+{
+  ///////////////////////////////////////////////////////////////////
+  namespace parser
+  {
+    ///////////////////////////////////////////////////////////////////
+    /// \class MappedHistoryLog
+    /// \brief An uncompressed history log (or index) file mapped into memory.
+    ///////////////////////////////////////////////////////////////////
+    class ZYPP_LOCAL MappedHistoryLog : private base::NonCopyable
+    {
+    public:
+      /** Map \a file_r; \ref data is empty if the file is compressed or can't be mapped. */
+      explicit MappedHistoryLog( const Pathname & file_r );
+
+      ~MappedHistoryLog();
+
+      /** The file's content. */
+      std::string_view data() const
+      { return _data; }
+
+      /** Inode of the file. */
+      unsigned long long ino() const
+      { return _ino; }
+
+      /** The line starting at \a offset_r (without NL); \a offset_r is moved to the next line. */
+      std::string_view nextLine( std::string_view::size_type & offset_r ) const;
+
+      /** The line starting at \a offset_r (without NL). */
+      std::string_view lineAt( std::string_view::size_type offset_r ) const
+      { return nextLine( offset_r ); }
+
+    private:
+      std::string_view _data;
+      unsigned long long _ino = 0;
+    };
+
+    ///////////////////////////////////////////////////////////////////
+    /// \class HistoryLogIndex
+    /// \brief Sidecar index of a history log file (<tt>\<log\>.idx</tt>).
+    ///
+    /// Remembers the offsets of some lines and their dates, and the
+    /// offsets of the lines mentioning a package, so the
+    /// \ref HistoryLogReader does not need to scan the whole log to
+    /// find a date range or a package.
+    ///
+    /// The index file is a text file of records appended by \ref update:
+    /// \code
+    ///   #zypp-history-index 1 <log inode>
+    ///   D <offset> <line> <time_t>  // date of the line at offset
+    ///   P <offset> <line> <name>    // line at offset mentions package name
+    ///   S <size> <lines>            // log is indexed up to size
+    /// \endcode
+    /// The index covers the log up to the last \c S record. Lines
+    /// appended later (e.g. by a libzypp not maintaining the index) are
+    /// not indexed but must be scanned. The \ref HistoryLogReader builds
+    /// a missing index when it first reads the log. If the log was replaced or
+    /// truncated (e.g. by logrotate), the index is discarded.
+    ///////////////////////////////////////////////////////////////////
+    class ZYPP_LOCAL HistoryLogIndex
+    {
+    public:
+      using Offset = std::string_view::size_type;
+
+      /** Start of a line in the log. */
+      struct Position
+      {
+        Offset offset = 0;
+        unsigned line = 1;	///< line number, starting with 1
+
+        bool operator<( const Position & rhs ) const
+        { return offset < rhs.offset; }
+        bool operator==( const Position & rhs ) const
+        { return offset == rhs.offset; }
+      };
+
+      /** Index file for history log \a log_r. */
+      static Pathname indexFile( const Pathname & log_r )
+      { return log_r.extend( ".idx" ); }
+
+      /** Add the lines of \a log_r not yet indexed to the index file.
+       * Only the index's header and last \c S record are read to find
+       * the lines not yet indexed, so this is cheap enough to be called
+       * whenever the log is closed. If there is no valid index, it is
+       * (re)built from scratch only if \a create_r is set (by the reader),
+       * so writing the log does not pay for the initial scan.
+       *
+       * Concurrent updates are serialized by an exclusive \c flock on
+       * the log file. A new index is written aside and renamed into
+       * place, so readers never see it truncated.
+       */
+      static void update( const Pathname & log_r, bool create_r = false );
+
+    public:
+      /** Load the index of \a log_r (empty if there is no valid index).
+       * If \a package_r is not empty, just the positions of this package
+       * are loaded.
+       */
+      HistoryLogIndex( const MappedHistoryLog & log_r, const Pathname & logfile_r, std::string_view package_r = std::string_view() );
+
+      /** Whether a valid index was loaded. */
+      bool valid() const
+      { return _valid; }
+
+      /** The log is indexed up to here (the first line not indexed). */
+      const Position & indexedEnd() const
+      { return _indexedEnd; }
+
+      /** Where to start scanning for lines newer than \a date_r. */
+      Position positionBefore( const Date & date_r ) const;
+
+      /** The indexed lines mentioning package \a name_r. */
+      const std::vector<Position> & positionsFor( const std::string & name_r ) const;
+
+    public:
+      /** Package name mentioned in \a line_r or empty. */
+      static std::string_view packageName( std::string_view line_r );
+
+      /** Date of \a line_r (\c 0 if not parsable). */
+      static Date lineDate( std::string_view line_r );
+
+    private:
+      bool _valid = false;
+      Position _indexedEnd;
+      std::vector<std::pair<Position,Date::ValueType>> _dates;	///< sorted by offset
+      std::unordered_map<std::string,std::vector<Position>> _packages;
+    };
+
+  } // namespace parser
+  ///////////////////////////////////////////////////////////////////
+} // namespace zypp
+///////////////////////////////////////////////////////////////////
+#endif // ZYPP_PARSER_PRIVATE_HISTORYLOGINDEX_P_H
@@ -147,6 +147,25 @@ namespace zypp
       XmlString getValue() const
       { return XmlString( xmlTextReaderValue( _reader ), XmlString::FREE ); }
 
+    public:
+      /** \name Views not allocating a \ref XmlString.
+       * Valid until the \ref Reader advances to the next node.
+       */
+      //@{
+      /** \ref localName as \c std::string_view. */
+      std::string_view localNameView() const
+      { return XmlString::view( xmlTextReaderConstLocalName( _reader ) ); }
+
+      /** \ref name as \c std::string_view. */
+      std::string_view nameView() const
+      { return XmlString::view( xmlTextReaderConstName( _reader ) ); }
+
+      /** \ref value as \c std::string_view. */
+      std::string_view valueView() const
+      { return XmlString::view( xmlTextReaderConstValue( _reader ) ); }
+      //@}
+
+    public:
       /** The xml:lang scope within which the node resides. */
       XmlString xmlLang() const
       { return xmlTextReaderConstXmlLang( _reader ); }
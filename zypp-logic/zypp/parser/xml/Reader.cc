@@ -11,13 +11,19 @@
 */
 #include <libxml/xmlreader.h>
 #include <libxml/xmlerror.h>
+#include <sys/mman.h>
+#include <fcntl.h>
+#include <unistd.h>
 
+#include <algorithm>
+#include <cstring>
 #include <iostream>
 
 #include <zypp-core/base/LogControl.h>
 #include <zypp-core/base/LogTools.h>
 #include <zypp-core/base/Exception.h>
 #include <zypp-core/base/String.h>
+#include <zypp-core/fs/PathInfo.h>
 
 #include <zypp/parser/xml/Reader.h>
 
@@ -48,6 +54,76 @@ namespace zypp
       int ioclose( void * /*context_r*/ )
       { return 0; }
 
+      /** An uncompressed input file mapped into memory, so libxml reads it
+       * without going through the stream. Owned by the libxml reader, which
+       * calls \ref iocloseMapped when it is freed (or can't be created).
+       */
+      struct MappedInput
+      {
+        MappedInput( const char * data_r, size_t size_r )
+        : _data( data_r ), _size( size_r )
+        {}
+
+        ~MappedInput()
+        { ::munmap( const_cast<char *>(_data), _size ); }
+
+        const char * _data;
+        size_t _size;
+        size_t _pos = 0;
+      };
+
+      int ioreadMapped( void * context_r, char * buffer_r, int bufferLen_r )
+      {
+        if ( context_r && buffer_r && bufferLen_r >= 0 )
+          {
+            MappedInput & in( *reinterpret_cast<MappedInput *>(context_r) );
+            size_t len = std::min( in._size - in._pos, size_t(bufferLen_r) );
+            ::memcpy( buffer_r, in._data + in._pos, len );
+            in._pos += len;
+            return len;
+          }
+        INT << "XML parser error: null pointer check failed " << context_r << ' ' << static_cast<void *>(buffer_r) << endl;
+        return -1;
+      }
+
+      int iocloseMapped( void * context_r )
+      {
+        delete reinterpret_cast<MappedInput *>(context_r);
+        return 0;
+      }
+
+      /** Map an uncompressed input file into memory, or return \c nullptr to use the stream. */
+      MappedInput * mmapInput( const InputStream & stream_r )
+      {
+        if ( stream_r.path().empty() || filesystem::zipType( stream_r.path() ) != filesystem::ZT_NONE )
+          return nullptr;
+
+        PathInfo pi( stream_r.path() );
+        if ( ! pi.isFile() || pi.size() == 0 )
+          return nullptr;
+
+        int fd = ::open( pi.path().c_str(), O_RDONLY|O_CLOEXEC );
+        if ( fd == -1 )
+          return nullptr;
+        void * addr = ::mmap( nullptr, pi.size(), PROT_READ, MAP_PRIVATE, fd, 0 );
+        ::close( fd );
+        if ( addr == MAP_FAILED )
+          return nullptr;
+
+        ::madvise( addr, pi.size(), MADV_SEQUENTIAL );
+        DBG << "Parsing mmaped " << pi.path() << endl;
+        return new MappedInput( static_cast<const char *>(addr), pi.size() );
+      }
+
+      xmlTextReaderPtr readerFor( InputStream & stream_r )
+      {
+        MappedInput * mapped = mmapInput( stream_r );
+        if ( mapped )
+          return xmlReaderForIO( ioreadMapped, iocloseMapped, mapped,
+                                 stream_r.path().asString().c_str(), "utf-8", XML_PARSE_PEDANTIC );
+        return xmlReaderForIO( ioread, ioclose, &stream_r,
+                               stream_r.path().asString().c_str(), "utf-8", XML_PARSE_PEDANTIC );
+      }
 
       std::list<std::string> structuredErrors;
 #if LIBXML_VERSION >= 21200
@@ -88,21 +164,30 @@ namespace zypp
     Reader::Reader( const InputStream & stream_r,
                     const Validate & validate_r )
     : _stream( stream_r )
-    , _reader( xmlReaderForIO( ioread, ioclose, &_stream,
-                               stream_r.path().asString().c_str(), "utf-8", XML_PARSE_PEDANTIC ) )
+    , _reader( readerFor( _stream ) )
     , _node( _reader )
     {
       MIL << "Start Parsing " << _stream << endl;
-      if ( ! _reader || stream_r.stream().bad() )
-        ZYPP_THROW( Exception( "Bad input stream" ) );
-      // set error handler
-      // TODO: Fix using a global lastStructuredError string is not reentrant.
-      structuredErrors.clear();
-      xmlTextReaderSetStructuredErrorHandler( _reader, structuredErrorFunc, NULL );
-      // TODO: set validation
-
-      // advance to 1st node
-      nextNode();
+      try
+      {
+        if ( ! _reader || stream_r.stream().bad() )
+          ZYPP_THROW( Exception( "Bad input stream" ) );
+        // set error handler
+        // TODO: Fix using a global lastStructuredError string is not reentrant.
+        structuredErrors.clear();
+        xmlTextReaderSetStructuredErrorHandler( _reader, structuredErrorFunc, NULL );
+        // TODO: set validation
+
+        // advance to 1st node
+        nextNode();
+      }
+      catch ( ... )
+      {
+        // the dtor is not called; this also releases a mapped input file
+        if ( _reader )
+          xmlFreeTextReader( _reader );
+        throw;
+      }
     }
 
     ///////////////////////////////////////////////////////////////////
@@ -134,6 +219,21 @@ namespace zypp
       return XmlString();
     }
 
+    std::string_view Reader::nodeTextView()
+    {
+      if ( ! _node.isEmptyElement() )
+      {
+        if ( nextNode() )
+        {
+          if ( _node.nodeType() == XML_READER_TYPE_TEXT )
+          {
+            return _node.valueView();
+          }
+        }
+      }
+      return std::string_view();
+    }
+
     ///////////////////////////////////////////////////////////////////
     //
     //	METHOD NAME : Reader::nextNode
@@ -173,6 +273,21 @@ namespace zypp
       return false;
     }
 
+    ///////////////////////////////////////////////////////////////////
+    //
+    //	METHOD NAME : Reader::moveToElement
+    //	METHOD TYPE : bool
+    //
+    bool Reader::moveToElement()
+    {
+      int ret = xmlTextReaderMoveToElement( _reader );
+      if ( ret == -1 )
+        {
+          ZYPP_THROW( ParseException() );
+        }
+      return( ret == 1 );
+    }
+
     ///////////////////////////////////////////////////////////////////
     //
     //	METHOD NAME : Reader::close
@@ -229,6 +344,42 @@ namespace zypp
       return ! atEnd();
     }
 
+    ///////////////////////////////////////////////////////////////////
+    //
+    //	CLASS NAME : NodeAttributes
+    //
+    ///////////////////////////////////////////////////////////////////
+
+    bool NodeAttributes::collect( Reader & reader_r )
+    {
+      _size = 0;
+      if ( reader_r->nodeType() != XML_READER_TYPE_ELEMENT && ! reader_r->isAttribute() )
+        return false;
+
+      reader_r.moveToElement();
+      while ( reader_r.nextNodeAttribute() )
+      {
+        if ( _size == _attr.size() )
+          _attr.emplace_back();
+        // assign reuses the strings capacity
+        _attr[_size].first.assign( reader_r->nameView() );
+        _attr[_size].second.assign( reader_r->valueView() );
+        ++_size;
+      }
+      reader_r.moveToElement();
+      return _size;
+    }
+
+    const std::string * NodeAttributes::find( std::string_view name_r ) const
+    {
+      for ( unsigned i = 0; i < _size; ++i )
+      {
+        if ( _attr[i].first == name_r )
+          return &_attr[i].second;
+      }
+      return nullptr;
+    }
+
     /////////////////////////////////////////////////////////////////
   } // namespace xml
   ///////////////////////////////////////////////////////////////////
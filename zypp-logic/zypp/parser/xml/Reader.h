@@ -13,6 +13,10 @@
 #define ZYPP_PARSER_XML_READER_H
 
 #include <iosfwd>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
 
 #include <zypp-core/base/NonCopyable.h>
 #include <zypp-core/base/InputStream>
@@ -114,12 +118,19 @@ namespace zypp
        */
       XmlString nodeText();
 
+      /** \ref nodeText as \c std::string_view (no copy).
+       * Valid until the reader advances to the next node.
+       */
+      std::string_view nodeTextView();
+
       /** */
       bool nextNode();
 
       /** */
       bool nextNodeAttribute();
 
+      /** Move from an attribute back to its element. */
+      bool moveToElement();
       /** */
       bool nextNodeOrAttribute()
       { return( nextNodeAttribute() || nextNode() ); }
@@ -194,6 +205,54 @@ namespace zypp
     };
     ///////////////////////////////////////////////////////////////////
 
+    ///////////////////////////////////////////////////////////////////
+    /// \class NodeAttributes
+    /// \brief The attributes of an element node, collected in one pass.
+    ///
+    /// Looking up many attributes via \ref Node::getAttribute allocates
+    /// a copy of each value. A \ref NodeAttributes is meant to be reused
+    /// for all nodes of a document, so after a few nodes collecting the
+    /// attributes of the next one does not allocate memory.
+    ///
+    /// \code
+    ///   xml::NodeAttributes attrs;
+    ///   // for each element node:
+    ///   attrs.collect( reader_r );
+    ///   std::string_view alias { attrs.get( "alias" ) };
+    /// \endcode
+    ///////////////////////////////////////////////////////////////////
+    class ZYPP_API NodeAttributes
+    {
+    public:
+      /** Collect the attributes of \a reader_r's current element.
+       * \returns Whether there are any.
+       */
+      bool collect( Reader & reader_r );
+
+      /** Number of attributes collected. */
+      unsigned size() const
+      { return _size; }
+
+      /** Value of attribute \a name_r or \c nullptr if not present. */
+      const std::string * find( std::string_view name_r ) const;
+
+      /** Value of attribute \a name_r (empty if not present). */
+      std::string_view get( std::string_view name_r ) const
+      {
+        const std::string * ret { find( name_r ) };
+        return ret ? std::string_view( *ret ) : std::string_view();
+      }
+
+      /** Name and value of the \a idx_r-th attribute. */
+      const std::pair<std::string,std::string> & operator[]( unsigned idx_r ) const
+      { return _attr[idx_r]; }
+
+    private:
+      std::vector<std::pair<std::string,std::string>> _attr;	///< name, value (capacity reused)
+      unsigned _size = 0;
+    };
+    ///////////////////////////////////////////////////////////////////
+
     /////////////////////////////////////////////////////////////////
   } // namespace xml
   ///////////////////////////////////////////////////////////////////
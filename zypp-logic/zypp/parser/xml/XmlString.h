@@ -14,6 +14,7 @@
 
 #include <iosfwd>
 #include <string>
+#include <string_view>
 
 #include <zypp-core/base/PtrTypes.h>
 
@@ -81,23 +82,35 @@ namespace zypp
         return c_str();
       }
 
+      /** Explicit conversion to <tt>std::string_view</tt> (no copy). */
+      std::string_view asStringView() const
+      { return view( get() ); }
+
+      /** View of an <tt>xmlChar *</tt> (\c NULL is empty). */
+      static std::string_view view( const xmlChar * xmlstr_r )
+      {
+        if ( ! xmlstr_r )
+          return std::string_view();
+        return reinterpret_cast<const char *>(xmlstr_r);
+      }
+
       bool operator==( const std::string & rhs ) const
-      { return( rhs == c_str() ); }
+      { return( asStringView() == rhs ); }
 
       bool operator!=( const std::string & rhs ) const
-      { return( rhs != c_str() ); }
+      { return( asStringView() != rhs ); }
 
       bool operator==( const char *const rhs ) const
-      { return( asString() == rhs ); }
+      { return( asStringView() == rhs ); }
 
       bool operator!=( const char *const rhs ) const
-      { return( asString() != rhs ); }
+      { return( asStringView() != rhs ); }
 
       bool operator==( const XmlString & rhs ) const
-      { return( asString() == rhs.c_str() ); }
+      { return( asStringView() == rhs.asStringView() ); }
 
       bool operator!=( const XmlString & rhs ) const
-      { return( asString() != rhs.c_str() ); }
+      { return( asStringView() != rhs.asStringView() ); }
 
     private:
       /** Wraps the <tt>xmlChar *</tt>.
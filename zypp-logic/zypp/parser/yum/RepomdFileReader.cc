@@ -71,7 +71,7 @@ namespace zypp
 
     /** Retrieve a size node. */
     ByteCount getSize( Reader & reader_r )
-    { return ByteCount( str::strtonum<ByteCount::SizeType>( reader_r.nodeText().asString() ) ); }
+    { return ByteCount( str::strtonum<ByteCount::SizeType>( reader_r.nodeTextView() ) ); }
 
 
   private:
@@ -104,20 +104,20 @@ namespace zypp
     if ( reader_r->nodeType() == XML_READER_TYPE_ELEMENT )
     {
       // xpath: /repomd
-      if ( reader_r->name() == "repomd" )
+      if ( reader_r->nameView() == "repomd" )
       {
         return true;
       }
 
       // xpath: /repomd/data (+)
-      if ( reader_r->name() == "data" )
+      if ( reader_r->nameView() == "data" )
       {
         _typeStr = reader_r->getAttribute("type").asString();
         return true;
       }
 
       // xpath: /repomd/location
-      if ( reader_r->name() == "location" )
+      if ( reader_r->nameView() == "location" )
       {
         _location.setLocation( reader_r->getAttribute("href").asString(), 1 );
         // ignoring attribute xml:base
@@ -125,42 +125,42 @@ namespace zypp
       }
 
       // xpath: /repomd/checksum
-      if ( reader_r->name() == "checksum" )
+      if ( reader_r->nameView() == "checksum" )
       {
         _location.setChecksum( getChecksum( reader_r ) );
         return true;
       }
 
       // xpath: /repomd/header-checksum
-      if ( reader_r->name() == "header-checksum" )
+      if ( reader_r->nameView() == "header-checksum" )
       {
         _location.setHeaderChecksum( getChecksum( reader_r ) );
         return true;
       }
 
       // xpath: /repomd/timestamp
-      if ( reader_r->name() == "timestamp" )
+      if ( reader_r->nameView() == "timestamp" )
       {
         // ignore it
         return true;
       }
 
       // xpath: /repomd/size
-      if ( reader_r->name() == "size" )
+      if ( reader_r->nameView() == "size" )
       {
         _location.setDownloadSize( getSize( reader_r ) );
         return true;
       }
 
       // xpath: /repomd/header-size
-      if ( reader_r->name() == "header-size" )
+      if ( reader_r->nameView() == "header-size" )
       {
         _location.setHeaderSize( getSize( reader_r ) );
         return true;
       }
 
       // xpath: /tags/content
-      if ( reader_r->name() == "content" )
+      if ( reader_r->nameView() == "content" )
       {
         const auto & tag = reader_r.nodeText();
         if ( tag.c_str() && *tag.c_str() )
@@ -172,7 +172,7 @@ namespace zypp
     else if ( reader_r->nodeType() == XML_READER_TYPE_END_ELEMENT )
     {
       // xpath: /repomd/data
-      if ( reader_r->name() == "data" )
+      if ( reader_r->nameView() == "data" )
       {
         if (_callback) {
           _callback( std::move(_location), _typeStr );
@@ -10,10 +10,11 @@
  *
 */
 #include <iostream>
+#include <mutex>
+#include <string_view>
 
 #include <zypp-core/base/Logger.h>
 #include <zypp-core/base/String.h>
-#include <zypp-core/base/Regex.h>
 #include <zypp/repo/Applydeltarpm.h>
 #include <zypp-core/ExternalProgram.h>
 #include <zypp-core/AutoDispose.h>
@@ -33,7 +34,28 @@ namespace zypp
     { /////////////////////////////////////////////////////////////////
 
       const Pathname   applydeltarpm_prog( "/usr/bin/applydeltarpm" );
-      const str::regex applydeltarpm_tick ( "([0-9]+) percent finished" );
+
+      /** Parse a \c "NN percent finished" progress line.
+       * Returns \c false if \a line_r is not a progress line. Called for
+       * each line of output, so we avoid the regex engine here.
+       */
+      inline bool parseTick( std::string_view line_r, unsigned & percent_r )
+      {
+        static constexpr std::string_view tick { " percent finished" };
+        std::string_view::size_type pos = line_r.find( tick );
+        if ( pos == 0 || pos == std::string_view::npos )
+          return false;
+
+        unsigned val = 0;
+        for ( char ch : line_r.substr( 0, pos ) )
+        {
+          if ( ch < '0' || ch > '9' )
+            return false;
+          val = val * 10 + ( ch - '0' );
+        }
+        percent_r = val;
+        return true;
+      }
 
       /******************************************************************
        **
@@ -44,12 +66,15 @@ namespace zypp
                           const Progress & report_r  = Progress() )
       {
         ExternalProgram prog( argv_r, ExternalProgram::Stderr_To_Stdout );
-        str::smatch what;
+        unsigned last = unsigned(-1);
         for ( std::string line = prog.receiveLine(); ! line.empty(); line = prog.receiveLine() )
           {
-            if ( report_r && str::regex_match( line, what, applydeltarpm_tick ) )
+            unsigned percent = 0;
+            if ( parseTick( line, percent ) )
               {
-                report_r( str::strtonum<unsigned>( what[1] ) );
+                if ( report_r && percent != last )	// report changes only
+                  report_r( percent );
+                last = percent;
               }
             else
               DBG << "Applydeltarpm : " << line;
@@ -69,7 +94,10 @@ namespace zypp
     bool haveApplydeltarpm()
     {
       // To track changes in availability of applydeltarpm.
+      // Guarded as provide() may be called from DeltaRebuildPool workers.
+      static std::mutex _mutex;
       static TriBool _last = indeterminate;
+      std::lock_guard<std::mutex> guard( _mutex );
       PathInfo prog( applydeltarpm_prog );
       bool have = prog.isX();
       if ( _last == have )
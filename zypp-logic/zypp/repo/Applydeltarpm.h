@@ -57,7 +57,7 @@ namespace zypp
      * \see <tt>man applydeltarpm</tt>
     */
     //@{
-    /** progress reporting */
+    /** progress reporting (percent, reported on change only) */
     using Progress = function<void (unsigned int)>;
 
     /** Apply a binary delta to on-disk data to re-create a new rpm.
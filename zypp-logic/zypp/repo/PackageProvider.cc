@@ -21,6 +21,7 @@
 #include <zypp/repo/PackageProvider.h>
 #include <zypp/repo/Applydeltarpm.h>
 #include <zypp/repo/PackageDelta.h>
+#include <zypp/repo/private/deltarebuildpool_p.h>
 
 #include <zypp/TmpPath.h>
 #include <zypp/ZConfig.h>
@@ -436,6 +437,13 @@ namespace zypp
           {
             ret = doProvidePackage();
           }
+        catch ( const DeltaRebuildDeferredException & excpt )
+          {
+            // not an error: the caller will ask again once the rpm is rebuilt
+            MIL << "Deferred Package " << _package << " (deltarpm rebuild)" << endl;
+            report()->finish( _package, repo::DownloadResolvableReport::NO_ERROR, std::string() );
+            ZYPP_RETHROW( excpt );
+          }
         catch ( const UserRequestException & excpt )
           {
             ERR << "Failed to provide Package " << _package << endl;
@@ -550,6 +558,15 @@ namespace zypp
 
       ManagedFile tryDelta( const DeltaRpm & delta_r ) const;
 
+      /** Sigcheck the rpm rebuilt at \a builddest_r and move it into the cache. */
+      ManagedFile finishDelta( const Pathname & builddest_r, const Pathname & cachedest_r ) const;
+
+      Pathname cachedest() const
+      { return _package->repoInfo().packagesPath() / _package->repoInfo().path() / _package->location().filename(); }
+
+      Pathname builddest() const
+      { return cachedest().extend( ".drpm" ); }
+
       bool progressDeltaDownload( int value ) const
       { return report()->progressDeltaDownload( value ); }
 
@@ -571,6 +588,25 @@ namespace zypp
       if ( ZConfig::instance().download_use_deltarpm()
         && ( _package->repoInfo().url().schemeIsDownloading() || ZConfig::instance().download_use_deltarpm_always() ) )
       {
+        // A rebuild queued in the DeltaRebuildPool is claimed here.
+        DeltaRebuildPool * pool = DeltaRebuildPool::active();
+        if ( pool && pool->state( builddest() ) != DeltaRebuildPool::NONE )
+        {
+          DeltaRebuildPool::State state = pool->wait( builddest() );
+          const Pathname & delta { pool->delta( builddest() ) };
+          pool->release( builddest() );
+
+          report()->startDeltaApply( delta );
+          if ( state == DeltaRebuildPool::DONE )
+          {
+            progressDeltaApply( 100 );
+            return finishDelta( builddest(), cachedest() );
+          }
+          report()->problemDeltaApply( _("applydeltarpm failed.") );
+          // fallback: provide full package
+          return Base::doProvidePackage();
+        }
+
         std::list<DeltaRpm> deltaRpms;
         _deltas.deltaRpms( _package ).swap( deltaRpms );
 
@@ -623,7 +659,13 @@ namespace zypp
         }
       report()->finishDeltaDownload();
 
-      report()->startDeltaApply( delta );
+      // With an active DeltaRebuildPool the rpm is built in the background.
+      // startDeltaApply is then reported when the result is claimed.
+      DeltaRebuildPool * pool = DeltaRebuildPool::active();
+      if ( ! pool )
+        report()->startDeltaApply( delta );
+
+      // Detect modified installed files before spending time on the rebuild.
       if ( ! applydeltarpm::check( delta_r.baseversion().sequenceinfo() ) )
         {
           report()->problemDeltaApply( _("applydeltarpm check failed.") );
@@ -631,27 +673,35 @@ namespace zypp
         }
 
       // Build the package
-      Pathname cachedest( _package->repoInfo().packagesPath() / _package->repoInfo().path() / _package->location().filename() );
-      Pathname builddest( cachedest.extend( ".drpm" ) );
+      if ( pool )
+        {
+          pool->enqueue( delta, builddest() );
+          ZYPP_THROW( DeltaRebuildDeferredException( builddest() ) );
+        }
 
-      if ( ! applydeltarpm::provide( delta, builddest,
+      if ( ! applydeltarpm::provide( delta, builddest(),
                                      bind( &RpmPackageProvider::progressDeltaApply, this, _1 ) ) )
         {
           report()->problemDeltaApply( _("applydeltarpm failed.") );
           return ManagedFile();
         }
-      ManagedFile builddestCleanup( builddest, filesystem::unlink );
+      return finishDelta( builddest(), cachedest() );
+    }
+
+    ManagedFile RpmPackageProvider::finishDelta( const Pathname & builddest_r, const Pathname & cachedest_r ) const
+    {
+      ManagedFile builddestCleanup( builddest_r, filesystem::unlink );
       report()->finishDeltaApply();
 
       // Check and move it into the cache
       // Here the rpm itself is ready. If the packages sigcheck fails, it
       // makes no sense to return a ManagedFile() and fallback to download the
       // full rpm. It won't be different. So let the exceptions escape...
-      rpmSigFileChecker( builddest );
-      if ( filesystem::hardlinkCopy( builddest, cachedest ) != 0 )
-        ZYPP_THROW( Exception( str::Str() << "Can't hardlink/copy " << builddest << " to " << cachedest ) );
+      rpmSigFileChecker( builddest_r );
+      if ( filesystem::hardlinkCopy( builddest_r, cachedest_r ) != 0 )
+        ZYPP_THROW( Exception( str::Str() << "Can't hardlink/copy " << builddest_r << " to " << cachedest_r ) );
 
-      return ManagedFile( cachedest, filesystem::unlink );
+      return ManagedFile( cachedest_r, filesystem::unlink );
     }
 
     ///////////////////////////////////////////////////////////////////
@@ -6,8 +6,13 @@
 |                         /_____||_| |_| |_|                           |
 |                                                                      |
 \---------------------------------------------------------------------*/
+#include <sys/stat.h>
+
 #include <iostream>
 #include <fstream>
+#include <mutex>
+#include <optional>
+#include <unordered_map>
 
 #include <zypp-core/base/LogTools.h>
 #include <zypp-core/base/String.h>
@@ -389,6 +394,98 @@ namespace zypp
     ///////////////////////////////////////////////////////////////////
     namespace
     {
+      /** Serializes all access to the \ref RepoVarsMap and the \ref ExpandedCache. */
+      std::recursive_mutex & varsMutex()
+      { static std::recursive_mutex _mutex; return _mutex; }
+
+      ///////////////////////////////////////////////////////////////////
+      /// \class DistributionVersion
+      /// \brief Target::distributionVersion, evaluated again only if the baseproduct changed.
+      ///
+      /// The releasever follows the target (bnc#943563), so it is checked on
+      /// each lookup. Reading the baseproduct each time is too expensive.
+      /// If there is no baseproduct (e.g. on RedHat derivatives the version
+      /// is taken from the rpm database) nothing is remembered.
+      ///////////////////////////////////////////////////////////////////
+      class DistributionVersion
+      {
+      public:
+        const std::string & get( const Pathname & root_r )
+        {
+          Fingerprint fp { root_r };
+          if ( !fp || !( fp == _fingerprint ) || root_r != _root )
+          {
+            _value = Target::distributionVersion( root_r );
+            _fingerprint = fp;
+            _root = root_r;
+          }
+          return _value;
+        }
+
+      private:
+        /** The baseproduct link and the product file it points to. */
+        struct Fingerprint
+        {
+          Fingerprint()
+          {}
+
+          Fingerprint( const Pathname & root_r )
+          {
+            if ( root_r.empty() )
+              return;	// Target will guess the root
+            const Pathname baseproduct { root_r / "etc/products.d/baseproduct" };
+            struct ::stat st;
+            if ( ::lstat( baseproduct.c_str(), &st ) != 0 )
+              return;
+            _link = Stat( st );
+            if ( ::stat( baseproduct.c_str(), &st ) != 0 )
+              return;
+            _file = Stat( st );
+            _valid = true;
+          }
+
+          explicit operator bool() const
+          { return _valid; }
+
+          bool operator==( const Fingerprint & rhs ) const
+          { return _valid == rhs._valid && _link == rhs._link && _file == rhs._file; }
+
+        private:
+          /** The stat data telling whether a file was replaced or modified. */
+          struct Stat
+          {
+            Stat()
+            {}
+
+            Stat( const struct ::stat & st_r )
+            : _dev { st_r.st_dev }
+            , _ino { st_r.st_ino }
+            , _size { st_r.st_size }
+            , _mtim { st_r.st_mtim }
+            {}
+
+            bool operator==( const Stat & rhs ) const
+            {
+              return _dev == rhs._dev && _ino == rhs._ino && _size == rhs._size
+                  && _mtim.tv_sec == rhs._mtim.tv_sec && _mtim.tv_nsec == rhs._mtim.tv_nsec;
+            }
+
+            dev_t _dev = 0;
+            ino_t _ino = 0;
+            off_t _size = 0;
+            struct ::timespec _mtim = {};
+          };
+
+          bool _valid = false;
+          Stat _link;
+          Stat _file;
+        };
+
+        Pathname _root;
+        Fingerprint _fingerprint;
+        std::string _value;
+      };
+
       class RepoVarsMap : public std::map<std::string,std::string>
       {
       public:
@@ -398,6 +495,25 @@ namespace zypp
         static const std::string * lookup( const std::string & name_r )
         { return instance()._lookup( name_r ); }
 
+        /** Changes whenever a variable may have changed its value.
+         * Lookups done in the same generation return the same values.
+         */
+        static unsigned generation()
+        {
+          RepoVarsMap & self { instance() };
+          auto guard { getZYpp() };	// see _lookup
+          // A changing releasever{,_major,_minor} bumps the generation.
+          self.checkOverride( "releasever", self.assertLoaded() );
+          return self._generation;
+        }
+
+        /** Forget all values (they are loaded again on demand). */
+        void reset()
+        {
+          clear();
+          ++_generation;
+        }
+
       private:
         const std::string * _lookup( const std::string & name_r )
         {
@@ -406,6 +522,23 @@ namespace zypp
           // would clear the variables parsed so far.
           auto guard { getZYpp() };
 
+          const Pathname & contextRoot { assertLoaded() };
+
+          const std::string * ret = checkOverride( name_r, contextRoot );
+          if ( !ret )
+          {
+            // get value from map
+            iterator it = find( name_r );
+            if ( it != end() )
+              ret = &(it->second);
+          }
+
+          return ret;
+        }
+
+        /** Load the variables if necessary and return the context root. */
+        const Pathname & assertLoaded()
+        {
           // bsc#1237044: The context in which the variables are to be evaluated.
           // TODO: In fact we should have a RepoVarsMap per context, no singleton.
           // The code here reflects the weakness of the classic ZConfig singleton.
@@ -416,7 +549,7 @@ namespace zypp
           if ( contextRoot != _contextRoot ) {
             MIL << "RepoVars context changed from " << _contextRoot << " -> " << contextRoot << endl;
             _contextRoot = contextRoot;
-            clear();
+            reset();
           }
 
           if ( empty() )	// at init / after reset
@@ -442,17 +575,7 @@ namespace zypp
               }
             }
           }
-
-          const std::string * ret = checkOverride( name_r, contextRoot );
-          if ( !ret )
-          {
-            // get value from map
-            iterator it = find( name_r );
-            if ( it != end() )
-              ret = &(it->second);
-          }
-
-          return ret;
+          return _contextRoot;
         }
 
         std::ostream & dumpOn( std::ostream & str ) const
@@ -526,18 +649,20 @@ namespace zypp
               {
                 operator[]( "$releasever" ) = std::move(val);
                 deriveFromReleasever( "$releasever", /*overwrite previous values*/true );
+                ++_generation;
               }
               return &operator[]( "$"+name_r );
             }
             else if ( !count( name_r ) )
             {
               // No user defined value, so we follow the target
-              val = Target::distributionVersion( contextRoot_r );
+              val = _distributionVersion.get( contextRoot_r );
 
               if ( val != operator[]( "$_releasever" ) )
               {
                 operator[]( "$_releasever" ) = std::move(val);
                 deriveFromReleasever( "$_releasever", /*overwrite previous values*/true );
+                ++_generation;
               }
               return &operator[]( "$_"+name_r );
             }
@@ -551,17 +676,62 @@ namespace zypp
 
       private:
         Pathname _contextRoot;
+        DistributionVersion _distributionVersion;
+        unsigned _generation = 0;
+      };
+
+      ///////////////////////////////////////////////////////////////////
+      /// \class ExpandedCache
+      /// \brief Remember expanded values while the \ref RepoVarsMap::generation does not change.
+      ///////////////////////////////////////////////////////////////////
+      template <class TValue>
+      class ExpandedCache
+      {
+      public:
+        /** The remembered value for \a raw_r or \c nullptr. */
+        const TValue * find( const std::string & raw_r, unsigned generation_r )
+        {
+          if ( generation_r != _generation )
+          {
+            _values.clear();
+            _generation = generation_r;
+            return nullptr;
+          }
+          auto it = _values.find( raw_r );
+          return it == _values.end() ? nullptr : &it->second;
+        }
+
+        const TValue & remember( const std::string & raw_r, TValue value_r )
+        {
+          if ( _values.size() >= _maxSize )
+            _values.clear();	// don't grow without limit
+          return _values[raw_r] = std::move(value_r);
+        }
+
+      private:
+        static constexpr unsigned _maxSize = 4096;
+        std::unordered_map<std::string,TValue> _values;
+        unsigned _generation = 0;
       };
     } // namespace
     ///////////////////////////////////////////////////////////////////
 
     std::string RepoVariablesStringReplacer::operator()( const std::string & value ) const
     {
-      return RepoVarExpand()( value, RepoVarsMap::lookup );
+      if ( value.find( '$' ) == std::string::npos )
+        return value;	// nothing to expand
+
+      std::lock_guard<std::recursive_mutex> lk( varsMutex() );
+      static ExpandedCache<std::string> _cache;
+      if ( const std::string * cached = _cache.find( value, RepoVarsMap::generation() ) )
+        return *cached;
+      return _cache.remember( value, RepoVarExpand()( value, RepoVarsMap::lookup ) );
     }
     std::string RepoVariablesStringReplacer::operator()( std::string && value ) const
     {
-      return RepoVarExpand()( std::move(value), RepoVarsMap::lookup );
+      if ( value.find( '$' ) == std::string::npos )
+        return std::move(value);	// nothing to expand
+      return operator()( static_cast<const std::string &>(value) );
     }
 
     Url RepoVariablesUrlReplacer::operator()( const Url & value ) const
@@ -572,12 +742,27 @@ namespace zypp
       // out side the url in a cedential file.
       Url tmpurl { value };
       tmpurl.setViewOptions( toReplace );
-      const std::string & replaced( RepoVarExpand()( hotfix1050625::asString( tmpurl ), RepoVarsMap::lookup ) );
+      const std::string & raw { hotfix1050625::asString( tmpurl ) };
+
+      // Remember the Url parsed from the replaced string; parsing is expensive.
+      // (std::nullopt if the replaced string is empty)
+      std::optional<Url> replacedUrl;
+      {
+        std::lock_guard<std::recursive_mutex> lk( varsMutex() );
+        static ExpandedCache<std::optional<Url>> _cache;
+        const std::optional<Url> * cached = _cache.find( raw, RepoVarsMap::generation() );
+        if ( ! cached )
+        {
+          const std::string & replaced( RepoVarExpand()( raw, RepoVarsMap::lookup ) );
+          cached = &_cache.remember( raw, replaced.empty() ? std::optional<Url>() : std::optional<Url>( Url( replaced ) ) );
+        }
+        replacedUrl = *cached;
+      }
 
       Url newurl;
-      if ( !replaced.empty() )
+      if ( replacedUrl )
       {
-        newurl = replaced;
+        newurl = *replacedUrl;
         newurl.setUsername( value.getUsername( url::E_ENCODED ), url::E_ENCODED );
         newurl.setPassword( value.getPassword( url::E_ENCODED ), url::E_ENCODED );
         newurl.setViewOptions( value.getViewOptions() );
@@ -594,7 +779,10 @@ namespace zyppintern
   using namespace zypp;
   // internal helper called when re-acquiring the lock
   void repoVariablesReset()
-  { repo::RepoVarsMap::instance().clear(); }
+  {
+    std::lock_guard<std::recursive_mutex> lk( repo::varsMutex() );
+    repo::RepoVarsMap::instance().reset();
+  }
 
 } // namespace zyppintern
 ///////////////////////////////////////////////////////////////////
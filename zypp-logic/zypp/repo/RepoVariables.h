@@ -100,6 +100,9 @@ namespace zypp
      * http://site.net/?basearch=$basearch -> http://site.net/?basearch=i386
      * \endcode
      *
+     * \note Expanded values are remembered as long as the variables
+     * do not change, so repeated calls with the same string are cheap.
+     *
      * \see \ref RepoVarExpand for supported variable syntax.
      */
     struct ZYPP_API RepoVariablesStringReplacer
@@ -0,0 +1,171 @@
+/*---------------------------------------------------------------------\
+|                          ____ _   __ __ ___                          |
+|                         |__  / \ / / . \ . \                         |
+|                           / / \ V /|  _/  _/                         |
+|                          / /__ | | | | | |                           |
+|                         /_____||_| |_| |_|                           |
+|                                                                      |
+\---------------------------------------------------------------------*/
+/** \file	zypp/repo/deltarebuildpool.cc
+ *
+*/
+#include <condition_variable>
+#include <map>
+#include <mutex>
+
+#include <zypp/repo/private/deltarebuildpool_p.h>
+#include <zypp/repo/Applydeltarpm.h>
+#include <zypp-core/base/WorkerPool_p.h>
+#include <zypp-core/base/Logger.h>
+#include <zypp-core/base/String.h>
+#include <zypp/PathInfo.h>
+
+using std::endl;
+
+///////////////////////////////////////////////////////////////////
+namespace zypp
+{
+  ///////////////////////////////////////////////////////////////////
+  namespace repo
+  {
+    namespace
+    {
+      DeltaRebuildPool * _activePool = nullptr;
+
+      unsigned configuredJobs( unsigned maxJobs_r )
+      {
+        if ( maxJobs_r )
+          return maxJobs_r;
+        if ( const char * env = ::getenv( "ZYPP_DELTARPM_JOBS" ) )
+        {
+          unsigned jobs = str::strtonum<unsigned>( env );
+          if ( jobs )
+            return jobs;
+        }
+        return WorkerPool::defaultThreads();
+      }
+    } // namespace
+
+    struct DeltaRebuildPool::Impl
+    {
+      Impl( unsigned maxJobs_r )
+      : _workers( configuredJobs( maxJobs_r ) )
+      {}
+
+      ~Impl()
+      {
+        _workers.waitAll();
+        for ( const auto & el : _jobs )
+        {
+          if ( el.second._state == DONE )
+          {
+            WAR << "Remove unclaimed deltarpm rebuild " << el.first << endl;
+            filesystem::unlink( el.first );
+          }
+        }
+      }
+
+      State state( const Pathname & builddest_r ) const
+      {
+        std::lock_guard<std::mutex> lk( _m );
+        auto it = _jobs.find( builddest_r );
+        return it == _jobs.end() ? NONE : it->second._state;
+      }
+
+      void setState( const Pathname & builddest_r, State state_r )
+      {
+        {
+          std::lock_guard<std::mutex> lk( _m );
+          _jobs[builddest_r]._state = state_r;
+        }
+        _done.notify_all();
+      }
+
+      struct Job
+      {
+        State _state = NONE;
+        Pathname _delta;
+      };
+
+      WorkerPool _workers;
+
+      mutable std::mutex _m;	// < locks _jobs
+      std::condition_variable _done;
+      std::map<Pathname,Job> _jobs;
+    };
+
+    DeltaRebuildPool::DeltaRebuildPool( unsigned maxJobs_r )
+    : _pimpl( new Impl( maxJobs_r ) )
+    {
+      if ( _activePool )
+        INT << "Replacing active DeltaRebuildPool " << _activePool << endl;
+      _activePool = this;
+      MIL << "DeltaRebuildPool: up to " << maxJobs() << " concurrent applydeltarpm jobs." << endl;
+    }
+
+    DeltaRebuildPool::~DeltaRebuildPool()
+    {
+      if ( _activePool == this )
+        _activePool = nullptr;
+    }
+
+    DeltaRebuildPool * DeltaRebuildPool::active()
+    { return _activePool; }
+
+    unsigned DeltaRebuildPool::maxJobs() const
+    { return _pimpl->_workers.maxThreads(); }
+
+    void DeltaRebuildPool::enqueue( ManagedFile delta_r, const Pathname & builddest_r )
+    {
+      DBG << "Queue rebuild of " << builddest_r << " from " << delta_r << endl;
+      {
+        std::lock_guard<std::mutex> lk( _pimpl->_m );
+        _pimpl->_jobs[builddest_r] = Impl::Job{ PENDING, delta_r.value() };
+      }
+
+      Impl & impl { *_pimpl };
+      _pimpl->_workers.enqueue( [&impl, delta = std::move(delta_r), builddest_r]() {
+        // No progress reporting from the worker threads; the
+        // PackageProvider reports 100% when claiming the result.
+        bool ok = applydeltarpm::provide( delta, builddest_r );
+        if ( ! ok )
+          WAR << "applydeltarpm failed for " << builddest_r << endl;
+        impl.setState( builddest_r, ok ? DONE : FAILED );
+      } );
+    }
+
+    DeltaRebuildPool::State DeltaRebuildPool::state( const Pathname & builddest_r ) const
+    { return _pimpl->state( builddest_r ); }
+
+    Pathname DeltaRebuildPool::delta( const Pathname & builddest_r ) const
+    {
+      std::lock_guard<std::mutex> lk( _pimpl->_m );
+      auto it = _pimpl->_jobs.find( builddest_r );
+      return it == _pimpl->_jobs.end() ? Pathname() : it->second._delta;
+    }
+
+    DeltaRebuildPool::State DeltaRebuildPool::wait( const Pathname & builddest_r )
+    {
+      std::unique_lock<std::mutex> lk( _pimpl->_m );
+      State ret = NONE;
+      _pimpl->_done.wait( lk, [&]() {
+        auto it = _pimpl->_jobs.find( builddest_r );
+        ret = ( it == _pimpl->_jobs.end() ? NONE : it->second._state );
+        return ret != PENDING;
+      } );
+      return ret;
+    }
+
+    void DeltaRebuildPool::waitAll()
+    { _pimpl->_workers.waitAll(); }
+
+    void DeltaRebuildPool::release( const Pathname & builddest_r )
+    {
+      std::lock_guard<std::mutex> lk( _pimpl->_m );
+      _pimpl->_jobs.erase( builddest_r );
+    }
+
+  } // namespace repo
+  ///////////////////////////////////////////////////////////////////
+} // namespace zypp
+///////////////////////////////////////////////////////////////////
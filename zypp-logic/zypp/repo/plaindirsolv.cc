@@ -0,0 +1,304 @@
+/*---------------------------------------------------------------------\
+|                          ____ _   __ __ ___                          |
+|                         |__  / \ / / . \ . \                         |
+|                           / / \ V /|  _/  _/                         |
+|                          / /__ | | | | | |                           |
+|                         /_____||_| |_| |_|                           |
+|                                                                      |
+\---------------------------------------------------------------------*/
+/** \file	zypp/repo/plaindirsolv.cc
+ *
+*/
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include <zypp/repo/private/plaindirsolv_p.h>
+#include <zypp-core/AutoDispose.h>
+#include <zypp-core/base/WorkerPool_p.h>
+#include <zypp-core/base/Logger.h>
+#include <zypp-core/base/String.h>
+#include <zypp-core/fs/TmpPath.h>
+#include <zypp/PathInfo.h>
+
+extern "C"
+{
+#include <solv/pool.h>
+#include <solv/repo.h>
+#include <solv/repo_solv.h>
+#include <solv/repo_write.h>
+#include <solv/repo_rpmdb.h>
+#include <solv/repo_autopattern.h>
+#include <solv/solvversion.h>
+}
+
+using std::endl;
+
+#undef  ZYPP_BASE_LOGGER_LOGGROUP
+#define ZYPP_BASE_LOGGER_LOGGROUP "zypp::repo::plaindir"
+
+///////////////////////////////////////////////////////////////////
+namespace zypp
+{
+  ///////////////////////////////////////////////////////////////////
+  namespace repo
+  {
+    namespace
+    {
+      /** An rpm below the plaindir (path relative to it). */
+      struct RpmFile
+      {
+        std::string _path;
+        off_t       _size = 0;
+        time_t      _mtime = 0;
+        std::string _hdrid;	///< from the index
+      };
+
+      using AutoPool = AutoDispose<::Pool *>;
+
+      /** Collect the rpms below \a dir_r like repo2solv does (no dot files, no delta rpms). */
+      void scanRpms( const Pathname & dir_r, const std::string & prefix_r, std::vector<RpmFile> & rpms_r )
+      {
+        filesystem::DirContent content;
+        if ( filesystem::readdir( content, dir_r, /*dots*/false ) != 0 )
+          return; // readdir logged the error
+
+        for ( const auto & entry : content )
+        {
+          if ( entry.type == filesystem::FT_DIR )
+            scanRpms( dir_r/entry.name, prefix_r + entry.name + "/", rpms_r );
+          else if ( entry.type == filesystem::FT_FILE
+                    && str::endsWith( entry.name, ".rpm" )
+                    && ! str::endsWith( entry.name, ".delta.rpm" )
+                    && ! str::endsWith( entry.name, ".patch.rpm" ) )
+          {
+            rpms_r.emplace_back();
+            rpms_r.back()._path = prefix_r + entry.name;
+          }
+        }
+      }
+
+      /** Identifies the solv file the index was written for. */
+      std::string solvKey( const Pathname & solvfile_r )
+      {
+        PathInfo pi( solvfile_r );
+        if ( ! pi.isFile() )
+          return std::string();
+        return ( str::Str() << pi.ino() << ":" << pi.size() << ":" << pi.mtime() << ":" << LIBSOLV_TOOLVERSION ).str();
+      }
+
+      /** Read the index if it belongs to \a solvfile_r (path -> RpmFile). */
+      std::unordered_map<std::string,RpmFile> readIndex( const Pathname & solvfile_r )
+      {
+        std::unordered_map<std::string,RpmFile> ret;
+        std::ifstream in( plaindirSolvIndex( solvfile_r ).c_str() );
+        std::string line;
+        if ( ! std::getline( in, line ) || line.empty() || line != solvKey( solvfile_r ) )
+          return ret;
+
+        while ( std::getline( in, line ) )
+        {
+          // <size> <mtime> <hdrid> <path>
+          std::istringstream str( line );
+          RpmFile rpm;
+          if ( ! ( str >> rpm._size >> rpm._mtime >> rpm._hdrid ) || str.get() != ' ' || ! std::getline( str, rpm._path ) )
+            continue;
+          ret[rpm._path] = std::move(rpm);
+        }
+        return ret;
+      }
+
+      /** Read \a rpms_r into a repo of its own pool (runs in a worker thread).
+       * The solvables are returned as solv file data.
+       */
+      std::string readRpms( const Pathname & dir_r, const std::vector<const RpmFile *> & rpms_r )
+      {
+        AutoPool pool { ::pool_create(), ::pool_free };
+        ::Repo * repo = ::repo_create( pool, "plaindir" );
+        for ( const RpmFile * rpm : rpms_r )
+        {
+          Id p = ::repo_add_rpm( repo, (dir_r/rpm->_path).c_str(), REPO_REUSE_REPODATA|REPO_NO_INTERNALIZE|REPO_NO_LOCATION|RPM_ADD_WITH_HDRID );
+          if ( ! p )
+          {
+            WAR << "Skip " << rpm->_path << ": " << ::pool_errstr( pool ) << endl;
+            continue;
+          }
+          ::repodata_set_location( ::repo_last_repodata( repo ), p, 0, nullptr, rpm->_path.c_str() );
+        }
+        ::repo_internalize( repo );
+
+        char * buf = nullptr;
+        size_t len = 0;
+        FILE * out = ::open_memstream( &buf, &len );
+        if ( ! out )
+          return std::string();
+        bool ok = ( ::repo_write( repo, out ) == 0 );
+        ok = ( ::fclose( out ) == 0 ) && ok;
+        std::string ret;
+        if ( ok )
+          ret.assign( buf, len );
+        ::free( buf );
+        return ret;
+      }
+    } // namespace
+
+    void buildPlaindirSolv( const Pathname & dir_r, const Pathname & solvfile_r, const Pathname & oldsolvfile_r )
+    {
+      MIL << "Build " << solvfile_r << " from " << dir_r << endl;
+      const Pathname & indexfile { plaindirSolvIndex( solvfile_r ) };
+      const Pathname & oldsolvfile { oldsolvfile_r.empty() ? solvfile_r : oldsolvfile_r };
+
+      std::vector<RpmFile> rpms;
+      scanRpms( dir_r, std::string(), rpms );
+      std::sort( rpms.begin(), rpms.end(), []( const RpmFile & lhs, const RpmFile & rhs ) { return lhs._path < rhs._path; } );
+
+      // stat the rpms; worth doing in parallel on NFS
+      {
+        WorkerPool statPool;
+        static constexpr size_t chunk = 256;
+        for ( size_t begin = 0; begin < rpms.size(); begin += chunk )
+          statPool.enqueue( [&,begin]() {
+            for ( size_t i = begin; i < std::min( begin + chunk, rpms.size() ); ++i )
+            {
+              PathInfo pi( dir_r/rpms[i]._path );
+              rpms[i]._size  = pi.size();
+              rpms[i]._mtime = pi.mtime();
+            }
+          } );
+      }
+
+      AutoPool pool { ::pool_create(), ::pool_free };
+      ::Repo * repo = ::repo_create( pool, "plaindir" );
+
+      // Take the unchanged rpms from the old solv file...
+      std::unordered_set<std::string> kept;
+      {
+        std::unordered_map<std::string,const RpmFile *> unchanged;
+        const auto & index { readIndex( oldsolvfile ) };
+        for ( const RpmFile & rpm : rpms )
+        {
+          auto it = index.find( rpm._path );
+          if ( it != index.end() && it->second._size == rpm._size && it->second._mtime == rpm._mtime )
+            unchanged[rpm._path] = &it->second;
+        }
+
+        if ( ! unchanged.empty() )
+        {
+          AutoFILE in { ::fopen( oldsolvfile.c_str(), "re" ) };
+          if ( ! in || ::repo_add_solv( repo, in, 0 ) != 0 )
+          {
+            WAR << "Can't read " << oldsolvfile << ", reading all rpms" << endl;
+            ::repo_empty( repo, /*reuseids*/1 );
+            unchanged.clear();
+          }
+        }
+
+        // ...and drop the rest (changed or removed rpms, autopatterns).
+        std::vector<Id> drop;
+        Id p = 0;
+        ::Solvable * s = nullptr;
+        FOR_REPO_SOLVABLES( repo, p, s )
+        {
+          const char * loc = ::solvable_lookup_location( s, nullptr );
+          auto it = loc ? unchanged.find( loc ) : unchanged.end();
+          const char * hdrid = it != unchanged.end() ? ::solvable_lookup_checksum( s, SOLVABLE_HDRID, nullptr ) : nullptr;
+          if ( hdrid && it->second->_hdrid == hdrid && kept.insert( loc ).second )
+            continue;
+          drop.push_back( p );
+        }
+        for ( Id d : drop )
+          ::repo_free_solvable( repo, d, /*reuseids*/1 );
+      }
+
+      // Read the new and changed rpms in parallel
+      std::vector<const RpmFile *> toread;
+      for ( const RpmFile & rpm : rpms )
+      {
+        if ( ! kept.count( rpm._path ) )
+          toread.push_back( &rpm );
+      }
+      MIL << rpms.size() << " rpms in " << dir_r << ": " << kept.size() << " unchanged, " << toread.size() << " to read" << endl;
+
+      if ( ! toread.empty() )
+      {
+        unsigned jobs = std::min<size_t>( WorkerPool::defaultThreads(), ( toread.size() + 31 ) / 32 );
+        size_t chunk = ( toread.size() + jobs - 1 ) / jobs;
+        std::vector<std::string> solvdata( jobs );
+        {
+          WorkerPool readPool( jobs );
+          for ( unsigned j = 0; j < jobs; ++j )
+          {
+            std::vector<const RpmFile *> slice( toread.begin() + std::min( j * chunk, toread.size() ),
+                                                toread.begin() + std::min( ( j + 1 ) * chunk, toread.size() ) );
+            readPool.enqueue( [&dir_r,&solvdata,j,slice=std::move(slice)]() { solvdata[j] = readRpms( dir_r, slice ); } );
+          }
+        }
+
+        for ( std::string & data : solvdata )
+        {
+          if ( data.empty() )
+            continue;
+          AutoFILE in { ::fmemopen( data.data(), data.size(), "r" ) };
+          if ( ! in || ::repo_add_solv( repo, in, 0 ) != 0 )
+            ZYPP_THROW( Exception( "Can't add rpms read from "+dir_r.asString() ) );
+        }
+      }
+
+      ::repo_add_autopattern( repo, 0 );
+      if ( ! ::repo_lookup_str( repo, SOLVID_META, REPOSITORY_TOOLVERSION ) )
+      {
+        ::Repodata * data = ::repo_add_repodata( repo, 0 );
+        ::repodata_set_str( data, SOLVID_META, REPOSITORY_TOOLVERSION, LIBSOLV_TOOLVERSION );
+        ::repodata_internalize( data );
+      }
+      ::repo_internalize( repo );
+
+      // Write solv file and index
+      {
+        filesystem::TmpFile tmp( solvfile_r.dirname(), solvfile_r.basename() );
+        FILE * out = ::fopen( tmp.path().c_str(), "we" );
+        if ( ! out )
+          ZYPP_THROW( Exception( "Can't write "+tmp.path().asString() ) );
+        bool ok = ( ::repo_write( repo, out ) == 0 );
+        if ( ::fclose( out ) != 0 || ! ok )
+          ZYPP_THROW( Exception( "Can't write "+tmp.path().asString() ) );
+
+        filesystem::unlink( indexfile );
+        if ( filesystem::rename( tmp.path(), solvfile_r ) != 0 )
+          ZYPP_THROW( Exception( "Can't rename solv file to "+solvfile_r.asString() ) );
+        tmp.autoCleanup( false );
+      }
+
+      std::unordered_map<std::string,const RpmFile *> byPath;
+      for ( const RpmFile & rpm : rpms )
+        byPath[rpm._path] = &rpm;
+
+      filesystem::TmpFile tmp( indexfile.dirname(), indexfile.basename() );
+      std::ofstream out( tmp.path().c_str() );
+      out << solvKey( solvfile_r ) << endl;
+      Id p = 0;
+      ::Solvable * s = nullptr;
+      FOR_REPO_SOLVABLES( repo, p, s )
+      {
+        const char * loc = ::solvable_lookup_location( s, nullptr );
+        const char * hdrid = ::solvable_lookup_checksum( s, SOLVABLE_HDRID, nullptr );
+        auto it = loc ? byPath.find( loc ) : byPath.end();
+        if ( hdrid && it != byPath.end() )
+          out << it->second->_size << ' ' << it->second->_mtime << ' ' << hdrid << ' ' << loc << '\n';
+      }
+      out.close();
+      if ( ! out || filesystem::rename( tmp.path(), indexfile ) != 0 )
+      {
+        WAR << "Can't write " << indexfile << ", next build will read all rpms" << endl;
+        return;
+      }
+      tmp.autoCleanup( false );
+    }
+
+  } // namespace repo
+  ///////////////////////////////////////////////////////////////////
+} // namespace zypp
+///////////////////////////////////////////////////////////////////
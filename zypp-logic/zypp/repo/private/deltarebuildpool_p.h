@@ -0,0 +1,136 @@
+/*---------------------------------------------------------------------\
+|                          ____ _   __ __ ___                          |
+|                         |__  / \ / / . \ . \                         |
+|                           / / \ V /|  _/  _/                         |
+|                          / /__ | | | | | |                           |
+|                         /_____||_| |_| |_|                           |
+|                                                                      |
+\---------------------------------------------------------------------*/
+/** \file	zypp/repo/private/deltarebuildpool_p.h
+ * This file contains private API, it will change without notice.
+ * You have been warned.
+*/
+#ifndef ZYPP_REPO_PRIVATE_DELTAREBUILDPOOL_P_H
+#define ZYPP_REPO_PRIVATE_DELTAREBUILDPOOL_P_H
+
+#include <memory>
+
+#include <zypp-core/Pathname.h>
+#include <zypp-core/ManagedFile.h>
+#include <zypp-core/base/Exception.h>
+#include <zypp-core/base/NonCopyable.h>
+
+///////////////////////////////////////////////////////////////////
+namespace zypp
+{
+  ///////////////////////////////////////////////////////////////////
+  namespace repo
+  {
+    ///////////////////////////////////////////////////////////////////
+    /// \class DeltaRebuildDeferredException
+    /// \brief Thrown by the \ref PackageProvider if the rpm is rebuilt from a
+    /// deltarpm in the active \ref DeltaRebuildPool.
+    ///
+    /// Not an error. The package must be requested again after
+    /// \ref DeltaRebuildPool::waitAll.
+    ///////////////////////////////////////////////////////////////////
+    class ZYPP_LOCAL DeltaRebuildDeferredException : public Exception
+    {
+    public:
+      DeltaRebuildDeferredException( const Pathname & builddest_r )
+      : Exception( "Deltarpm rebuild deferred: "+builddest_r.asString() )
+      , _builddest( builddest_r )
+      {}
+
+      /** Where the rpm is going to be built. */
+      const Pathname & builddest() const
+      { return _builddest; }
+
+    private:
+      Pathname _builddest;
+    };
+
+    ///////////////////////////////////////////////////////////////////
+    /// \class DeltaRebuildPool
+    /// \brief Run \c applydeltarpm jobs in the background.
+    ///
+    /// Rebuilding an rpm from a deltarpm is CPU bound. While a pool is
+    /// \ref active, the \ref PackageProvider queues the rebuild as soon as
+    /// the deltarpm is downloaded, and proceeds with the next package.
+    /// Signature check and moving the rpm into the cache happen when the
+    /// package is requested again, in the main thread.
+    ///
+    /// A failed rebuild is remembered, so the package provider falls
+    /// back to downloading the full rpm.
+    ///
+    /// At most \ref maxJobs rebuilds run concurrently. The default is the
+    /// number of hardware threads, \c $ZYPP_DELTARPM_JOBS overrides it.
+    ///
+    /// \note The \ref CommitPackagePreloader downloads the full rpms in
+    /// parallel before the commit loop and knows nothing about deltarpms.
+    /// So in a commit the pool only works for the packages the preloader
+    /// did not fetch (e.g. no preload report receiver is connected, or
+    /// the preloader skipped the package).
+    ///
+    /// \note Only one pool can be active. The pool must be created, used
+    /// and destroyed by the main thread.
+    ///////////////////////////////////////////////////////////////////
+    class ZYPP_LOCAL DeltaRebuildPool : private base::NonCopyable
+    {
+    public:
+      enum State
+      {
+        NONE,		///< unknown job
+        PENDING,	///< job queued or running
+        DONE,		///< rpm successfully rebuilt
+        FAILED		///< applydeltarpm failed
+      };
+
+    public:
+      /** Ctor makes this the \ref active pool; \a maxJobs_r \c 0 means default. */
+      explicit DeltaRebuildPool( unsigned maxJobs_r = 0 );
+
+      /** Dtor waits for running jobs and removes unclaimed rpms. */
+      ~DeltaRebuildPool();
+
+      /** The active pool or \c nullptr. */
+      static DeltaRebuildPool * active();
+
+      /** Max. number of concurrent rebuilds. */
+      unsigned maxJobs() const;
+
+    public:
+      /** Queue building \a builddest_r from \a delta_r.
+       * \a delta_r is kept until the job is done.
+       */
+      void enqueue( ManagedFile delta_r, const Pathname & builddest_r );
+
+      /** Current state of the job building \a builddest_r (does not block). */
+      State state( const Pathname & builddest_r ) const;
+
+      /** The deltarpm the job building \a builddest_r was queued with (for reporting).
+       * The file itself is removed once the job is done.
+       */
+      Pathname delta( const Pathname & builddest_r ) const;
+
+      /** Block until the job building \a builddest_r is done and return its final state. */
+      State wait( const Pathname & builddest_r );
+
+      /** Block until all queued jobs are done. */
+      void waitAll();
+
+      /** Forget about \a builddest_r once the result was consumed.
+       * The file itself is not touched.
+       */
+      void release( const Pathname & builddest_r );
+
+    private:
+      struct Impl;
+      std::unique_ptr<Impl> _pimpl;
+    };
+
+  } // namespace repo
+  ///////////////////////////////////////////////////////////////////
+} // namespace zypp
+///////////////////////////////////////////////////////////////////
+#endif // ZYPP_REPO_PRIVATE_DELTAREBUILDPOOL_P_H
@@ -0,0 +1,51 @@
+/*---------------------------------------------------------------------\
+|                          ____ _   __ __ ___                          |
+|                         |__  / \ / / . \ . \                         |
+|                           / / \ V /|  _/  _/                         |
+|                          / /__ | | | | | |                           |
+|                         /_____||_| |_| |_|                           |
+|                                                                      |
+\---------------------------------------------------------------------*/
+/** \file	zypp/repo/private/plaindirsolv_p.h
+ * This file contains private API, it will change without notice.
+ * You have been warned.
+*/
+#ifndef ZYPP_REPO_PRIVATE_PLAINDIRSOLV_P_H
+#define ZYPP_REPO_PRIVATE_PLAINDIRSOLV_P_H
+
+#include <zypp-core/Globals.h>
+#include <zypp-core/Pathname.h>
+
+///////////////////////////////////////////////////////////////////
+namespace zypp
+{
+  ///////////////////////////////////////////////////////////////////
+  namespace repo
+  {
+    /** Build the solv file of a plaindir repo like <tt>repo2solv -X -R dir_r</tt>,
+     * but incrementally.
+     *
+     * Next to \a solvfile_r an index (\ref plaindirSolvIndex) remembers path,
+     * size, mtime and header id of each rpm below \a dir_r. If the index
+     * matches the existing \a oldsolvfile_r (by default \a solvfile_r), the
+     * solvables of unchanged rpms are taken from there. Only new or changed
+     * rpms are read, by a few threads in parallel. Otherwise all rpms are read.
+     *
+     * Pass \a oldsolvfile_r if the previous solv file and its index were
+     * moved aside (by rename, as the index remembers the solv files inode)
+     * while the cache was cleaned.
+     *
+     * \a solvfile_r is replaced atomically.
+     * \throws Exception if the solv file can't be written.
+     */
+    ZYPP_LOCAL void buildPlaindirSolv( const Pathname & dir_r, const Pathname & solvfile_r, const Pathname & oldsolvfile_r = Pathname() );
+
+    /** The index of the plaindir rpms kept next to \a solvfile_r. */
+    inline Pathname plaindirSolvIndex( const Pathname & solvfile_r )
+    { return solvfile_r.extend( ".plaindir" ); }
+
+  } // namespace repo
+  ///////////////////////////////////////////////////////////////////
+} // namespace zypp
+///////////////////////////////////////////////////////////////////
+#endif // ZYPP_REPO_PRIVATE_PLAINDIRSOLV_P_H
@@ -12,19 +12,25 @@
 #include <sys/types.h>
 #include <sys/stat.h>
 #include <fcntl.h>
+#include <unistd.h>
+#include <stdlib.h>
 
 extern "C"
 {
 #include <solv/pool.h>
 #include <solv/repo.h>
 #include <solv/solvable.h>
+#include <solv/repo_solv.h>
 }
 
+#include <algorithm>
 #include <iostream>
 #include <fstream>
+#include <vector>
 
 #include <zypp-core/base/Easy.h>
 #include <zypp-core/base/Logger.h>
+#include <zypp-core/base/String.h>
 #include <zypp-core/base/Gettext.h>
 #include <zypp-core/base/Exception.h>
 
@@ -283,61 +289,117 @@ namespace zypp
     #undef ZYPP_BASE_LOGGER_LOGGROUP
     #define ZYPP_BASE_LOGGER_LOGGROUP "solvidx"
 
-    void updateSolvFileIndex( const Pathname & solvfile_r )
+    namespace
     {
-      AutoDispose<FILE*> solv( ::fopen( solvfile_r.c_str(), "re" ), ::fclose );
-      if ( solv == NULL )
+      /** The solv.idx of \a solvfile_r is up to date if it's newer than the solv file.
+       * Equal timestamps are not trusted (coarse filesystem timestamps).
+       */
+      bool solvFileIndexIsFresh( const Pathname & solvfile_r )
       {
-        solv.resetDispose();
-        ERR << "Can't open solv-file: " << solv << endl;
-        return;
+        struct ::stat solv;
+        struct ::stat idx;
+        if ( ::stat( solvfile_r.c_str(), &solv ) != 0 || ::stat( solvfile_r.extend(".idx").c_str(), &idx ) != 0 )
+          return false;
+        return ( idx.st_mtim.tv_sec > solv.st_mtim.tv_sec )
+            || ( idx.st_mtim.tv_sec == solv.st_mtim.tv_sec && idx.st_mtim.tv_nsec > solv.st_mtim.tv_nsec );
       }
 
-      std::string solvidxfile( solvfile_r.extend(".idx").asString() );
-      if ( ::unlink( solvidxfile.c_str() ) == -1 && errno != ENOENT )
-      {
-        ERR << "Can't unlink solv-idx: " << Errno() << endl;
-        return;
-      }
+      /** (Re)write the solv.idx of \a solvfile_r from the solvables in \a repo_r.
+       * The lines are sorted, so the file can be searched for a name prefix
+       * (e.g. by look(1)). The file is replaced atomically, so readers see
+       * either the old or the new index.
+       */
+      void writeSolvFileIndex( const Pathname & solvfile_r, detail::CRepo * repo_r )
       {
-        int fd = ::open( solvidxfile.c_str(), O_CREAT|O_EXCL|O_WRONLY|O_TRUNC, 0644 );
-        if ( fd == -1 )
+        std::vector<std::string> lines;
+        lines.reserve( repo_r->nsolvables );
         {
-          ERR << "Can't create solv-idx: " << Errno() << endl;
-          return;
+          detail::CPool * _pool = repo_r->pool;
+          int _id = 0;
+          detail::CSolvable * _solv = nullptr;
+          FOR_REPO_SOLVABLES( repo_r, _id, _solv )
+          {
+            if ( _solv )
+            {
+#define SEP "\t"
+#define	idstr(V) pool_id2str( _pool, _solv->V )
+              if ( _solv->arch == ARCH_SRC || _solv->arch == ARCH_NOSRC )
+                lines.push_back( str::Str() << "srcpackage:" << idstr(name) << SEP << idstr(evr) << SEP << "noarch" );
+              else
+                lines.push_back( str::Str() << idstr(name) << SEP << idstr(evr) << SEP << idstr(arch) );
+#undef idstr
+#undef SEP
+            }
+          }
         }
-        ::close( fd );
-      }
-      std::ofstream idx( solvidxfile.c_str() );
+        std::sort( lines.begin(), lines.end() );
 
-
-      detail::CPool * _pool = ::pool_create();
-      detail::CRepo * _repo = ::repo_create( _pool, "" );
-      if ( ::repo_add_solv( _repo, solv, 0 ) == 0 )
-      {
-        int _id = 0;
-        detail::CSolvable * _solv = nullptr;
-        FOR_REPO_SOLVABLES( _repo, _id, _solv )
+        std::string solvidxfile( solvfile_r.extend(".idx").asString() );
+        std::string tmpfile( solvidxfile + ".XXXXXX" );
         {
-          if ( _solv )
+          int fd = ::mkstemp( &tmpfile[0] );
+          if ( fd == -1 )
           {
-#define SEP '\t'
-#define	idstr(V) pool_id2str( _pool, _solv->V )
-            if ( _solv->arch == ARCH_SRC || _solv->arch == ARCH_NOSRC )
-              idx << "srcpackage:" << idstr(name) << SEP << idstr(evr) << SEP << "noarch" << endl;
-            else
-              idx << idstr(name) << SEP << idstr(evr) << SEP << idstr(arch) << endl;
+            ERR << "Can't create solv-idx: " << Errno() << endl;
+            return;
+          }
+          ::fchmod( fd, 0644 );
+          ::close( fd );
+        }
+        {
+          std::ofstream idx( tmpfile.c_str() );
+          for ( const std::string & line : lines )
+            idx << line << '\n';
+          idx.close();
+          if ( ! idx )
+          {
+            ERR << "Can't write solv-idx: " << tmpfile << endl;
+            ::unlink( tmpfile.c_str() );
+            return;
           }
         }
+        if ( ::rename( tmpfile.c_str(), solvidxfile.c_str() ) == -1 )
+        {
+          ERR << "Can't rename solv-idx: " << Errno() << endl;
+          ::unlink( tmpfile.c_str() );
+          return;
+        }
+        DBG << "Wrote " << lines.size() << " entries to " << solvidxfile << endl;
       }
-      else
+    } // namespace
+
+    void updateSolvFileIndex( const Pathname & solvfile_r )
+    {
+      if ( solvFileIndexIsFresh( solvfile_r ) )
+        return;
+
+      AutoDispose<FILE*> solv( ::fopen( solvfile_r.c_str(), "re" ), ::fclose );
+      if ( solv == NULL )
       {
-        ERR << "Can't read solv-file: " << ::pool_errstr( _pool ) << endl;
+        solv.resetDispose();
+        ERR << "Can't open solv-file: " << solv << endl;
+        return;
       }
+
+      // Just the solvables core data are needed, so don't internalize
+      // the attributes nor create stubs for the external data.
+      detail::CPool * _pool = ::pool_create();
+      detail::CRepo * _repo = ::repo_create( _pool, "" );
+      if ( ::repo_add_solv( _repo, solv, REPO_NO_INTERNALIZE|SOLV_ADD_NO_STUBS ) == 0 )
+        writeSolvFileIndex( solvfile_r, _repo );
+      else
+        ERR << "Can't read solv-file: " << ::pool_errstr( _pool ) << endl;
       ::repo_free( _repo, 0 );
       ::pool_free( _pool );
     }
 
+    void updateSolvFileIndexFrom( const Pathname & solvfile_r, const Repository & repo_r )
+    {
+      if ( ! repo_r || solvFileIndexIsFresh( solvfile_r ) )
+        return;
+      writeSolvFileIndex( solvfile_r, repo_r.get() );
+    }
+
     /////////////////////////////////////////////////////////////////
   } // namespace sat
   ///////////////////////////////////////////////////////////////////
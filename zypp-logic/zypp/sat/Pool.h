@@ -298,9 +298,21 @@ namespace zypp
     inline bool operator!=( const Pool & lhs, const Pool & rhs )
     { return lhs.get() != rhs.get(); }
 
-    /** Create solv file content digest for zypper bash completion */
+    /** Create solv file content digest for zypper bash completion.
+     * The digest (<tt>solv.idx</tt>) lists the solvables name, edition
+     * and arch (TAB separated), sorted. It is not rewritten if it is
+     * newer than the solv file.
+     */
     void updateSolvFileIndex( const Pathname & solvfile_r );
 
+    /** Like \ref updateSolvFileIndex, but take the solvables from \a repo_r
+     * which was loaded from \a solvfile_r. Avoids parsing the solv file again.
+     * \note Adding a repo to the pool drops solvables of incompatible
+     * architecture, except for the system repo. So this is for the system
+     * repo only, the index of any other repo would miss entries.
+     */
+    void updateSolvFileIndexFrom( const Pathname & solvfile_r, const Repository & repo_r );
+
     /////////////////////////////////////////////////////////////////
   } // namespace sat
   ///////////////////////////////////////////////////////////////////
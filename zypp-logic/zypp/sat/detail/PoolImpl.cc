@@ -11,10 +11,13 @@
 */
 #include <iostream>
 #include <fstream>
+#include <set>
+#include <vector>
 #include <boost/mpl/int.hpp>
 #include <boost/mpl/assert.hpp>
 
 #include <zypp-core/base/Easy.h>
+#include <zypp-core/AutoDispose.h>
 #include <zypp-core/base/LogTools.h>
 #include <zypp-core/base/Gettext.h>
 #include <zypp-core/base/Exception.h>
@@ -22,6 +25,7 @@
 #include <zypp-core/fs/WatchFile>
 #include <zypp-core/parser/Sysconfig>
 #include <zypp-core/base/IOStream.h>
+#include <zypp-core/fs/PathInfo.h>
 
 #include <zypp/ZConfig.h>
 
@@ -43,6 +47,7 @@ extern "C"
 // #include <solv/testcase.h>
 int repo_add_helix( ::Repo *repo, FILE *fp, int flags );
 int testcase_add_testtags(Repo *repo, FILE *fp, int flags);
+#include <solv/repo_write.h>
 }
 
 using std::endl;
@@ -188,6 +193,51 @@ namespace zypp
         return _global;
       }
 
+      namespace
+      {
+        /** Attributes \ref PoolImpl::writeSolv moves into the ext file. */
+        bool isLazyAttr( CPool * pool_r, IdType keyname_r )
+        {
+          switch ( keyname_r )
+          {
+            case SOLVABLE_DESCRIPTION:
+            case SOLVABLE_EULA:
+            case SOLVABLE_CHANGELOG:
+            case SOLVABLE_CHANGELOG_AUTHOR:
+            case SOLVABLE_CHANGELOG_TIME:
+            case SOLVABLE_CHANGELOG_TEXT:
+            case UPDATE_REFERENCE:
+            case UPDATE_REFERENCE_TYPE:
+            case UPDATE_REFERENCE_HREF:
+            case UPDATE_REFERENCE_ID:
+            case UPDATE_REFERENCE_TITLE:
+              return true;
+            default:
+              break;
+          }
+          // translations like "solvable:description:de"
+          const char * name = ::pool_id2str( pool_r, keyname_r );
+          return str::startsWith( name, "solvable:description:" ) || str::startsWith( name, "solvable:eula:" );
+        }
+
+        int coreKeyFilter( CRepo * repo_r, ::Repokey * key_r, void * kfdata_r )
+        {
+          if ( isLazyAttr( repo_r->pool, key_r->name ) )
+            return 0;
+          return ::repo_write_stdkeyfilter( repo_r, key_r, kfdata_r );
+        }
+
+        int extKeyFilter( CRepo * repo_r, ::Repokey * key_r, void * kfdata_r )
+        {
+          if ( ! isLazyAttr( repo_r->pool, key_r->name ) )
+            return 0;
+          return ::repo_write_stdkeyfilter( repo_r, key_r, kfdata_r );
+        }
+
+        int loadSolvExtCallback( CPool *, ::Repodata * data_r, void * cbdata_r )
+        { return reinterpret_cast<PoolImpl*>(cbdata_r)->loadSolvExt( data_r ); }
+      } // namespace
+
       ///////////////////////////////////////////////////////////////////
       //
       //	METHOD NAME : PoolImpl::PoolImpl
@@ -225,6 +275,9 @@ namespace zypp
         _pool->nscallback = &nsCallback;
         _pool->nscallbackdata = (void*)this;
 
+        // load attributes stubbed by writeSolv on demand
+        ::pool_setloadcallback( _pool, &loadSolvExtCallback, (void*)this );
+
         // CAVEAT: We'd like to do it here, but in side the Pool ctor we can not
         // yet use IdString types. We do in setDirty, when the 1st
         // _retractedSpec.addProvides( Capability( Solvable::retractedToken.id() ) );
@@ -341,6 +394,7 @@ namespace zypp
         if ( isSystemRepo( repo_r ) )
           _autoinstalled.clear();
         eraseRepoInfo( repo_r );
+        _solvExtFiles.erase( repo_r );
         ::repo_free( repo_r, /*resusePoolIDs*/false );
         // If the last repo is removed clear the pool to actually reuse all IDs.
         // NOTE: the explicit ::repo_free above asserts all solvables are memset(0)!
@@ -351,15 +405,123 @@ namespace zypp
         }
       }
 
-      int PoolImpl::_addSolv( CRepo * repo_r, FILE * file_r )
+      int PoolImpl::_addSolv( CRepo * repo_r, FILE * file_r, const Pathname & extfile_r, AutoFILE ext_r )
       {
         setDirty(__FUNCTION__, repo_r->name );
         int ret = ::repo_add_solv( repo_r, file_r, 0 );
         if ( ret == 0 )
+        {
           _postRepoAdd( repo_r );
+
+          // remember where to load stubs from
+          ::Repodata * data = nullptr;
+          int rdid = 0;
+          FOR_REPODATAS( repo_r, rdid, data )
+          {
+            if ( data->state == REPODATA_STUB )
+            {
+              if ( ext_r == nullptr )
+                WAR << repo_r->name << ": no file to load stubbed attributes from" << endl;
+              else
+                _solvExtFiles[repo_r] = { extfile_r, std::move(ext_r) };
+              break;
+            }
+          }
+        }
+        return ret;
+      }
+
+      int PoolImpl::writeSolv( CRepo * repo_r, FILE * file_r, FILE * extfile_r ) const
+      {
+        if ( ! extfile_r )
+          return ::repo_write( repo_r, file_r );
+
+        // Collect the lazy attributes present in the repo...
+        std::vector<IdType> keys;
+        {
+          std::set<std::pair<IdType,IdType>> seen;
+          ::Repodata * data = nullptr;
+          int rdid = 0;
+          FOR_REPODATAS( repo_r, rdid, data )
+          {
+            for ( int k = 1; k < data->nkeys; ++k )
+            {
+              const ::Repokey & key { data->keys[k] };
+              if ( isLazyAttr( _pool, key.name ) && seen.insert( { key.name, key.type } ).second )
+              {
+                keys.push_back( key.name );
+                keys.push_back( key.type );
+              }
+            }
+          }
+        }
+
+        // ...and write a stub for them to file_r, using a temporary repodata.
+        int ret = 0;
+        {
+          ::Repodata * stub = nullptr;
+          if ( ! keys.empty() )
+          {
+            stub = ::repo_add_repodata( repo_r, 0 );
+            IdType handle = ::repodata_new_handle( stub );
+            for ( IdType id : keys )
+              ::repodata_add_idarray( stub, handle, REPOSITORY_KEYS, id );
+            ::repodata_add_flexarray( stub, SOLVID_META, REPOSITORY_EXTERNAL, handle );
+            ::repodata_internalize( stub );
+          }
+
+          ::Repowriter * writer = ::repowriter_create( repo_r );
+          ::repowriter_set_keyfilter( writer, &coreKeyFilter, nullptr );
+          ret = ::repowriter_write( writer, file_r );
+          ::repowriter_free( writer );
+
+          if ( stub )
+            ::repodata_free( stub );
+        }
+        if ( ret != 0 || keys.empty() )
+          return ret;
+
+        // The ext file just extends the solvables written to file_r.
+        ::Repowriter * writer = ::repowriter_create( repo_r );
+        ::repowriter_set_flags( writer, REPOWRITER_NO_STORAGE_SOLVABLE );
+        ::repowriter_set_keyfilter( writer, &extKeyFilter, nullptr );
+        ret = ::repowriter_write( writer, extfile_r );
+        ::repowriter_free( writer );
         return ret;
       }
 
+      int PoolImpl::loadSolvExt( ::Repodata * data_r )
+      {
+        auto it { _solvExtFiles.find( data_r->repo ) };
+        if ( it == _solvExtFiles.end() )
+        {
+          ERR << data_r->repo->name << ": no file to load stubbed attributes from" << endl;
+          return 0;
+        }
+        // the stub is loaded just once
+        const Pathname extfile { it->second.first };
+        AutoFILE file { std::move(it->second.second) };
+        _solvExtFiles.erase( it );
+
+        // ext data use their own string pool, so loading does not invalidate pool IDs
+        if ( ::repo_add_solv( data_r->repo, file, REPO_USE_LOADING|REPO_EXTEND_SOLVABLES|REPO_LOCALPOOL ) != 0 )
+        {
+          // Remove it, so the owner of the file (e.g. the RepoManager's solv snapshot) notices and rebuilds it.
+          // If it was replaced meanwhile, the new one is none of our business.
+          ERR << data_r->repo->name << ": error loading " << extfile << ": " << ::pool_errstr( _pool ) << endl;
+          struct ::stat st;
+          PathInfo pi( extfile );
+          if ( ::fstat( ::fileno( file ), &st ) == 0 && pi.ino() == st.st_ino && pi.dev() == st.st_dev )
+          {
+            MIL << "Removing " << extfile << endl;
+            filesystem::unlink( extfile );
+          }
+          return 0;
+        }
+        MIL << data_r->repo->name << ": loaded stubbed attributes from " << extfile << endl;
+        return 1;
+      }
+
       int PoolImpl::_addHelix( CRepo * repo_r, FILE * file_r )
       {
         setDirty(__FUNCTION__, repo_r->name );
@@ -21,7 +21,9 @@ extern "C"
 #include <solv/pool_parserpmrichdep.h>
 }
 #include <iosfwd>
+#include <unordered_map>
 
+#include <zypp-core/AutoDispose.h>
 #include <zypp-core/base/Hash.h>
 #include <zypp-core/base/NonCopyable.h>
 #include <zypp/base/SerialNumber.h>
@@ -135,8 +137,12 @@ namespace zypp
           /** Adding solv file to a repo.
            * Except for \c isSystemRepo_r, solvables of incompatible architecture
            * are filtered out.
+           * If the solv file was written by \ref writeSolv with a separate
+           * ext file, those attributes are loaded on demand from \a ext_r,
+           * opened from \a extfile_r along with \a file_r. The pool keeps
+           * it open, so a concurrent rewrite of the files does not mix them.
           */
-          int _addSolv( CRepo * repo_r, FILE * file_r );
+          int _addSolv( CRepo * repo_r, FILE * file_r, const Pathname & extfile_r = Pathname(), AutoFILE ext_r = AutoFILE() );
 
           /** Adding helix file to a repo.
            * Except for \c isSystemRepo_r, solvables of incompatible architecture
@@ -157,6 +163,21 @@ namespace zypp
           /** Helper postprocessing the repo after adding solv or helix files. */
           void _postRepoAdd( CRepo * repo_r );
 
+        public:
+          /** Write the repos solv data to \a file_r.
+           * If \a extfile_r is not \c NULL, rarely used attributes like
+           * descriptions, changelogs or update references are written to
+           * \a extfile_r. \a file_r just contains a stub for them, so they
+           * can be loaded on demand (\see \ref _addSolv).
+           */
+          int writeSolv( CRepo * repo_r, FILE * file_r, FILE * extfile_r = nullptr ) const;
+
+          /** libsolv load callback for stubs created by \ref writeSolv.
+           * An ext file failing to load is removed, unless it was replaced
+           * since it was opened.
+           */
+          int loadSolvExt( ::Repodata * data_r );
+
         public:
           /** a \c valid \ref Solvable has a non NULL repo pointer. */
           bool validSolvable( const CSolvable & slv_r ) const
@@ -362,6 +383,8 @@ namespace zypp
           SerialNumberWatcher _watcher;
           /** Additional \ref RepoInfo. */
           std::map<RepoIdType,RepoInfo> _repoinfos;
+          /** Files to load stubbed repo attributes from (\ref writeSolv). */
+          std::unordered_map<RepoIdType,std::pair<Pathname,AutoFILE>> _solvExtFiles;
 
           /**  */
           base::SetTracker<LocaleSet> _requestedLocalesTracker;
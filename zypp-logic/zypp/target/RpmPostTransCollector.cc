@@ -12,6 +12,11 @@
 #include <fstream>
 #include <optional>
 #include <utility>
+#include <algorithm>
+#include <condition_variable>
+#include <mutex>
+#include <set>
+#include <unordered_map>
 #include <zypp-core/base/LogTools.h>
 #include <zypp-core/base/NonCopyable.h>
 #include <zypp-core/base/Gettext.h>
@@ -19,10 +24,14 @@
 #include <zypp-core/base/IOStream.h>
 #include <zypp-core/base/InputStream>
 #include <zypp-core/base/PtrTypes.h>
+#include <zypp-core/base/WorkerPool_p.h>
 #include <zypp/target/RpmPostTransCollector.h>
+#include <zypp/target/private/rpmheadercache_p.h>
+#include <zypp/target/private/concurrentscripts_p.h>
 
 #include <zypp/TmpPath.h>
 #include <zypp/PathInfo.h>
+#include <zypp/Capability.h>
 #include <zypp/HistoryLog.h>
 #include <zypp/ZYppCallbacks.h>
 #include <zypp-core/ExternalProgram.h>
@@ -41,6 +50,80 @@ namespace zypp
   ///////////////////////////////////////////////////////////////////
   namespace target
   {
+    namespace
+    {
+      /** Max. number of %posttrans scripts executed concurrently (\c $ZYPP_POSTTRANS_JOBS, default \c 1). */
+      unsigned posttransJobs()
+      {
+        if ( const char * env = ::getenv( "ZYPP_POSTTRANS_JOBS" ) )
+        {
+          unsigned jobs = str::strtonum<unsigned>( env );
+          if ( jobs )
+            return jobs;
+        }
+        return 1;
+      }
+    } // namespace
+
+    void executeScriptsConcurrently( unsigned threads_r, const std::vector<ScriptJob> & jobs_r,
+                                     const std::function<int(const std::string &, int, const std::function<void(const std::string &)> &)> & runScript_r,
+                                     const std::function<void(size_t, const std::vector<std::string> &, int)> & report_r )
+    {
+      struct Result
+      {
+        std::vector<std::string> _output;
+        int _ret = 0;
+        bool _done = false;
+      };
+      std::vector<Result> results( jobs_r.size() );
+
+      std::mutex m;	// < locks the results
+      std::condition_variable done;
+      WorkerPool workers( threads_r );
+      // Jobs are picked in order, so a job waiting for its predecessors
+      // will not block any of them.
+      for ( size_t idx = 0; idx < jobs_r.size(); ++idx )
+      {
+        workers.enqueue( [&,idx]() {
+          const ScriptJob & job { jobs_r[idx] };
+          {
+            std::unique_lock<std::mutex> lk( m );
+            done.wait( lk, [&]() {
+              return std::all_of( job._after.begin(), job._after.end(), [&]( size_t pre ) { return results[pre]._done; } );
+            } );
+          }
+          std::vector<std::string> output;
+          int ret = -1;
+          try {
+            ret = runScript_r( job._script, job._npkgs, [&output]( const std::string & line_r ) { output.push_back( line_r ); } );
+          }
+          catch ( const std::exception & excpt ) {
+            ERR << "Script " << job._script << " failed: " << excpt.what() << endl;
+            output.push_back( str::Str() << excpt.what() << endl );
+          }
+          catch ( ... ) {
+            ERR << "Script " << job._script << " failed." << endl;
+          }
+          {
+            std::lock_guard<std::mutex> lk( m );
+            results[idx]._output.swap( output );
+            results[idx]._ret = ret;
+            results[idx]._done = true;
+          }
+          done.notify_all();
+        } );
+      }
+
+      for ( size_t idx = 0; idx < jobs_r.size(); ++idx )
+      {
+        {
+          std::unique_lock<std::mutex> lk( m );
+          done.wait( lk, [&]() { return results[idx]._done; } );
+        }
+        report_r( idx, results[idx]._output, results[idx]._ret );
+      }
+    }
+
     ///////////////////////////////////////////////////////////////////
     /// \class RpmPostTransCollector::Impl
     /// \brief RpmPostTransCollector implementation.
@@ -53,6 +136,14 @@ namespace zypp
       /// <%posttrans script basename, pkgname> pairs.
       using ScriptList = std::list< std::pair<std::string,std::string> >;
 
+      /// Capability names provided and required by a scripts package.
+      /// Used to order the scripts if they are executed concurrently.
+      struct ScriptDeps
+      {
+        std::set<std::string> _provides;
+        std::set<std::string> _requires;
+      };
+
       /// Data regarding the dumpfile used if `rpm --runposttrans` is supported
       struct Dumpfile
       {
@@ -105,6 +196,12 @@ namespace zypp
             }
 
             _scripts->push_back( std::make_pair( script.path().basename(), pkg->tag_name() ) );
+            ScriptDeps & deps { _scriptDeps[script.path().basename()] };
+            deps._provides.insert( pkg->tag_name() );
+            for ( const auto & cap : pkg->tag_provides() )
+              deps._provides.insert( cap.detail().name().asString() );
+            for ( const auto & cap : pkg->tag_requires() )
+              deps._requires.insert( cap.detail().name().asString() );
             MIL << "COLLECT posttrans: '" << PathInfo( script.path() ) << "' for package: '" << pkg->tag_name() << "'" << endl;
           }
         }
@@ -241,6 +338,39 @@ namespace zypp
             str::Format fmtScriptFailedMsg { "warning: %%posttrans(%1%) scriptlet failed, exit status %2%\n" };
             str::Format fmtPosttrans { "%%posttrans(%1%)" };
 
+            // lambda executing a script, passing its output lines to consume_r (may run in a worker thread)
+            auto runScript = [&]( const std::string & script_r, int npkgs_r, const std::function<void(const std::string &)> & consume_r ) -> int {
+              MIL << "EXECUTE posttrans: " << script_r << " with argument: " << npkgs_r << endl;
+              ExternalProgram::Arguments cmd {
+                "/bin/sh",
+                (noRootScriptDir/script_r).asString(),
+                str::numstring( npkgs_r )
+              };
+              ExternalProgram prog( cmd, ExternalProgram::Stderr_To_Stdout, false, -1, true, _root );
+
+              for( std::string line = prog.receiveLine(); ! line.empty(); line = prog.receiveLine() ) {
+                consume_r( line );
+              }
+              return prog.close();
+            };
+
+            unsigned jobs = posttransJobs();
+            if ( jobs > 1 && _scripts->size() > 1 )
+            {
+              executeScriptsConcurrently( jobs, obsoletedPackages_r, runScript, [&]( const std::string & pkgident_r, const std::vector<std::string> & output_r, int ret_r ) {
+                startNewScript( fmtPosttrans % pkgident_r );
+                for ( const auto & line : output_r ) {
+                  sendScriptOutput( line );
+                }
+                if ( ret_r != 0 )
+                {
+                  std::string msg { fmtScriptFailedMsg % pkgident_r % ret_r };
+                  WAR << msg;
+                  sendScriptOutput( msg ); // info!, as rpm would have reported it.
+                }
+              } );
+            }
+
             while ( ! _scripts->empty() )
             {
               const auto &scriptPair = _scripts->front();
@@ -249,21 +379,10 @@ namespace zypp
               startNewScript( fmtPosttrans % pkgident );
 
               int npkgs = obsoletedPackages_r.count( IdString(scriptPair.second) ) ? 2 : 1; // bsc#1243279, was update if obsoleted
-              MIL << "EXECUTE posttrans: " << script << " with argument: " << npkgs << endl;
-              ExternalProgram::Arguments cmd {
-                "/bin/sh",
-                (noRootScriptDir/script).asString(),
-                str::numstring( npkgs )
-              };
-              ExternalProgram prog( cmd, ExternalProgram::Stderr_To_Stdout, false, -1, true, _root );
-
-              for( std::string line = prog.receiveLine(); ! line.empty(); line = prog.receiveLine() ) {
-                sendScriptOutput( line );
-              }
+              int ret = runScript( script, npkgs, sendScriptOutput );
               //script was executed, remove it from the list
               _scripts->pop_front();
 
-              int ret = prog.close();
               if ( ret != 0 )
               {
                 std::string msg { fmtScriptFailedMsg % pkgident % ret };
@@ -271,6 +390,7 @@ namespace zypp
                 sendScriptOutput( msg ); // info!, as rpm would have reported it.
               }
             }
+            _scriptDeps.clear();
             _scripts = std::nullopt;
           }
 
@@ -296,6 +416,48 @@ namespace zypp
           return;
         }
 
+        /** Execute the remembered scripts in up to \a jobs_r worker threads.
+         *
+         * A script waits for all preceding scripts whose package provides
+         * something its own package requires. Independent scripts run
+         * concurrently. The output of each script is buffered and passed
+         * to \a report_r in the main thread, in the original order of the
+         * scripts. Executed scripts are removed from \ref _scripts.
+         */
+        void executeScriptsConcurrently( unsigned jobs_r, const IdStringSet & obsoletedPackages_r,
+                                         const std::function<int(const std::string &, int, const std::function<void(const std::string &)> &)> & runScript_r,
+                                         const std::function<void(const std::string &, const std::vector<std::string> &, int)> & report_r )
+        {
+          std::vector<ScriptJob> schedule;
+          schedule.reserve( _scripts->size() );
+          for ( const auto & scriptPair : *_scripts )
+          {
+            ScriptJob job;
+            job._script = scriptPair.first;
+            job._npkgs = obsoletedPackages_r.count( IdString(scriptPair.second) ) ? 2 : 1; // bsc#1243279, was update if obsoleted
+
+            auto deps { _scriptDeps.find( job._script ) };
+            for ( size_t idx = 0; idx < schedule.size(); ++idx )
+            {
+              auto predeps { _scriptDeps.find( schedule[idx]._script ) };
+              // Unknown dependencies serialize the script.
+              if ( deps == _scriptDeps.end() || predeps == _scriptDeps.end()
+                || std::any_of( deps->second._requires.begin(), deps->second._requires.end(),
+                                [&]( const std::string & req ) { return predeps->second._provides.count( req ); } ) )
+                job._after.push_back( idx );
+            }
+            schedule.push_back( std::move(job) );
+          }
+          MIL << "EXECUTE " << schedule.size() << " posttrans scripts using up to " << jobs_r << " jobs." << endl;
+
+          target::executeScriptsConcurrently( jobs_r, schedule, runScript_r, [&]( size_t idx_r, const std::vector<std::string> & output_r, int ret_r ) {
+            const std::string & script { schedule[idx_r]._script };
+            report_r( script.substr( 0, script.size()-6 ), output_r, ret_r ); // strip tmp file suffix[6]
+            //script was executed, remove it from the list
+            _scripts->pop_front();
+          } );
+        }
+
         /** Discard all remembered scrips.
          * As we are just logging the omitted actions, we don't pay further attention
          * to the mixed case, where scripts and dumpfile are present (see executeScripts).
@@ -317,6 +479,7 @@ namespace zypp
               msg << "    " << pkgident << "\n";
             }
             _scripts = std::nullopt;
+            _scriptDeps.clear();
           }
 
           if ( _dumpfile ) {
@@ -358,7 +521,7 @@ namespace zypp
           if ( _headercache.first == rpmPackage_r )
             return _headercache.second;
 
-          rpm::RpmHeader::constPtr ret { rpm::RpmHeader::readPackage( rpmPackage_r, rpm::RpmHeader::NOVERIFY ) };
+          rpm::RpmHeader::constPtr ret { RpmHeaderCache::lookup( rpmPackage_r ) };
           if ( ret ) {
             if ( not headerHasPosttrans( ret ) )
               ret = nullptr;
@@ -385,6 +548,7 @@ namespace zypp
       private:
         Pathname _root;
         std::optional<ScriptList> _scripts;
+        std::unordered_map<std::string,ScriptDeps> _scriptDeps;	///< per script basename
         std::optional<Dumpfile> _dumpfile;
         scoped_ptr<filesystem::TmpDir> _ptrTmpdir;
 
@@ -36,6 +36,12 @@ namespace zypp
     /// "rpm --runposttrans".
     /// If rpm does not support it, those lines are not injected. In this case we
     /// collect and later execute the %posttrans script on our own.
+    ///
+    /// Setting \c $ZYPP_POSTTRANS_JOBS to a value greater than 1 lets us
+    /// execute our own collected %posttrans scripts concurrently. A script
+    /// still waits for scripts of packages its own package requires. The
+    /// output is reported per script and in the original order. The
+    /// dump_posttrans lines are always passed to a single "rpm --runposttrans".
     ///////////////////////////////////////////////////////////////////
     class RpmPostTransCollector
     {
@@ -50,9 +50,11 @@
 #include <zypp/target/CommitPackageCache.h>
 #include <zypp/target/RpmPostTransCollector.h>
 #include <zypp/target/private/commitpackagepreloader_p.h>
+#include <zypp/target/private/rpmheadercache_p.h>
 
 #include <zypp/parser/ProductFileReader.h>
 #include <zypp/repo/SrcPackageProvider.h>
+#include <zypp/repo/private/deltarebuildpool_p.h>
 
 #include <zypp/sat/Pool.h>
 #include <zypp/sat/detail/PoolImpl.h>
@@ -1238,7 +1240,8 @@ namespace zypp
 
         // We keep it.
         guard.resetDispose();
-        sat::updateSolvFileIndex( rpmsolv );	// content digest for zypper bash completion
+        // The content digest for zypper bash completion (solv.idx) is
+        // written by load (from the loaded data) or commit.
 
         // system-hook: Finally send notification to plugins
         if ( root() == "/" )
@@ -1249,12 +1252,6 @@ namespace zypp
             plugins.send( PluginFrame( "PACKAGESETCHANGED" ) );
         }
       }
-      else
-      {
-        // On the fly add missing solv.idx files for bash completion.
-        if ( ! PathInfo(base/"solv.idx").isExist() )
-          sat::updateSolvFileIndex( rpmsolv );
-      }
       return build_rpm_solv;
     }
 
@@ -1315,6 +1312,8 @@ namespace zypp
 
         system.addSolv( rpmsolv );
       }
+      // (Re)write a missing or outdated content digest for zypper bash completion.
+      sat::updateSolvFileIndexFrom( rpmsolv, system );
       satpool.rootDir( _root );
 
       // (Re)Load the requested locales et al.
@@ -1555,6 +1554,9 @@ namespace zypp
       ///////////////////////////////////////////////////////////////////
 
       DBG << "commit log file is set to: " << HistoryLog::fname() << endl;
+      // Package headers are needed by the signature and file conflicts checks
+      // as well as by the %posttrans collector. Parse each one just once.
+      RpmHeaderCache headerCache;
       if ( ! policy_r.dryRun() || policy_r.downloadMode() == DownloadOnly )
       {
         // Prepare the package cache. Pass all items requiring download.
@@ -1574,6 +1576,53 @@ namespace zypp
           }
 
           if ( !miss ) {
+            // Rpms built from deltarpms are rebuilt in the background while
+            // downloading the remaining packages. The deferred items are
+            // requested again, once all rebuilds are done.
+            // NOTE: The preloader above already fetched the full rpms it was
+            // able to, so this only applies to packages it did not fetch.
+            repo::DeltaRebuildPool deltaRebuildPool;
+            std::vector<ZYppCommitResult::TransactionStepList::iterator> deferred;
+
+            const auto & preloadStep = [&]( ZYppCommitResult::TransactionStepList::iterator it )
+            {
+              PoolItem pi( *it );
+              ManagedFile localfile;
+              try
+              {
+                localfile = packageCache.get( pi );
+                localfile.resetDispose(); // keep the package file in the cache
+              }
+              catch ( const repo::DeltaRebuildDeferredException & exp )
+              {
+                ZYPP_CAUGHT( exp );
+                deferred.push_back( it );
+              }
+              catch ( const AbortRequestException & exp )
+              {
+                it->stepStage( sat::Transaction::STEP_ERROR );
+                miss = true;
+                WAR << "commit cache preload aborted by the user" << endl;
+                ZYPP_THROW( TargetAbortedException( ) );
+              }
+              catch ( const SkipRequestException & exp )
+              {
+                ZYPP_CAUGHT( exp );
+                it->stepStage( sat::Transaction::STEP_ERROR );
+                miss = true;
+                WAR << "Skipping cache preload package " << pi->asKind<Package>() << " in commit" << endl;
+              }
+              catch ( const Exception & exp )
+              {
+                // bnc #395704: missing catch causes abort.
+                // TODO see if packageCache fails to handle errors correctly.
+                ZYPP_CAUGHT( exp );
+                it->stepStage( sat::Transaction::STEP_ERROR );
+                miss = true;
+                INT << "Unexpected Error: Skipping cache preload package " << pi->asKind<Package>() << " in commit" << endl;
+              }
+            };
+
             // Preload the cache. Until now this means pre-loading all packages.
             // Once DownloadInHeaps is fully implemented, this will change and
             // we may actually have more than one heap.
@@ -1594,39 +1643,24 @@ namespace zypp
 
               PoolItem pi( *it );
               if ( pi->isKind<Package>() || pi->isKind<SrcPackage>() )
+                preloadStep( it );
+            }
+
+            if ( ! deferred.empty() )
+            {
+              MIL << "Waiting for " << deferred.size() << " deltarpm rebuilds." << endl;
+              deltaRebuildPool.waitAll();
+              // Deferred again is not expected as the pool knows the items now.
+              std::vector<ZYppCommitResult::TransactionStepList::iterator> rebuilt;
+              rebuilt.swap( deferred );
+              for ( const auto & it : rebuilt )
+                preloadStep( it );
+              if ( ! deferred.empty() )
               {
-                ManagedFile localfile;
-                try
-                {
-                  localfile = packageCache.get( pi );
-                  localfile.resetDispose(); // keep the package file in the cache
-                }
-                catch ( const AbortRequestException & exp )
-                {
-                  it->stepStage( sat::Transaction::STEP_ERROR );
-                  miss = true;
-                  WAR << "commit cache preload aborted by the user" << endl;
-                  ZYPP_THROW( TargetAbortedException( ) );
-                  break;
-                }
-                catch ( const SkipRequestException & exp )
-                {
-                  ZYPP_CAUGHT( exp );
-                  it->stepStage( sat::Transaction::STEP_ERROR );
-                  miss = true;
-                  WAR << "Skipping cache preload package " << pi->asKind<Package>() << " in commit" << endl;
-                  continue;
-                }
-                catch ( const Exception & exp )
-                {
-                  // bnc #395704: missing catch causes abort.
-                  // TODO see if packageCache fails to handle errors correctly.
-                  ZYPP_CAUGHT( exp );
+                INT << "Deltarpm rebuild deferred twice. Skipping " << deferred.size() << " packages." << endl;
+                for ( const auto & it : deferred )
                   it->stepStage( sat::Transaction::STEP_ERROR );
-                  miss = true;
-                  INT << "Unexpected Error: Skipping cache preload package " << pi->asKind<Package>() << " in commit" << endl;
-                  continue;
-                }
+                miss = true;
               }
             }
             packageCache.preloaded( true ); // try to avoid duplicate infoInCache CBs in commit
@@ -1701,6 +1735,7 @@ namespace zypp
       if ( ! policy_r.dryRun() )
       {
         buildCache();
+        sat::updateSolvFileIndex( solvfilesPath() / "solv" );	// content digest for zypper bash completion
       }
 
       MIL << "TargetImpl::commit(<pool>, " << policy_r << ") returns: " << result << endl;
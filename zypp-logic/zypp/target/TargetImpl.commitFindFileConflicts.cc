@@ -17,6 +17,7 @@ extern "C"
 #include <solv/repo_solv.h>
 #include <solv/repo_rpmdb.h>
 #include <solv/pool_fileconflicts.h>
+#include <solv/solvversion.h>
 }
 #include <iostream>
 #include <unordered_set>
@@ -33,6 +34,7 @@ extern "C"
 
 #include <zypp/target/TargetImpl.h>
 #include <zypp/target/CommitPackageCache.h>
+#include <zypp/target/private/rpmheadercache_p.h>
 
 #include <zypp/ZYppCallbacks.h>
 
@@ -104,14 +106,23 @@ namespace zypp
             Pathname localfile( pkg->cachedLocation() );
             if ( localfile.empty() )
               return nullptr;
+#ifdef LIBSOLVEXT_FEATURE_RPMDB_BYRPMHEADER
+            // Up to 3 visits per package; parse the header just once.
+            _header = RpmHeaderCache::lookup( localfile );
+            if ( ! _header )
+              return nullptr;
+            return ::rpm_byrpmh( _state, _header->get() );
+#else
             AutoDispose<FILE*> fp( ::fopen( localfile.c_str(), "re" ), ::fclose );
             return ::rpm_byfp( _state, fp, localfile.c_str() );
+#endif
           }
         }
 
       private:
         ProgressData & _progress;
         AutoDispose<void*> _state;
+        rpm::RpmHeader::constPtr _header;	// < keep the header passed to rpm_byrpmh alive
         std::unordered_set<sat::detail::IdType> _visited;
         sat::Queue _noFilelist;
       };
@@ -143,11 +143,19 @@ namespace zypp
       Needed to evaluate split provides during Resolver::Upgrade() */
       bool providesFile (const std::string & path_str, const std::string & name_str) const;
 
+      /** Batch version of \ref providesFile */
+      std::vector<bool> providesFile( const std::vector<std::string> & paths_r, const std::string & name_str ) const
+      { return _rpm.hasFile( paths_r, name_str ); }
+
       /** Return name of package owning \a path_str
        * or empty string if no installed package owns \a path_str. */
       std::string whoOwnsFile (const std::string & path_str) const
       { return _rpm.whoOwnsFile (path_str); }
 
+      /** Batch version of \ref whoOwnsFile */
+      std::vector<std::string> whoOwnsFile( const std::vector<std::string> & paths_r ) const
+      { return _rpm.whoOwnsFile( paths_r ); }
+
       /** \copydoc Target::baseProduct() */
       Product::constPtr baseProduct() const;
 
@@ -0,0 +1,56 @@
+/*---------------------------------------------------------------------\
+|                          ____ _   __ __ ___                          |
+|                         |__  / \ / / . \ . \                         |
+|                           / / \ V /|  _/  _/                         |
+|                          / /__ | | | | | |                           |
+|                         /_____||_| |_| |_|                           |
+|                                                                      |
+\---------------------------------------------------------------------*/
+/** \file	zypp/target/private/concurrentscripts_p.h
+ * This file contains private API, it will change without notice.
+ * You have been warned.
+*/
+#ifndef ZYPP_TARGET_PRIVATE_CONCURRENTSCRIPTS_P_H
+#define ZYPP_TARGET_PRIVATE_CONCURRENTSCRIPTS_P_H
+
+#include <functional>
+#include <string>
+#include <vector>
+
+#include <zypp-core/Globals.h>
+
+///////////////////////////////////////////////////////////////////
+namespace zypp
+{
+  ///////////////////////////////////////////////////////////////////
+  namespace target
+  {
+    /** A script executed by \ref executeScriptsConcurrently. */
+    struct ScriptJob
+    {
+      std::string _script;
+      int _npkgs = 1;
+      std::vector<size_t> _after;	///< indices of preceding jobs to wait for
+    };
+
+    /** Execute \a jobs_r in up to \a threads_r worker threads.
+     *
+     * A job starts after all jobs listed in its \c _after are done.
+     * \a runScript_r gets the script, the npkgs argument and a callback
+     * taking the output lines; it returns the script's exit status. If it
+     * throws, the job counts as failed: the exception is appended to its
+     * output and the exit status is \c -1. Jobs waiting for it are run
+     * nevertheless.
+     *
+     * \a report_r gets the index, output and exit status of each job. It
+     * is called in the main thread, in the order of \a jobs_r.
+     */
+    ZYPP_LOCAL void executeScriptsConcurrently( unsigned threads_r, const std::vector<ScriptJob> & jobs_r,
+                                                const std::function<int(const std::string &, int, const std::function<void(const std::string &)> &)> & runScript_r,
+                                                const std::function<void(size_t, const std::vector<std::string> &, int)> & report_r );
+
+  } // namespace target
+  ///////////////////////////////////////////////////////////////////
+} // namespace zypp
+///////////////////////////////////////////////////////////////////
+#endif // ZYPP_TARGET_PRIVATE_CONCURRENTSCRIPTS_P_H
@@ -0,0 +1,82 @@
+/*---------------------------------------------------------------------\
+|                          ____ _   __ __ ___                          |
+|                         |__  / \ / / . \ . \                         |
+|                           / / \ V /|  _/  _/                         |
+|                          / /__ | | | | | |                           |
+|                         /_____||_| |_| |_|                           |
+|                                                                      |
+\---------------------------------------------------------------------*/
+/** \file	zypp/target/private/rpmheadercache_p.h
+ * This file contains private API, it will change without notice.
+ * You have been warned.
+*/
+#ifndef ZYPP_TARGET_PRIVATE_RPMHEADERCACHE_P_H
+#define ZYPP_TARGET_PRIVATE_RPMHEADERCACHE_P_H
+
+#include <memory>
+
+#include <zypp-core/Pathname.h>
+#include <zypp-core/ByteCount.h>
+#include <zypp-core/base/NonCopyable.h>
+#include <zypp/target/rpm/RpmHeader.h>
+
+///////////////////////////////////////////////////////////////////
+namespace zypp
+{
+  ///////////////////////////////////////////////////////////////////
+  namespace target
+  {
+    ///////////////////////////////////////////////////////////////////
+    /// \class RpmHeaderCache
+    /// \brief Per commit cache of rpm headers read from the package cache.
+    ///
+    /// During commit the same package header is needed several times:
+    /// by the file conflicts check (up to 3 visits per package), by the
+    /// %posttrans collector and by the signature check if it needs the
+    /// long key IDs. While a cache is \ref active, those consumers call
+    /// \ref lookup and the package is parsed just once.
+    ///
+    /// Headers are read without verification (\ref rpm::RpmHeader::NOVERIFY);
+    /// the digest and signature checks are done by rpm on the whole file
+    /// anyway. An entry is re-read if size or mtime of the file changed.
+    /// If the cached headers exceed \ref maxSize, the least recently used
+    /// ones are dropped.
+    ///
+    /// \note Only one cache can be active. It must be created and
+    /// destroyed by the main thread.
+    ///////////////////////////////////////////////////////////////////
+    class ZYPP_LOCAL RpmHeaderCache : private base::NonCopyable
+    {
+    public:
+      /** Ctor makes this the \ref active cache. */
+      explicit RpmHeaderCache( ByteCount maxSize_r = ByteCount( 128, ByteCount::MB ) );
+
+      /** Dtor */
+      ~RpmHeaderCache();
+
+      /** The active cache or \c nullptr. */
+      static RpmHeaderCache * active();
+
+      /** Header of the rpm at \a path_r; \c nullptr if it is not a package. */
+      static rpm::RpmHeader::constPtr lookup( const Pathname & path_r );
+
+    public:
+      /** Header of the rpm at \a path_r, parsed on 1st request. */
+      rpm::RpmHeader::constPtr get( const Pathname & path_r );
+
+      /** Max. size of the cached headers. */
+      ByteCount maxSize() const;
+
+      /** Size of the cached headers. */
+      ByteCount size() const;
+
+    private:
+      struct Impl;
+      std::unique_ptr<Impl> _pimpl;
+    };
+
+  } // namespace target
+  ///////////////////////////////////////////////////////////////////
+} // namespace zypp
+///////////////////////////////////////////////////////////////////
+#endif // ZYPP_TARGET_PRIVATE_RPMHEADERCACHE_P_H
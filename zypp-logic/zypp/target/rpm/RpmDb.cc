@@ -18,6 +18,7 @@ extern "C"
 #include <cstdlib>
 #include <cstdio>
 #include <ctime>
+#include <functional>
 
 #include <iostream>
 #include <fstream>
@@ -46,6 +47,7 @@ extern "C"
 #include <zypp/target/rpm/RpmDb.h>
 #include <zypp/target/rpm/RpmCallbacks.h>
 #include <zypp/target/RpmPostTransCollector.h>
+#include <zypp/target/private/rpmheadercache_p.h>
 
 #include <zypp/HistoryLog.h>
 #include <zypp/target/rpm/librpmDb.h>
@@ -1059,6 +1061,79 @@ bool RpmDb::hasPackage( const std::string & name_r, const Edition & ed_r ) const
   return it.findPackage( name_r, ed_r );
 }
 
+///////////////////////////////////////////////////////////////////
+//
+//	Batch queries
+//
+///////////////////////////////////////////////////////////////////
+namespace
+{
+  /** Apply \a lookup_r to each key using the same iterator (database opened once). */
+  template <class TResult, class TLookup>
+  std::vector<TResult> batchLookup( librpmDb::db_const_iterator & it_r, const std::vector<std::string> & keys_r, TLookup && lookup_r )
+  {
+    std::vector<TResult> ret;
+    ret.reserve( keys_r.size() );
+    for ( const std::string & key : keys_r )
+      ret.push_back( std::invoke( lookup_r, it_r, key ) );
+    return ret;
+  }
+
+  template <class TLookup>
+  std::vector<bool> batchFind( librpmDb::db_const_iterator & it_r, const std::vector<std::string> & keys_r, TLookup && lookup_r )
+  { return batchLookup<bool>( it_r, keys_r, std::forward<TLookup>(lookup_r) ); }
+} // namespace
+
+std::vector<bool> RpmDb::hasFile( const std::vector<std::string> & files_r, const std::string & name_r ) const
+{
+  auto it = dbConstIterator();
+  if ( name_r.empty() )
+    return batchFind( it, files_r, &librpmDb::db_const_iterator::findByFile );
+
+  return batchFind( it, files_r, [&name_r]( librpmDb::db_const_iterator & it_r, const std::string & file_r ) {
+    for ( it_r.findByFile( file_r ); *it_r; ++it_r )
+    {
+      if ( it_r->tag_name() == name_r )
+        return true;
+    }
+    return false;
+  } );
+}
+
+std::vector<std::string> RpmDb::whoOwnsFile( const std::vector<std::string> & files_r ) const
+{
+  auto it = dbConstIterator();
+  return batchLookup<std::string>( it, files_r, []( librpmDb::db_const_iterator & it_r, const std::string & file_r ) {
+    return it_r.findByFile( file_r ) ? it_r->tag_name() : std::string();
+  } );
+}
+
+std::vector<bool> RpmDb::hasProvides( const std::vector<std::string> & tags_r ) const
+{
+  auto it = dbConstIterator();
+  return batchFind( it, tags_r, &librpmDb::db_const_iterator::findByProvides );
+}
+
+std::vector<bool> RpmDb::hasRequiredBy( const std::vector<std::string> & tags_r ) const
+{
+  auto it = dbConstIterator();
+  return batchFind( it, tags_r, &librpmDb::db_const_iterator::findByRequiredBy );
+}
+
+std::vector<bool> RpmDb::hasConflicts( const std::vector<std::string> & tags_r ) const
+{
+  auto it = dbConstIterator();
+  return batchFind( it, tags_r, &librpmDb::db_const_iterator::findByConflicts );
+}
+
+std::vector<bool> RpmDb::hasPackage( const std::vector<std::string> & names_r ) const
+{
+  auto it = dbConstIterator();
+  return batchFind( it, names_r, []( librpmDb::db_const_iterator & it_r, const std::string & name_r ) {
+    return it_r.findPackage( name_r );
+  } );
+}
+
 ///////////////////////////////////////////////////////////////////
 //
 //
@@ -1293,7 +1368,7 @@ namespace
             didReadHeader = true;
 
             // Get signature info from the package header, RPM always prints only the 8 byte ID
-            auto header = RpmHeader::readPackage( path_r, RpmHeader::NOVERIFY );
+            auto header = RpmHeaderCache::lookup( path_r );
             if ( header ) {
               auto keyMgr = zypp::KeyManagerCtx::createForOpenPGP();
               const auto &addFprs = [&]( auto tag ){
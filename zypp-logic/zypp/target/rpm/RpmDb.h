@@ -243,6 +243,31 @@ public:
    **/
   bool hasPackage( const std::string & name_r, const Edition & ed_r ) const;
 
+  /** \name Batch queries.
+   * Same as the single key versions above, but all keys are looked up using
+   * one \ref db_const_iterator. The database is opened once and all lookups
+   * see the same state. Results are returned in the order of the keys.
+   */
+  //@{
+  /** Whether at least one package (package \a name_r, if not empty) owns the file. */
+  std::vector<bool> hasFile( const std::vector<std::string> & files_r, const std::string & name_r = "" ) const;
+
+  /** Name of the package owning the file or an empty string. */
+  std::vector<std::string> whoOwnsFile( const std::vector<std::string> & files_r ) const;
+
+  /** Whether at least one package provides the tag. */
+  std::vector<bool> hasProvides( const std::vector<std::string> & tags_r ) const;
+
+  /** Whether at least one package requires the tag. */
+  std::vector<bool> hasRequiredBy( const std::vector<std::string> & tags_r ) const;
+
+  /** Whether at least one package conflicts with the tag. */
+  std::vector<bool> hasConflicts( const std::vector<std::string> & tags_r ) const;
+
+  /** Whether the package is installed. */
+  std::vector<bool> hasPackage( const std::vector<std::string> & names_r ) const;
+  //@}
+
   /**
    * Get an installed packages data from rpmdb. Package is
    * identified by name. Data returned via result are NULL,
@@ -0,0 +1,149 @@
+/*---------------------------------------------------------------------\
+|                          ____ _   __ __ ___                          |
+|                         |__  / \ / / . \ . \                         |
+|                           / / \ V /|  _/  _/                         |
+|                          / /__ | | | | | |                           |
+|                         /_____||_| |_| |_|                           |
+|                                                                      |
+\---------------------------------------------------------------------*/
+/** \file	zypp/target/rpmheadercache.cc
+ *
+*/
+#include <list>
+#include <mutex>
+#include <unordered_map>
+
+#include <zypp/target/private/rpmheadercache_p.h>
+#include <zypp/target/rpm/librpm.h>
+#include <zypp-core/base/Logger.h>
+#include <zypp/PathInfo.h>
+
+using std::endl;
+
+///////////////////////////////////////////////////////////////////
+namespace zypp
+{
+  ///////////////////////////////////////////////////////////////////
+  namespace target
+  {
+    namespace
+    {
+      RpmHeaderCache * _activeCache = nullptr;
+    } // namespace
+
+    struct RpmHeaderCache::Impl
+    {
+      struct Entry
+      {
+        std::string _path;
+        off_t _fsize = 0;
+        time_t _mtime = 0;
+        ByteCount _hsize;
+        rpm::RpmHeader::constPtr _header;
+      };
+      using EntryList = std::list<Entry>;	// < LRU order, most recently used last
+
+      Impl( ByteCount maxSize_r )
+      : _maxSize( maxSize_r )
+      {}
+
+      rpm::RpmHeader::constPtr get( const Pathname & path_r )
+      {
+        PathInfo pi( path_r );
+        if ( ! pi.isFile() )
+          return nullptr;
+
+        std::lock_guard<std::mutex> lk( _m );
+        auto idx { _index.find( path_r.asString() ) };
+        if ( idx != _index.end() )
+        {
+          EntryList::iterator it { idx->second };
+          if ( it->_fsize == pi.size() && it->_mtime == pi.mtime() )
+          {
+            ++_hits;
+            _entries.splice( _entries.end(), _entries, it );
+            return it->_header;
+          }
+          DBG << "Changed on disk: " << path_r << endl;
+          drop( it );
+        }
+
+        ++_misses;
+        Entry entry;
+        entry._path = path_r.asString();
+        entry._fsize = pi.size();
+        entry._mtime = pi.mtime();
+        entry._header = rpm::RpmHeader::readPackage( path_r, rpm::RpmHeader::NOVERIFY );
+        if ( entry._header )
+          entry._hsize = ::headerSizeof( entry._header->get(), HEADER_MAGIC_NO );
+
+        // remember failed reads as well, to avoid retrying them
+        _size += entry._hsize;
+        rpm::RpmHeader::constPtr ret { entry._header };
+        _index[entry._path] = _entries.insert( _entries.end(), std::move(entry) );
+
+        // never drop the entry just added
+        while ( _size > _maxSize && _entries.size() > 1 )
+          drop( _entries.begin() );
+        return ret;
+      }
+
+      void drop( EntryList::iterator it_r )
+      {
+        _size -= it_r->_hsize;
+        _index.erase( it_r->_path );
+        _entries.erase( it_r );
+      }
+
+      const ByteCount _maxSize;
+
+      mutable std::mutex _m;	// < locks all data below
+      EntryList _entries;
+      std::unordered_map<std::string,EntryList::iterator> _index;
+      ByteCount _size;
+      unsigned _hits = 0;
+      unsigned _misses = 0;
+    };
+
+    RpmHeaderCache::RpmHeaderCache( ByteCount maxSize_r )
+    : _pimpl( new Impl( maxSize_r ) )
+    {
+      if ( _activeCache )
+        INT << "Replacing active RpmHeaderCache " << _activeCache << endl;
+      _activeCache = this;
+    }
+
+    RpmHeaderCache::~RpmHeaderCache()
+    {
+      if ( _activeCache == this )
+        _activeCache = nullptr;
+      MIL << "RpmHeaderCache: " << _pimpl->_misses << " headers read, " << _pimpl->_hits << " reused"
+          << " (" << size() << " of max " << maxSize() << " still cached)" << endl;
+    }
+
+    RpmHeaderCache * RpmHeaderCache::active()
+    { return _activeCache; }
+
+    rpm::RpmHeader::constPtr RpmHeaderCache::lookup( const Pathname & path_r )
+    {
+      if ( _activeCache )
+        return _activeCache->get( path_r );
+      return rpm::RpmHeader::readPackage( path_r, rpm::RpmHeader::NOVERIFY );
+    }
+
+    rpm::RpmHeader::constPtr RpmHeaderCache::get( const Pathname & path_r )
+    { return _pimpl->get( path_r ); }
+
+    ByteCount RpmHeaderCache::maxSize() const
+    { return _pimpl->_maxSize; }
+
+    ByteCount RpmHeaderCache::size() const
+    {
+      std::lock_guard<std::mutex> lk( _pimpl->_m );
+      return _pimpl->_size;
+    }
+
+  } // namespace target
+  ///////////////////////////////////////////////////////////////////
+} // namespace zypp
+///////////////////////////////////////////////////////////////////
@@ -281,6 +281,7 @@ function(zypp_add_zypp_target)
 
   zypp_add_sources( zypp_parser_SRCS
     parser/HistoryLogReader.cc
+    parser/historylogindex.cc
     parser/RepoFileReader.cc
     parser/RepoindexFileReader.cc
     parser/ServiceFileReader.cc
@@ -295,6 +296,10 @@ function(zypp_add_zypp_target)
     parser/ProductFileReader.h
   )
 
+  zypp_add_sources( zypp_parser_detail_HEADERS
+    parser/private/historylogindex_p.h
+  )
+
   if( arg_INSTALL_HEADERS )
     INSTALL(  FILES
       ${zypp_parser_HEADERS}
@@ -502,6 +507,7 @@ function(zypp_add_zypp_target)
     target/SolvIdentFile.cc
     target/HardLocksFile.cc
     target/commitpackagepreloader.cc
+    target/rpmheadercache.cc
     target/CommitPackageCache.cc
     target/CommitPackageCacheImpl.cc
     target/CommitPackageCacheReadAhead.cc
@@ -528,6 +534,8 @@ function(zypp_add_zypp_target)
 
   zypp_add_sources( zypp_target_detail_HEADERS
     target/private/commitpackagepreloader_p.h
+    target/private/concurrentscripts_p.h
+    target/private/rpmheadercache_p.h
   )
 
   if( arg_INSTALL_HEADERS )
@@ -641,6 +649,8 @@ function(zypp_add_zypp_target)
     repo/RepoInfoBase.cc
     repo/PluginRepoverification.cc
     repo/PluginServices.cc
+    repo/deltarebuildpool.cc
+    repo/plaindirsolv.cc
   )
 
   zypp_add_sources( zypp_repo_HEADERS
@@ -661,6 +671,11 @@ function(zypp_add_zypp_target)
     repo/PluginServices.h
   )
 
+  zypp_add_sources( zypp_repo_detail_HEADERS
+    repo/private/deltarebuildpool_p.h
+    repo/private/plaindirsolv_p.h
+  )
+
   if( arg_INSTALL_HEADERS )
     INSTALL( FILES
       ${zypp_repo_HEADERS}
@@ -763,6 +778,8 @@ function(zypp_add_zypp_target)
     ${zypp_target_modalias_HEADERS}
     ${zypp_target_HEADERS}
     ${zypp_target_detail_HEADERS}
+    ${zypp_repo_detail_HEADERS}
+    ${zypp_parser_detail_HEADERS}
     ${zypp_pool_HEADERS}
     ${zypp_misc_HEADERS}
     ${zypp_core_compat_HEADERS}
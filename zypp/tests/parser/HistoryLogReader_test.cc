@@ -1,5 +1,9 @@
+#include <fstream>
 #include <tests/lib/TestSetup.h>
 #include <zypp/parser/HistoryLogReader.h>
+#include <zypp/parser/private/historylogindex_p.h>
+#include <zypp/TmpPath.h>
+#include <zypp/PathInfo.h>
 #include <zypp-core/parser/ParseException>
 
 using namespace zypp;
@@ -38,3 +42,73 @@ BOOST_AUTO_TEST_CASE(basic)
   HistoryLogDataInstall::Ptr p = dynamic_pointer_cast<HistoryLogDataInstall>( history[1] );
   BOOST_CHECK_EQUAL( p->userdata(), "trans|ID" ); // properly (un)escaped?
 }
+
+BOOST_AUTO_TEST_CASE(indexed)
+{
+  filesystem::TmpDir tmp;
+  Pathname log { tmp.path() / "history" };
+  BOOST_REQUIRE_EQUAL( filesystem::copy( TESTS_SRC_DIR "/parser/HistoryLogReader_test.dat", log ), 0 );
+
+  std::vector<std::string> names;
+  parser::HistoryLogReader parser( log, parser::HistoryLogReader::IGNORE_INVALID_ITEMS,
+    [&names]( HistoryLogData::Ptr ptr )->bool {
+      names.push_back( (*ptr)[HistoryLogData::ACTION_INDEX+1] );
+      return true;
+    } );
+
+  auto readPackage = [&]( const std::string & name_r ) {
+    names.clear();
+    parser.readPackage( name_r );
+    return names.size();
+  };
+  auto readFrom = [&]( const Date & date_r ) {
+    names.clear();
+    parser.readFrom( date_r );
+    return names;
+  };
+
+  const Pathname & idx { parser::HistoryLogIndex::indexFile( log ) };
+  auto idxTail = [&]() {
+    std::ifstream in( idx.c_str() );
+    std::string line, last;
+    while ( std::getline( in, line ) )
+      last = line;
+    return last;
+  };
+
+  // closing the log does not build the initial index...
+  parser::HistoryLogIndex::update( log );
+  BOOST_CHECK( ! PathInfo( idx ).isExist() );
+
+  // ...the first reader does
+  BOOST_CHECK_EQUAL( readPackage( "PolicyKit-doc" ), 1 );
+  BOOST_REQUIRE( PathInfo( idx ).isFile() );
+  BOOST_CHECK_EQUAL( idxTail(), ( str::Str() << "S " << PathInfo( log ).size() << " " << 15 ).str() );
+  BOOST_CHECK_EQUAL( readPackage( "patch-name" ), 1 );
+  BOOST_CHECK_EQUAL( readPackage( "InstallationImage" ), 0 );	// repo, not a package
+  std::vector<std::string> from { readFrom( Date( "2010-01-01", "%Y-%m-%d" ) ) };
+  BOOST_CHECK_EQUAL( from.size(), 7 );
+
+  // appended lines are added to the index
+  {
+    std::ofstream out( log.c_str(), std::ios::app );
+    out << "2016-01-01 10:00:00|install|PolicyKit-doc|0.9-16.1|x86_64||repo-oss||" << std::endl;
+  }
+  parser::HistoryLogIndex::update( log );
+  BOOST_CHECK_EQUAL( idxTail(), ( str::Str() << "S " << PathInfo( log ).size() << " " << 16 ).str() );
+  BOOST_CHECK_EQUAL( readPackage( "PolicyKit-doc" ), 2 );
+  BOOST_CHECK_EQUAL( readFrom( Date( "2010-01-01", "%Y-%m-%d" ) ).size(), 8 );
+
+  // a replaced log invalidates the index
+  {
+    std::ofstream out( (tmp.path()/"new").c_str() );
+    out << "2017-01-01 10:00:00|remove |PolicyKit-doc|0.9-16.1|x86_64||" << std::endl;
+  }
+  filesystem::rename( tmp.path()/"new", log );
+  std::string staleTail { idxTail() };
+  parser::HistoryLogIndex::update( log );
+  BOOST_CHECK_EQUAL( idxTail(), staleTail );	// rebuilt by the next reader
+  BOOST_CHECK_EQUAL( readPackage( "PolicyKit-doc" ), 1 );
+  BOOST_CHECK_EQUAL( idxTail(), ( str::Str() << "S " << PathInfo( log ).size() << " " << 2 ).str() );
+  BOOST_CHECK_EQUAL( readPackage( "patch-name" ), 0 );
+}
@@ -1,3 +1,4 @@
+#include <fstream>
 #include <sstream>
 #include <string>
 #include <zypp-core/Pathname.h>
@@ -67,3 +68,30 @@ BOOST_AUTO_TEST_CASE(read_index_file)
 
   }
 }
+
+BOOST_AUTO_TEST_CASE(read_index_file_mmap)
+{
+  // An uncompressed file is parsed from memory instead of the stream
+  filesystem::TmpDir tmp;
+  Pathname file { tmp.path()/"repoindex.xml" };
+  {
+    std::ofstream out( file.c_str() );
+    out << service;
+  }
+
+  stringstream input(service);
+  RepoCollector fromstream;
+  parser::RepoindexFileReader( input, bind( &RepoCollector::collect, &fromstream, _1 ) );
+  RepoCollector fromfile;
+  parser::RepoindexFileReader( file, bind( &RepoCollector::collect, &fromfile, _1 ) );
+
+  BOOST_REQUIRE_EQUAL(3, fromfile.repos.size());
+  for ( auto lhs = fromstream.repos.begin(), rhs = fromfile.repos.begin(); rhs != fromfile.repos.end(); ++lhs, ++rhs )
+  {
+    BOOST_CHECK_EQUAL( lhs->alias(), rhs->alias() );
+    BOOST_CHECK_EQUAL( lhs->name(), rhs->name() );
+    BOOST_CHECK_EQUAL( lhs->targetDistribution(), rhs->targetDistribution() );
+    BOOST_CHECK_EQUAL( lhs->priority(), rhs->priority() );
+    BOOST_CHECK_EQUAL( lhs->path(), rhs->path() );
+  }
+}
@@ -0,0 +1,84 @@
+#include <boost/test/unit_test.hpp>
+#include <fstream>
+#include <iostream>
+#include <map>
+
+#include <zypp/PathInfo.h>
+#include <zypp/TmpPath.h>
+#include <zypp/Repository.h>
+#include <zypp/sat/Pool.h>
+#include <zypp/repo/private/plaindirsolv_p.h>
+
+using std::cout;
+using std::endl;
+using namespace zypp;
+using namespace boost::unit_test;
+
+#define DATADIR (Pathname(TESTS_SRC_DIR) + "/zypp/data/RpmPkgSigCheck")
+
+namespace
+{
+  /** path -> line of the plaindir index */
+  std::map<std::string,std::string> readIndex( const Pathname & solvfile_r )
+  {
+    std::map<std::string,std::string> ret;
+    std::ifstream in( repo::plaindirSolvIndex( solvfile_r ).c_str() );
+    std::string line;
+    std::getline( in, line );	// solv file key
+    while ( std::getline( in, line ) )
+      ret[line.substr( line.rfind( ' ' ) + 1 )] = line;
+    return ret;
+  }
+
+  unsigned solvables( const Pathname & solvfile_r )
+  {
+    Repository repo { sat::Pool::instance().addRepoSolv( solvfile_r, "plaindir" ) };
+    unsigned ret = repo.solvablesSize();
+    repo.eraseFromPool();
+    return ret;
+  }
+}
+
+BOOST_AUTO_TEST_CASE(plaindir_solv)
+{
+  filesystem::TmpDir tmp;
+  Pathname dir { tmp.path() / "rpms" };
+  Pathname solvfile { tmp.path() / "solv" };
+  filesystem::assert_dir( dir / "sub" );
+  BOOST_REQUIRE_EQUAL( filesystem::copy( DATADIR / "signed.rpm", dir / "a.rpm" ), 0 );
+  BOOST_REQUIRE_EQUAL( filesystem::copy( DATADIR / "unsigned.rpm", dir / "sub/b.rpm" ), 0 );
+  // not indexed, like repo2solv
+  BOOST_REQUIRE_EQUAL( filesystem::copy( DATADIR / "signed.rpm", dir / ".hidden.rpm" ), 0 );
+  BOOST_REQUIRE_EQUAL( filesystem::copy( DATADIR / "signed.rpm", dir / "c.delta.rpm" ), 0 );
+
+  repo::buildPlaindirSolv( dir, solvfile );
+  auto index { readIndex( solvfile ) };
+  BOOST_CHECK_EQUAL( index.size(), 2U );
+  BOOST_CHECK( index.count( "a.rpm" ) );
+  BOOST_CHECK( index.count( "sub/b.rpm" ) );
+  BOOST_CHECK_EQUAL( solvables( solvfile ), 2U );
+
+  // a new rpm is added, the others are kept
+  BOOST_REQUIRE_EQUAL( filesystem::copy( DATADIR / "signed.rpm", dir / "c.rpm" ), 0 );
+  repo::buildPlaindirSolv( dir, solvfile );
+  auto index2 { readIndex( solvfile ) };
+  BOOST_CHECK_EQUAL( index2.size(), 3U );
+  BOOST_CHECK_EQUAL( index2["a.rpm"], index["a.rpm"] );
+  BOOST_CHECK_EQUAL( index2["sub/b.rpm"], index["sub/b.rpm"] );
+  BOOST_CHECK_EQUAL( solvables( solvfile ), 3U );
+
+  // a removed rpm is dropped
+  BOOST_REQUIRE_EQUAL( filesystem::unlink( dir / "sub/b.rpm" ), 0 );
+  repo::buildPlaindirSolv( dir, solvfile );
+  index = readIndex( solvfile );
+  BOOST_CHECK_EQUAL( index.size(), 2U );
+  BOOST_CHECK( ! index.count( "sub/b.rpm" ) );
+  BOOST_CHECK_EQUAL( solvables( solvfile ), 2U );
+
+  // an index not matching the solv file is ignored
+  BOOST_REQUIRE_EQUAL( filesystem::copy( solvfile, tmp.path() / "other" ), 0 );
+  BOOST_REQUIRE_EQUAL( filesystem::rename( tmp.path() / "other", solvfile ), 0 );
+  repo::buildPlaindirSolv( dir, solvfile );
+  BOOST_CHECK_EQUAL( readIndex( solvfile ).size(), 2U );
+  BOOST_CHECK_EQUAL( solvables( solvfile ), 2U );
+}
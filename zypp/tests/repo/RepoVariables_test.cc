@@ -248,4 +248,25 @@ BOOST_AUTO_TEST_CASE(uncached)
   ::setenv( "ZYPP_REPO_RELEASEVER", "13.3", 1 );
   BOOST_CHECK_EQUAL( replacer1("${releasever}"),	"13.3" );
 }
+
+namespace zyppintern { void repoVariablesReset(); }	// upon re-acquiring the lock...
+
+BOOST_AUTO_TEST_CASE(cached_until_reset)
+{
+  ZConfig::instance().setSystemArchitecture(Arch("i686"));
+  zyppintern::repoVariablesReset();
+  repo::RepoVariablesStringReplacer replacer1;
+  repo::RepoVariablesUrlReplacer replacer2;
+  BOOST_CHECK_EQUAL( replacer1("http://foo/$arch/bar"), "http://foo/i686/bar" );
+  BOOST_CHECK_EQUAL( replacer1("http://foo/$arch/bar"), "http://foo/i686/bar" );
+  BOOST_CHECK_EQUAL( replacer2(Url("http://foo/$arch/bar")), Url("http://foo/i686/bar") );
+  BOOST_CHECK_EQUAL( replacer2(Url("http://foo/$arch/bar")), Url("http://foo/i686/bar") );
+  // same raw url, different credentials
+  BOOST_CHECK_EQUAL( replacer2(Url("http://me:pw@foo/$arch/bar")).asCompleteString(), "http://me:pw@foo/i686/bar" );
+
+  ZConfig::instance().setSystemArchitecture(Arch("x86_64"));
+  zyppintern::repoVariablesReset();
+  BOOST_CHECK_EQUAL( replacer1("http://foo/$arch/bar"), "http://foo/x86_64/bar" );
+  BOOST_CHECK_EQUAL( replacer2(Url("http://foo/$arch/bar")), Url("http://foo/x86_64/bar") );
+}
 // vim: set ts=2 sts=2 sw=2 ai et:
@@ -231,6 +231,36 @@ BOOST_AUTO_TEST_CASE(LookupAttr_repoattr)
   }
 }
 
+BOOST_AUTO_TEST_CASE(LookupAttr_lazy_ext)
+{
+  // Attributes written to a separate ext file are loaded on demand.
+  Repository repo;
+  for_( it, test.satpool().reposBegin(), test.satpool().reposEnd() )
+  {
+    if ( ! it->isSystemRepo() )
+    {
+      repo = *it;
+      break;
+    }
+  }
+  BOOST_REQUIRE( repo );
+  filesystem::TmpDir tmp;
+  repo.writeSolv( tmp.path()/"solv", tmp.path()/"solv.ext" );
+
+  Repository lazy( test.satpool().addRepoSolv( tmp.path()/"solv", "lazy" ) );
+  BOOST_REQUIRE_EQUAL( lazy.solvablesSize(), repo.solvablesSize() );
+
+  sat::LookupAttr q( sat::SolvAttr::description, lazy );
+  sat::LookupAttr o( sat::SolvAttr::description, repo );
+  BOOST_CHECK( ! q.empty() );
+  BOOST_CHECK_EQUAL( q.size(), o.size() );
+  BOOST_CHECK_EQUAL( lazy.solvablesBegin()->lookupStrAttribute( sat::SolvAttr::description ),
+                     repo.solvablesBegin()->lookupStrAttribute( sat::SolvAttr::description ) );
+  // core attributes are still there
+  BOOST_CHECK_EQUAL( lazy.solvablesBegin()->ident(), repo.solvablesBegin()->ident() );
+  lazy.eraseFromPool();
+}
+
 #if 0
 BOOST_AUTO_TEST_CASE(LookupAttr_)
 {
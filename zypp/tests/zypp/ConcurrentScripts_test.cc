@@ -0,0 +1,84 @@
+#include <boost/test/unit_test.hpp>
+#include <atomic>
+#include <iostream>
+#include <stdexcept>
+#include <vector>
+
+#include <zypp/target/private/concurrentscripts_p.h>
+
+using std::cout;
+using std::endl;
+using namespace zypp;
+using namespace zypp::target;
+
+namespace
+{
+  struct Report
+  {
+    size_t _idx;
+    std::vector<std::string> _output;
+    int _ret;
+  };
+
+  std::vector<Report> run( unsigned threads_r, const std::vector<ScriptJob> & jobs_r,
+                           const std::function<int(const std::string &, int, const std::function<void(const std::string &)> &)> & runScript_r )
+  {
+    std::vector<Report> ret;
+    executeScriptsConcurrently( threads_r, jobs_r, runScript_r, [&]( size_t idx_r, const std::vector<std::string> & output_r, int ret_r ) {
+      ret.push_back( Report{ idx_r, output_r, ret_r } );
+    } );
+    return ret;
+  }
+}
+
+BOOST_AUTO_TEST_CASE(order_and_dependencies)
+{
+  std::vector<ScriptJob> jobs( 4 );
+  for ( size_t i = 0; i < jobs.size(); ++i )
+    jobs[i]._script = "s" + std::to_string( i );
+  jobs[3]._after = { 0, 1 };
+
+  std::atomic<unsigned> finished { 0 };
+  auto reports = run( 4, jobs, [&]( const std::string & script_r, int npkgs_r, const std::function<void(const std::string &)> & consume_r ) {
+    if ( script_r == "s3" )
+      consume_r( finished >= 2 ? "after" : "too early" );
+    else
+      ++finished;
+    consume_r( script_r );
+    return npkgs_r - 1;
+  } );
+
+  BOOST_REQUIRE_EQUAL( reports.size(), jobs.size() );
+  for ( size_t i = 0; i < reports.size(); ++i )
+  {
+    BOOST_CHECK_EQUAL( reports[i]._idx, i );
+    BOOST_CHECK_EQUAL( reports[i]._ret, 0 );
+    BOOST_CHECK_EQUAL( reports[i]._output.back(), jobs[i]._script );
+  }
+  BOOST_CHECK_EQUAL( reports[3]._output.front(), "after" );
+}
+
+BOOST_AUTO_TEST_CASE(failing_scripts)
+{
+  // A throwing script must not block the scripts waiting for it.
+  std::vector<ScriptJob> jobs( 3 );
+  jobs[0]._script = "throws";
+  jobs[1]._script = "fails";
+  jobs[1]._after = { 0 };
+  jobs[2]._script = "ok";
+  jobs[2]._after = { 0, 1 };
+
+  auto reports = run( 2, jobs, [&]( const std::string & script_r, int, const std::function<void(const std::string &)> & consume_r ) {
+    consume_r( script_r );
+    if ( script_r == "throws" )
+      throw std::runtime_error( "no shell" );
+    return script_r == "fails" ? 3 : 0;
+  } );
+
+  BOOST_REQUIRE_EQUAL( reports.size(), jobs.size() );
+  BOOST_CHECK_EQUAL( reports[0]._ret, -1 );
+  BOOST_REQUIRE_EQUAL( reports[0]._output.size(), 2U );
+  BOOST_CHECK_EQUAL( reports[0]._output[1], "no shell\n" );
+  BOOST_CHECK_EQUAL( reports[1]._ret, 3 );
+  BOOST_CHECK_EQUAL( reports[2]._ret, 0 );
+}
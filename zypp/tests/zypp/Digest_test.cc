@@ -10,6 +10,7 @@
 #include <zypp-core/base/Logger.h>
 #include <zypp-core/base/Exception.h>
 #include <zypp/PathInfo.h>
+#include <zypp/TmpPath.h>
 #include <zypp/Digest.h>
 
 using boost::unit_test::test_case;
@@ -33,3 +34,40 @@ BOOST_AUTO_TEST_CASE(digest)
   // FIXME i think it should throw
   BOOST_CHECK_EQUAL( Digest::digest( "lalala", str3) , "" );
 }
+
+BOOST_AUTO_TEST_CASE(multidigest)
+{
+  std::string data("I will test the checksum of this");
+
+  MultiDigest md( { Digest::sha1(), Digest::md5(), "lalala" } );
+  BOOST_CHECK( md.names() == std::vector<std::string>({ Digest::sha1(), Digest::md5() }) );
+  BOOST_CHECK( md.update( data.c_str(), data.size() ) );
+  BOOST_CHECK_EQUAL( md.bytesHashed(), ByteCount( data.size() ) );
+  BOOST_CHECK_EQUAL( md.digest( Digest::sha1() ), "142df4277c326f3549520478c188cab6e3b5d042" );
+  BOOST_CHECK_EQUAL( md.digest( Digest::md5() ), "f139a810b84d82d1f29fc53c5e59beae" );
+  BOOST_CHECK_EQUAL( md.digest( "lalala" ), "" );
+
+  // files are mapped or read; both must hash the same as a stream
+  filesystem::TmpDir tmp;
+  for ( size_t size : { size_t(0), data.size(), size_t(3*1024*1024+7) } )
+  {
+    std::string content;
+    while ( content.size() < size )
+      content += data;
+    content.resize( size );
+
+    Pathname file { tmp.path() / "file" };
+    {
+      std::ofstream str( file.c_str() );
+      str << content;
+    }
+
+    auto sums { MultiDigest::fileDigests( { Digest::sha256(), Digest::md5() }, file ) };
+    BOOST_REQUIRE_EQUAL( sums.size(), 2 );
+    BOOST_CHECK_EQUAL( sums[Digest::sha256()], Digest::digest( Digest::sha256(), content ) );
+    BOOST_CHECK_EQUAL( sums[Digest::md5()], Digest::digest( Digest::md5(), content ) );
+    BOOST_CHECK( checksums( file, { "SHA256", "lalala" } ) == (std::map<std::string,std::string>{{ "SHA256", sums[Digest::sha256()] }}) );
+    BOOST_CHECK_EQUAL( checksum( file, "SHA256" ), sums[Digest::sha256()] );
+  }
+  BOOST_CHECK( MultiDigest::fileDigests( { Digest::sha256() }, tmp.path() / "nofile" ).empty() );
+}
@@ -2,9 +2,15 @@
 
 #include <zypp/MediaSetAccess.h>
 #include <zypp/Fetcher.h>
+#include <zypp/ZYppCallbacks.h>
 
 #include <tests/lib/WebServer.h>
 
+#include <atomic>
+#include <fstream>
+#include <map>
+#include <sstream>
+
 #define BOOST_TEST_MODULE fetcher_test
 
 #define DATADIR (Pathname(TESTS_SRC_DIR) + "/zypp/data/Fetcher/remote-site")
@@ -371,6 +377,68 @@ BOOST_AUTO_TEST_CASE(enqueuedir_http)
   web.stop();
 }
 
+BOOST_AUTO_TEST_CASE(fetcher_parallel_http)
+{
+  // With MediaCurl2 the files are downloaded in parallel before they are
+  // provided one by one. Each file is downloaded and reported once, files
+  // found in a cache are not downloaded at all.
+  WebServer web( DATADIR, 10001 );
+  std::map<std::string,std::atomic<unsigned>> requests;
+  std::map<std::string,CheckSum> checksums;
+  for ( const std::string name : { "f1", "f2", "f3", "f4" } )
+  {
+    const std::string content { "content of " + name + "\n" };
+    checksums[name] = CheckSum::sha256( std::istringstream( content ) );
+    web.addRequestHandler( name, [&counter = requests[name], content]( WebServer::Request & req ) {
+      ++counter;
+      req.rout << WebServer::makeResponseString( "200 OK", {}, content );
+    } );
+  }
+  BOOST_REQUIRE( web.start() );
+
+  struct Receiver : public callback::ReceiveReport<media::DownloadProgressReport>
+  {
+    Receiver()
+    { connect(); }
+
+    void start( const Url & file_r, Pathname ) override
+    { ++_started[file_r.getPathName()]; }
+
+    void finish( const Url & file_r, Error error_r, const std::string & ) override
+    { if ( error_r == NO_ERROR ) ++_finished[file_r.getPathName()]; }
+
+    std::map<std::string,unsigned> _started;
+    std::map<std::string,unsigned> _finished;
+  } receiver;
+
+  filesystem::TmpDir cache;
+  filesystem::assert_dir( cache.path() / "handler" );
+  {
+    std::ofstream out( ( cache.path() / "handler/f4" ).c_str() );
+    out << "content of f4\n";
+  }
+
+  Url url { web.url() };
+  url.setQueryParam( "mediahandler", "curl2" );
+  MediaSetAccess media( url, "/" );
+  filesystem::TmpDir dest;
+  Fetcher fetcher;
+  fetcher.addCachePath( cache.path() );
+  for ( const auto & [ name, checksum ] : checksums )
+    fetcher.enqueueDigested( OnMediaLocation( "/handler/" + name ).setChecksum( checksum ) );
+  fetcher.start( dest.path(), media );
+
+  for ( const auto & [ name, checksum ] : checksums )
+  {
+    BOOST_CHECK( filesystem::is_checksum( dest.path() / "handler" / name, checksum ) );
+    const unsigned expect = ( name == "f4" ? 0 : 1 );
+    BOOST_CHECK_EQUAL( requests[name].load(), expect );
+    BOOST_CHECK_EQUAL( receiver._started["/handler/" + name], expect );
+    BOOST_CHECK_EQUAL( receiver._finished["/handler/" + name], expect );
+  }
+  web.stop();
+}
+
 BOOST_AUTO_TEST_SUITE_END();
 
 // vim: set ts=2 sts=2 sw=2 ai et:
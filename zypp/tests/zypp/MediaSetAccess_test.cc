@@ -1,5 +1,12 @@
 #include <stdio.h>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <fstream>
 #include <iostream>
+#include <map>
+#include <mutex>
+#include <sstream>
 #include <boost/test/unit_test.hpp>
 #include <boost/test/parameterized_test.hpp>
 #include <boost/test/unit_test_log.hpp>
@@ -341,4 +348,152 @@ BOOST_AUTO_TEST_CASE(ftp_absolute_path)
   BOOST_CHECK_NO_THROW( setaccess.provideFile ( loc ) );
 }
 
+/*
+ * Prefetching files via MediaCurl2.
+ * The handlers count the requests, a prefetched file is requested once.
+ */
+namespace
+{
+  struct PrefetchServer
+  {
+    PrefetchServer()
+    : _srv( DATADIR / "/src1/cd1", 10003 )
+    {}
+
+    /** Serve \a content_r as /handler/<name_r>, failing the first \a failures_r requests with 404. */
+    void add( const std::string & name_r, const std::string & content_r, unsigned failures_r = 0 )
+    {
+      _srv.addRequestHandler( name_r, [this,name_r,content_r,failures_r]( WebServer::Request & req ) {
+        if ( ++_requests[name_r] <= failures_r )
+          req.rout << WebServer::makeResponseString( "404 Not Found", {}, "" );
+        else
+          req.rout << WebServer::makeResponseString( "200 OK", {}, content_r );
+      } );
+      _requests[name_r];
+    }
+
+    Url url() const
+    {
+      Url ret { _srv.url() };
+      ret.setQueryParam( "mediahandler", "curl2" );
+      return ret;
+    }
+
+    unsigned requests( const std::string & name_r )
+    { return _requests[name_r]; }
+
+    WebServer _srv;
+    std::map<std::string,std::atomic<unsigned>> _requests;
+  };
+
+  OnMediaLocation handlerLocation( const std::string & name_r, const std::string & content_r = std::string() )
+  {
+    OnMediaLocation ret( "/handler/" + name_r );
+    if ( ! content_r.empty() )
+      ret.setChecksum( CheckSum::sha256( std::istringstream( content_r ) ) );
+    return ret;
+  }
+
+  std::string readFile( const Pathname & file_r )
+  {
+    std::ifstream in( file_r.c_str() );
+    return std::string( std::istreambuf_iterator<char>( in ), std::istreambuf_iterator<char>() );
+  }
+}
+
+BOOST_AUTO_TEST_CASE(msa_prefetch_then_provide)
+{
+  PrefetchServer srv;
+  srv.add( "a", "content of a\n" );
+  srv.add( "b", "content of b\n" );
+  BOOST_REQUIRE( srv._srv.start() );
+
+  MediaSetAccess setaccess( srv.url(), "/" );
+  setaccess.prefetch( { handlerLocation( "a", "content of a\n" ), handlerLocation( "b", "content of b\n" ) } );
+  BOOST_CHECK_EQUAL( readFile( setaccess.provideFile( handlerLocation( "a" ) ) ), "content of a\n" );
+  BOOST_CHECK_EQUAL( readFile( setaccess.provideFile( handlerLocation( "b" ) ) ), "content of b\n" );
+  BOOST_CHECK_EQUAL( srv.requests( "a" ), 1U );
+  BOOST_CHECK_EQUAL( srv.requests( "b" ), 1U );
+
+  // taken files are forgotten, providing again downloads again
+  setaccess.releaseFile( handlerLocation( "a" ) );
+  BOOST_CHECK_EQUAL( readFile( setaccess.provideFile( handlerLocation( "a" ) ) ), "content of a\n" );
+  BOOST_CHECK_EQUAL( srv.requests( "a" ), 2U );
+  srv._srv.stop();
+}
+
+BOOST_AUTO_TEST_CASE(msa_prefetch_failed)
+{
+  // a failed prefetch is silently downloaded again by provideFile
+  PrefetchServer srv;
+  srv.add( "flaky", "content of flaky\n", 1 );
+  srv.add( "missing", "", 2 );
+  BOOST_REQUIRE( srv._srv.start() );
+
+  MediaSetAccess setaccess( srv.url(), "/" );
+  setaccess.prefetch( { handlerLocation( "flaky" ), handlerLocation( "missing" ) } );
+  BOOST_CHECK_EQUAL( readFile( setaccess.provideFile( handlerLocation( "flaky" ) ) ), "content of flaky\n" );
+  BOOST_CHECK_EQUAL( srv.requests( "flaky" ), 2U );
+  // the error is reported by provideFile
+  BOOST_CHECK_THROW( setaccess.provideFile( handlerLocation( "missing" ) ), media::MediaFileNotFoundException );
+  BOOST_CHECK_EQUAL( srv.requests( "missing" ), 2U );
+  srv._srv.stop();
+}
+
+BOOST_AUTO_TEST_CASE(msa_prefetch_checksum_mismatch)
+{
+  // a prefetched file not matching its checksum is not used
+  PrefetchServer srv;
+  srv.add( "a", "content of a\n" );
+  srv.add( "b", "content of b\n" );
+  BOOST_REQUIRE( srv._srv.start() );
+
+  MediaSetAccess setaccess( srv.url(), "/" );
+  setaccess.prefetch( { handlerLocation( "a", "something else\n" ), handlerLocation( "b", "content of b\n" ) } );
+  const Pathname & file { setaccess.provideFile( handlerLocation( "a" ) ) };
+  BOOST_CHECK_EQUAL( readFile( file ), "content of a\n" );
+  BOOST_CHECK_EQUAL( srv.requests( "a" ), 2U );
+  BOOST_CHECK_EQUAL( readFile( setaccess.provideFile( handlerLocation( "b" ) ) ), "content of b\n" );
+  BOOST_CHECK_EQUAL( srv.requests( "b" ), 1U );
+  srv._srv.stop();
+}
+
+BOOST_AUTO_TEST_CASE(msa_prefetch_release_pending)
+{
+  // releasing the media cancels pending downloads instead of waiting for them
+  PrefetchServer srv;
+  std::mutex lock;
+  std::condition_variable cv;
+  bool started = false;
+  bool released = false;
+  srv._srv.addRequestHandler( "slow", [&]( WebServer::Request & req ) {
+    std::unique_lock<std::mutex> lk( lock );
+    started = true;
+    cv.notify_all();
+    cv.wait_for( lk, std::chrono::seconds(10), [&]() { return released; } );
+    req.rout << WebServer::makeResponseString( "200 OK", {}, "slow content\n" );
+  } );
+  BOOST_REQUIRE( srv._srv.start() );
+
+  MediaSetAccess setaccess( srv.url(), "/" );
+  setaccess.prefetch( { handlerLocation( "slow" ) } );
+  {
+    std::unique_lock<std::mutex> lk( lock );
+    BOOST_REQUIRE( cv.wait_for( lk, std::chrono::seconds(10), [&]() { return started; } ) );
+  }
+
+  const auto & begin { std::chrono::steady_clock::now() };
+  setaccess.release();
+  BOOST_CHECK( std::chrono::steady_clock::now() - begin < std::chrono::seconds(5) );
+  {
+    std::lock_guard<std::mutex> lk( lock );
+    released = true;
+  }
+  cv.notify_all();
+
+  // the media can be used again afterwards
+  BOOST_CHECK_EQUAL( readFile( setaccess.provideFile( handlerLocation( "slow" ) ) ), "slow content\n" );
+  srv._srv.stop();
+}
+
 // vim: set ts=2 sts=2 sw=2 ai et:
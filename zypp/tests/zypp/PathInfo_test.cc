@@ -9,8 +9,10 @@
 #include <zypp-core/base/Logger.h>
 #include <zypp-core/base/LogControl.h>
 #include <zypp-core/base/Exception.h>
+#include <zypp-core/base/String.h>
 #include <zypp/PathInfo.h>
 #include <zypp/TmpPath.h>
+#include <zypp-core/fs/RememberedChecksums_p.h>
 
 using boost::unit_test::test_suite;
 using boost::unit_test::test_case;
@@ -211,3 +213,126 @@ BOOST_AUTO_TEST_CASE(test_exchange)
   BOOST_CHECK( PathInfo(a).isFile() );
   BOOST_CHECK( PathInfo(b).isDir() );
 }
+
+BOOST_AUTO_TEST_CASE(test_copy)
+{
+  TmpDir root;
+  Pathname src( root/"src" );
+  filesystem::assert_dir( src/"sub" );
+  {
+    std::ofstream( (src/"file").c_str() ) << "file" << endl;
+    std::ofstream( (src/"sub/exec").c_str() ) << "exec" << endl;
+  }
+  filesystem::chmod( src/"sub/exec", 0750 );
+  BOOST_CHECK_EQUAL( filesystem::hardlink( src/"file", src/"sub/hardlink" ), 0 );
+  BOOST_CHECK_EQUAL( filesystem::symlink( "../file", src/"sub/symlink" ), 0 );
+
+  // copy to file
+  Pathname dest( root/"dest" );
+  BOOST_CHECK_EQUAL( filesystem::copy( src/"file", dest ), 0 );
+  BOOST_CHECK_EQUAL( filesystem::md5sum( dest ), filesystem::md5sum( src/"file" ) );
+  BOOST_CHECK_EQUAL( filesystem::copy( src/"sub/exec", dest ), 0 );	// replaces dest
+  BOOST_CHECK_EQUAL( filesystem::md5sum( dest ), filesystem::md5sum( src/"sub/exec" ) );
+  BOOST_CHECK_EQUAL( filesystem::copy( src/"sub", dest ), EINVAL );
+  BOOST_CHECK_EQUAL( filesystem::copy( src/"file", root ), EISDIR );
+
+  // copy onto itself or a hardlink to it is refused, and the file left intact
+  BOOST_CHECK_EQUAL( filesystem::copy( src/"file", src/"file" ), EEXIST );
+  BOOST_CHECK_EQUAL( filesystem::copy( src/"file", src/"sub/hardlink" ), EEXIST );
+  BOOST_CHECK_EQUAL( filesystem::copy_file2dir( src/"file", src ), EEXIST );
+  BOOST_CHECK_EQUAL( PathInfo( src/"file" ).size(), 5 );
+
+  // copy to dir
+  BOOST_CHECK_EQUAL( filesystem::copy_file2dir( src/"file", root ), 0 );
+  BOOST_CHECK_EQUAL( filesystem::md5sum( root/"file" ), filesystem::md5sum( src/"file" ) );
+
+  // copy trees like 'cp -dR'
+  auto checkTree = []( const Pathname & tree_r ) {
+    BOOST_CHECK_EQUAL( filesystem::md5sum( tree_r/"file" ), filesystem::md5sum( tree_r/"sub/hardlink" ) );
+    BOOST_CHECK_EQUAL( PathInfo( tree_r/"file" ).ino(), PathInfo( tree_r/"sub/hardlink" ).ino() );
+    BOOST_CHECK( PathInfo( tree_r/"sub/exec" ).hasPerm( 0700 ) );
+    BOOST_CHECK( PathInfo( tree_r/"sub/symlink", PathInfo::LSTAT ).isLink() );
+    BOOST_CHECK_EQUAL( filesystem::readlink( tree_r/"sub/symlink" ), Pathname("../file") );
+  };
+
+  filesystem::assert_dir( root/"dir" );
+  BOOST_CHECK_EQUAL( filesystem::copy_dir( src, root/"dir" ), 0 );
+  checkTree( root/"dir/src" );
+  BOOST_CHECK_EQUAL( filesystem::copy_dir( src, root/"dir" ), EEXIST );
+
+  filesystem::assert_dir( root/"content" );
+  BOOST_CHECK_EQUAL( filesystem::copy_dir_content( src, root/"content", 4 ), 0 );
+  checkTree( root/"content" );
+  BOOST_CHECK_EQUAL( filesystem::copy_dir_content( src, root/"content", 4 ), 0 );	// overwrites
+  checkTree( root/"content" );
+}
+
+BOOST_AUTO_TEST_CASE(test_readdir_types)
+{
+  // enough entries to get them stat'ed in parallel
+  TmpDir root;
+  filesystem::assert_dir( root/"sub" );
+  for ( unsigned i = 0; i < 300; ++i )
+  {
+    const std::string name { str::numstring( i ) };
+    if ( i % 3 == 0 )
+      std::ofstream( (root/name).c_str() ) << name << endl;
+    else if ( i % 3 == 1 )
+      filesystem::symlink( "sub", root/name );
+    else
+      filesystem::symlink( "nowhere", root/name );
+  }
+
+  std::list<std::string> names;
+  BOOST_REQUIRE_EQUAL( filesystem::readdir( names, root, false ), 0 );
+
+  for ( PathInfo::Mode mode : { PathInfo::STAT, PathInfo::LSTAT } )
+  {
+    DirContent content;
+    BOOST_REQUIRE_EQUAL( filesystem::readdir( content, root, false, mode ), 0 );
+    BOOST_REQUIRE_EQUAL( content.size(), names.size() );
+
+    auto name = names.begin();
+    for ( const DirEntry & entry : content )
+    {
+      BOOST_CHECK_EQUAL( entry.name, *name );
+      BOOST_CHECK_EQUAL( entry.type, PathInfo( root/entry.name, mode ).fileType() );
+      ++name;
+    }
+  }
+}
+
+BOOST_AUTO_TEST_CASE(test_remembered_checksum)
+{
+  TmpFile file;
+  {
+    std::ofstream str( file.path().c_str() );
+    str << "I will test the checksum of this";
+  }
+  const std::string realsum { checksum( file.path(), "sha1" ) };
+  BOOST_REQUIRE( !realsum.empty() );
+
+  // a remembered checksum is used as long as the file is unchanged
+  const CheckSum fake { CheckSum::sha1( "f1d2d2f924e986ac86fdf7b36c94bcdf32beec15" ) };
+  rememberChecksum( file.path(), fake );
+  BOOST_CHECK_EQUAL( checksum( file.path(), "sha1" ), fake.checksum() );
+  BOOST_CHECK_EQUAL( checksum( file.path(), "SHA1" ), fake.checksum() );
+  BOOST_CHECK( is_checksum( file.path(), fake ) );
+  BOOST_CHECK_EQUAL( rememberedChecksum( file.path(), "md5" ), std::string() );
+
+  // touching the file invalidates it
+  BOOST_REQUIRE_EQUAL( ::chmod( file.path().c_str(), 0600 ), 0 );
+  BOOST_CHECK_EQUAL( checksum( file.path(), "sha1" ), realsum );
+  BOOST_CHECK_EQUAL( rememberedChecksum( file.path(), "sha1" ), std::string() );
+
+  rememberChecksum( file.path(), fake );
+  {
+    std::ofstream str( file.path().c_str(), std::ios::app );
+    str << "!";
+  }
+  BOOST_CHECK( checksum( file.path(), "sha1" ) != fake.checksum() );
+
+  rememberChecksum( file.path(), fake );
+  clearRememberedChecksums();
+  BOOST_CHECK_EQUAL( rememberedChecksum( file.path(), "sha1" ), std::string() );
+}
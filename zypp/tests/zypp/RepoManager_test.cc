@@ -1,8 +1,11 @@
 
 #include <iostream>
 #include <fstream>
+#include <fcntl.h>
+#include <sys/stat.h>
 #include <list>
 #include <string>
+#include <vector>
 
 #include <zypp-core/base/LogTools.h>
 #include <zypp-core/base/Exception.h>
@@ -11,9 +14,16 @@
 #include <zypp/TmpPath.h>
 #include <zypp/PathInfo.h>
 #include <zypp/ServiceInfo.h>
+#include <zypp/ZConfig.h>
+#include <zypp/sat/Pool.h>
 
 #include <zypp/RepoManager.h>
 
+extern "C"
+{
+#include <solv/solvversion.h>
+}
+
 #include <tests/lib/TestSetup.h>
 
 #include <boost/test/unit_test.hpp>
@@ -274,6 +284,265 @@ BOOST_AUTO_TEST_CASE(repomanager_test)
 
 }
 
+BOOST_AUTO_TEST_CASE(load_repos_from_cache)
+{
+  TmpDir tmpCachePath;
+  RepoManagerOptions opts( RepoManagerOptions::makeTestSetup( tmpCachePath ) ) ;
+  filesystem::mkdir( opts.knownReposPath );
+  RepoManager manager(opts);
+
+  KeyRingTestReceiver keyring_callbacks;
+  keyring_callbacks.answerAcceptKey(KeyRingReport::KEY_TRUST_TEMPORARILY);
+  keyring_callbacks.answerAcceptVerFailed(true);
+  keyring_callbacks.answerAcceptUnknownKey(true);
+
+  std::vector<RepoInfo> repos( 3 );
+  const char * aliases[] = { "foo", "bar", "baz" };
+  for ( unsigned i = 0; i < repos.size(); ++i )
+  {
+    repos[i].setAlias( aliases[i] );
+    repos[i].setBaseUrl( (Pathname(TESTS_SRC_DIR) / "/repo/yum/data/10.2-updates-subset").asDirUrl() );
+    manager.buildCache( repos[i] );
+  }
+
+  sat::Pool pool { sat::Pool::instance() };
+  pool.reposEraseAll();
+  int lastProgress = -1;
+  manager.loadFromCache( repos, [&]( const ProgressData & p ) { lastProgress = p.reportValue(); return true; } );
+  BOOST_CHECK_EQUAL( lastProgress, 100 );
+  BOOST_REQUIRE_EQUAL( pool.reposSize(), repos.size() );
+  // in the given order, like loading them one by one
+  auto it = pool.reposBegin();
+  for ( const RepoInfo & info : repos )
+  {
+    BOOST_CHECK_EQUAL( it->alias(), info.alias() );
+    BOOST_CHECK( it->solvablesSize() > 0 );
+    BOOST_CHECK_EQUAL( it->solvablesSize(), pool.reposBegin()->solvablesSize() );
+    // no snapshot unless $ZYPP_POOL_SNAPSHOT is set
+    BOOST_CHECK( ! PathInfo( opts.repoCachePath / "solv" / info.alias() / "solv.snapshot" ).isExist() );
+    ++it;
+  }
+
+  // loading stops at the 1st repo which can't be loaded
+  pool.reposEraseAll();
+  RepoInfo broken;
+  broken.setAlias( "broken" );
+  broken.setBaseUrl( (tmpCachePath.path() / "nothing_here").asDirUrl() );
+  BOOST_CHECK_THROW( manager.loadFromCache( std::vector<RepoInfo>{ repos[0], broken, repos[1] } ), Exception );
+  BOOST_CHECK_EQUAL( pool.reposSize(), 1U );
+  BOOST_CHECK_EQUAL( pool.reposBegin()->alias(), repos[0].alias() );
+  pool.reposEraseAll();
+}
+
+BOOST_AUTO_TEST_CASE(solv_snapshot)
+{
+  TmpDir tmpCachePath;
+  RepoManagerOptions opts( RepoManagerOptions::makeTestSetup( tmpCachePath ) ) ;
+  filesystem::mkdir( opts.knownReposPath );
+  RepoManager manager(opts);
+
+  KeyRingTestReceiver keyring_callbacks;
+  keyring_callbacks.answerAcceptKey(KeyRingReport::KEY_TRUST_TEMPORARILY);
+  keyring_callbacks.answerAcceptVerFailed(true);
+  keyring_callbacks.answerAcceptUnknownKey(true);
+
+  RepoInfo repo;
+  repo.setAlias( "foo" );
+  repo.setBaseUrl( (Pathname(TESTS_SRC_DIR) / "/repo/yum/data/10.2-updates-subset").asDirUrl() );
+  manager.buildCache( repo );
+
+  const Pathname solvfile { opts.repoCachePath / "solv" / repo.alias() / "solv" };
+  const Pathname snapshot { solvfile.extend( ".snapshot" ) };
+  const Pathname keyfile { solvfile.extend( ".snapshot.key" ) };
+  const auto & readKey = [&keyfile]() {
+    std::ifstream in( keyfile.c_str() );
+    return str::getline( in );
+  };
+  const auto & solvables = []() {
+    sat::Pool pool { sat::Pool::instance() };
+    return pool.reposBegin()->solvablesSize();
+  };
+  sat::Pool::instance().reposEraseAll();
+
+  ::setenv( "ZYPP_POOL_SNAPSHOT", "1", 1 );
+
+  // the 1st load writes the snapshot
+  manager.loadFromCache( repo );
+  BOOST_REQUIRE( PathInfo( snapshot ).isFile() );
+  const std::string key { readKey() };
+  const PathInfo solvinfo( solvfile );
+  BOOST_CHECK_EQUAL( key, ( str::Str() << solvinfo.ino() << ":" << solvinfo.size() << ":" << solvinfo.mtime()
+                                       << ":" << ZConfig::instance().systemArchitecture()
+                                       << ":" << LIBSOLV_TOOLVERSION << ":full" ).str() );
+  const unsigned loaded { solvables() };
+  BOOST_CHECK( loaded > 0 );
+
+  // the next one uses it
+  const ino_t snapshotIno { PathInfo( snapshot ).ino() };
+  manager.loadFromCache( repo );
+  BOOST_CHECK_EQUAL( PathInfo( snapshot ).ino(), snapshotIno );
+  BOOST_CHECK_EQUAL( solvables(), loaded );
+
+  // a changed solv file invalidates it
+  struct ::timespec times[2] = { { 0, UTIME_OMIT }, { solvinfo.mtime() + 10, 0 } };
+  BOOST_REQUIRE_EQUAL( ::utimensat( AT_FDCWD, solvfile.c_str(), times, 0 ), 0 );
+  manager.loadFromCache( repo );
+  BOOST_CHECK( PathInfo( snapshot ).ino() != snapshotIno );
+  BOOST_CHECK( readKey() != key );
+  BOOST_CHECK_EQUAL( solvables(), loaded );
+
+  // as does a different system architecture
+  const std::string & key2 { readKey() };
+  ZConfig::instance().setSystemArchitecture( Arch_i586 );
+  manager.loadFromCache( repo );
+  BOOST_CHECK( readKey() != key2 );
+  BOOST_CHECK( str::hasSuffix( readKey(), ":full" ) );
+  ZConfig::instance().resetSystemArchitecture();
+
+  // a damaged key file as well
+  {
+    std::ofstream out( keyfile.c_str() );
+    out << "garbage" << endl;
+  }
+  manager.loadFromCache( repo );
+  BOOST_CHECK( str::hasPrefix( readKey(), str::numstring( PathInfo( solvfile ).ino() ) + ":" ) );
+  BOOST_CHECK_EQUAL( solvables(), loaded );
+
+  // cleanCache removes it
+  manager.cleanCache( repo );
+  BOOST_CHECK( ! PathInfo( snapshot ).isExist() );
+  BOOST_CHECK( ! PathInfo( keyfile ).isExist() );
+
+  ::unsetenv( "ZYPP_POOL_SNAPSHOT" );
+  sat::Pool::instance().reposEraseAll();
+}
+
+BOOST_AUTO_TEST_CASE(solv_snapshot_lazy)
+{
+  TmpDir tmpCachePath;
+  RepoManagerOptions opts( RepoManagerOptions::makeTestSetup( tmpCachePath ) ) ;
+  filesystem::mkdir( opts.knownReposPath );
+  RepoManager manager(opts);
+
+  KeyRingTestReceiver keyring_callbacks;
+  keyring_callbacks.answerAcceptKey(KeyRingReport::KEY_TRUST_TEMPORARILY);
+  keyring_callbacks.answerAcceptVerFailed(true);
+  keyring_callbacks.answerAcceptUnknownKey(true);
+
+  RepoInfo repo;
+  repo.setAlias( "foo" );
+  repo.setBaseUrl( (Pathname(TESTS_SRC_DIR) / "/repo/yum/data/10.2-updates-subset").asDirUrl() );
+  manager.buildCache( repo );
+
+  const Pathname solvfile { opts.repoCachePath / "solv" / repo.alias() / "solv" };
+  const Pathname snapshot { solvfile.extend( ".snapshot" ) };
+  const Pathname extfile { solvfile.extend( ".snapshot.ext" ) };
+  const auto & descriptions = []() {
+    std::string ret;
+    for ( const auto & solv : sat::Pool::instance().reposBegin()->solvables() )
+      ret += solv.description();
+    return ret;
+  };
+  sat::Pool::instance().reposEraseAll();
+
+  ::setenv( "ZYPP_SOLV_LAZY_ATTRS", "1", 1 );
+
+  // the 1st load writes snapshot and ext file
+  manager.loadFromCache( repo );
+  BOOST_REQUIRE( PathInfo( snapshot ).isFile() );
+  BOOST_REQUIRE( PathInfo( extfile ).isFile() );
+  const std::string expected { descriptions() };
+  BOOST_REQUIRE( ! expected.empty() );
+
+  // the next one uses them
+  const ino_t snapshotIno { PathInfo( snapshot ).ino() };
+  manager.loadFromCache( repo );
+  BOOST_CHECK_EQUAL( PathInfo( snapshot ).ino(), snapshotIno );
+  BOOST_CHECK_EQUAL( descriptions(), expected );
+
+  // the ext file is opened along with the snapshot, so replacing it
+  // does not affect the loaded repo, nor is the replacement removed
+  manager.loadFromCache( repo );
+  {
+    std::ofstream out( extfile.extend( ".new" ).c_str() );
+    out << "garbage";
+  }
+  BOOST_REQUIRE_EQUAL( filesystem::rename( extfile.extend( ".new" ), extfile ), 0 );
+  BOOST_CHECK_EQUAL( descriptions(), expected );
+  BOOST_CHECK_EQUAL( PathInfo( extfile ).size(), 7 );
+
+  // a missing ext file invalidates the snapshot
+  BOOST_REQUIRE_EQUAL( filesystem::unlink( extfile ), 0 );
+  manager.loadFromCache( repo );
+  BOOST_CHECK( PathInfo( snapshot ).ino() != snapshotIno );
+  BOOST_CHECK( PathInfo( extfile ).isFile() );
+  BOOST_CHECK_EQUAL( descriptions(), expected );
+
+  // a corrupt one is removed when loading from it fails...
+  const PathInfo extinfo( extfile );
+  {
+    std::fstream out( extfile.c_str(), std::ios::in|std::ios::out|std::ios::binary );
+    out << std::string( extinfo.size(), 'x' );
+  }
+  struct ::timespec times[2] = { { 0, UTIME_OMIT }, { extinfo.mtime(), 0 } };
+  BOOST_REQUIRE_EQUAL( ::utimensat( AT_FDCWD, extfile.c_str(), times, 0 ), 0 );
+  const ino_t snapshotIno2 { PathInfo( snapshot ).ino() };
+  manager.loadFromCache( repo );
+  BOOST_CHECK_EQUAL( PathInfo( snapshot ).ino(), snapshotIno2 );
+  BOOST_CHECK( descriptions().empty() );
+  BOOST_CHECK( ! PathInfo( extfile ).isExist() );
+
+  // ...and the snapshot is rebuilt on the next load
+  manager.loadFromCache( repo );
+  BOOST_CHECK( PathInfo( snapshot ).ino() != snapshotIno2 );
+  BOOST_CHECK_EQUAL( descriptions(), expected );
+
+  ::unsetenv( "ZYPP_SOLV_LAZY_ATTRS" );
+  sat::Pool::instance().reposEraseAll();
+}
+
+BOOST_AUTO_TEST_CASE(plaindir_rebuild)
+{
+  TmpDir tmpCachePath;
+  RepoManagerOptions opts( RepoManagerOptions::makeTestSetup( tmpCachePath ) ) ;
+  filesystem::mkdir( opts.knownReposPath );
+  RepoManager manager(opts);
+
+  const Pathname datadir { Pathname(TESTS_SRC_DIR) / "zypp/data/RpmPkgSigCheck" };
+  TmpDir rpmdir;
+  const Pathname arpm { rpmdir.path() / "a.rpm" };
+  BOOST_REQUIRE_EQUAL( filesystem::copy( datadir / "signed.rpm", arpm ), 0 );
+
+  RepoInfo repo;
+  repo.setAlias( "plaindir" );
+  repo.setType( repo::RepoType::RPMPLAINDIR );
+  repo.setBaseUrl( rpmdir.path().asDirUrl() );
+  const auto & solvables = [&]() {
+    sat::Pool::instance().reposEraseAll();
+    manager.loadFromCache( repo );
+    return sat::Pool::instance().reposBegin()->solvablesSize();
+  };
+
+  manager.buildCache( repo );
+  BOOST_CHECK_EQUAL( solvables(), 1U );
+
+  // Garble a.rpm keeping size and mtime: it's still in the cache only if it is not read again.
+  const PathInfo ainfo( arpm );
+  {
+    std::fstream out( arpm.c_str(), std::ios::in|std::ios::out|std::ios::binary );
+    out << std::string( ainfo.size(), 'x' );
+  }
+  struct ::timespec times[2] = { { 0, UTIME_OMIT }, { ainfo.mtime(), 0 } };
+  BOOST_REQUIRE_EQUAL( ::utimensat( AT_FDCWD, arpm.c_str(), times, 0 ), 0 );
+  BOOST_REQUIRE_EQUAL( filesystem::copy( datadir / "unsigned.rpm", rpmdir.path() / "b.rpm" ), 0 );
+
+  // A rebuild cleans the cache, but just the new b.rpm is read
+  manager.buildCache( repo, RepoManager::BuildForced );
+  BOOST_CHECK_EQUAL( solvables(), 2U );
+
+  sat::Pool::instance().reposEraseAll();
+}
+
 BOOST_AUTO_TEST_CASE(repo_seting_test)
 {
   RepoInfo repo;
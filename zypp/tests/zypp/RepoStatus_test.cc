@@ -5,6 +5,9 @@
 #include <zypp/RepoStatus.h>
 #include <zypp/PathInfo.h>
 
+#include <fstream>
+#include <sstream>
+
 #include <boost/test/unit_test.hpp>
 
 using boost::unit_test::test_suite;
@@ -54,3 +57,48 @@ BOOST_AUTO_TEST_CASE(repostatus_test)
   BOOST_CHECK_EQUAL( r, a && (b && c) );
   BOOST_CHECK_EQUAL( r.timestamp(), c.timestamp() );	// max timestamp
 }
+
+BOOST_AUTO_TEST_CASE(repostatus_fingerprint)
+{
+  TmpDir tmp;
+  Pathname file { tmp.path()/"repomd.xml" };
+  Pathname cookie { tmp.path()/"cookie" };
+  {
+    std::ofstream str( file.c_str() );
+    str << "content" << std::endl;
+  }
+
+  RepoStatus s { file };
+  s.saveToCookieFile( cookie );
+  RepoStatus c { RepoStatus::fromCookieFile( cookie ) };
+  BOOST_CHECK_EQUAL( c, s );
+  BOOST_CHECK_EQUAL( RepoStatus( file, c ), s );
+
+  // A matching fingerprint is trusted; prove it by faking the remembered checksum.
+  std::string line;
+  std::string fake;
+  {
+    std::ifstream str( cookie.c_str() );
+    std::getline( str, line );
+    std::string tag, sum;
+    std::getline( str, fake );
+    std::istringstream( fake ) >> tag >> sum;
+    BOOST_CHECK_EQUAL( tag, "#fingerprint" );
+    fake.replace( fake.find( sum ), sum.size(), std::string( sum.size(), '0' ) );
+  }
+  {
+    std::ofstream str( cookie.c_str() );
+    str << line << std::endl << fake << std::endl;
+  }
+  c = RepoStatus::fromCookieFile( cookie );
+  BOOST_CHECK_EQUAL( c, s );	// status line is unchanged
+  BOOST_CHECK( RepoStatus( file, c ) != s );
+
+  // Changed file: checksummed again
+  {
+    std::ofstream str( file.c_str() );
+    str << "changed content" << std::endl;
+  }
+  BOOST_CHECK_EQUAL( RepoStatus( file, c ), RepoStatus( file ) );
+  BOOST_CHECK( RepoStatus( file ) != s );
+}
@@ -0,0 +1,117 @@
+#include <boost/test/unit_test.hpp>
+#include <iostream>
+#include <fcntl.h>
+#include <sys/stat.h>
+
+#include <zypp/PathInfo.h>
+#include <zypp/TmpPath.h>
+#include <zypp/target/private/rpmheadercache_p.h>
+
+using std::cout;
+using std::endl;
+using namespace zypp;
+using namespace zypp::target;
+
+#define DATADIR (Pathname(TESTS_SRC_DIR) / "/zypp/data/RpmPkgSigCheck")
+
+namespace
+{
+  /** Size of the header of \a rpm_r as accounted by the cache (call it while no other cache exists). */
+  ByteCount headerSize( const Pathname & rpm_r )
+  {
+    RpmHeaderCache cache;
+    BOOST_REQUIRE( cache.get( rpm_r ) );
+    return cache.size();
+  }
+}
+
+BOOST_AUTO_TEST_CASE(active_cache)
+{
+  BOOST_CHECK( ! RpmHeaderCache::active() );
+  {
+    RpmHeaderCache cache;
+    BOOST_CHECK_EQUAL( RpmHeaderCache::active(), &cache );
+    BOOST_CHECK_EQUAL( cache.maxSize(), ByteCount( 128, ByteCount::MB ) );
+
+    auto h { RpmHeaderCache::lookup( DATADIR / "signed.rpm" ) };
+    BOOST_REQUIRE( h );
+    BOOST_CHECK_EQUAL( RpmHeaderCache::lookup( DATADIR / "signed.rpm" ).get(), h.get() );
+    BOOST_CHECK( cache.size() > 0 );
+
+    BOOST_CHECK( ! RpmHeaderCache::lookup( DATADIR / "no.rpm" ) );
+    BOOST_CHECK( ! RpmHeaderCache::lookup( DATADIR / "missing.rpm" ) );
+  }
+  BOOST_CHECK( ! RpmHeaderCache::active() );
+  // without active cache headers are read each time
+  BOOST_CHECK( RpmHeaderCache::lookup( DATADIR / "signed.rpm" ) );
+}
+
+BOOST_AUTO_TEST_CASE(lru_eviction)
+{
+  filesystem::TmpDir tmp;
+  for ( const char * name : { "a.rpm", "b.rpm", "c.rpm" } )
+    BOOST_REQUIRE_EQUAL( filesystem::copy( DATADIR / "signed.rpm", tmp.path() / name ), 0 );
+  const ByteCount hsize { headerSize( tmp.path() / "a.rpm" ) };
+
+  RpmHeaderCache cache( ByteCount( 2 * hsize ) );
+  auto a { cache.get( tmp.path() / "a.rpm" ) };
+  auto b { cache.get( tmp.path() / "b.rpm" ) };
+  BOOST_CHECK_EQUAL( cache.size(), ByteCount( 2 * hsize ) );
+  BOOST_CHECK_EQUAL( cache.get( tmp.path() / "a.rpm" ).get(), a.get() );	// a is now most recently used
+
+  // c exceeds the limit, b is dropped
+  auto c { cache.get( tmp.path() / "c.rpm" ) };
+  BOOST_CHECK_EQUAL( cache.size(), ByteCount( 2 * hsize ) );
+  BOOST_CHECK_EQUAL( cache.get( tmp.path() / "a.rpm" ).get(), a.get() );
+  BOOST_CHECK_EQUAL( cache.get( tmp.path() / "c.rpm" ).get(), c.get() );
+  BOOST_CHECK( cache.get( tmp.path() / "b.rpm" ).get() != b.get() );
+  BOOST_CHECK( cache.size() <= cache.maxSize() );
+}
+
+BOOST_AUTO_TEST_CASE(max_size)
+{
+  const ByteCount ssize { headerSize( DATADIR / "signed.rpm" ) };
+  const ByteCount usize { headerSize( DATADIR / "unsigned.rpm" ) };
+
+  // the entry just added is kept, even if it exceeds the limit
+  RpmHeaderCache cache( ByteCount( 1 ) );
+  auto s { cache.get( DATADIR / "signed.rpm" ) };
+  BOOST_REQUIRE( s );
+  BOOST_CHECK_EQUAL( cache.size(), ssize );
+  BOOST_CHECK_EQUAL( cache.get( DATADIR / "signed.rpm" ).get(), s.get() );
+
+  auto u { cache.get( DATADIR / "unsigned.rpm" ) };
+  BOOST_REQUIRE( u );
+  BOOST_CHECK_EQUAL( cache.size(), usize );
+  BOOST_CHECK( cache.get( DATADIR / "signed.rpm" ).get() != s.get() );
+}
+
+BOOST_AUTO_TEST_CASE(file_changed)
+{
+  filesystem::TmpDir tmp;
+  const Pathname rpm { tmp.path() / "p.rpm" };
+  BOOST_REQUIRE_EQUAL( filesystem::copy( DATADIR / "signed.rpm", rpm ), 0 );
+  const ByteCount usize { headerSize( DATADIR / "unsigned.rpm" ) };
+
+  RpmHeaderCache cache;
+  auto h { cache.get( rpm ) };
+  BOOST_REQUIRE( h );
+  BOOST_CHECK( ! h->signatureKeyID().empty() );
+
+  // replaced by a different package
+  BOOST_REQUIRE_EQUAL( filesystem::copy( DATADIR / "unsigned.rpm", rpm ), 0 );
+  auto u { cache.get( rpm ) };
+  BOOST_REQUIRE( u );
+  BOOST_CHECK( u.get() != h.get() );
+  BOOST_CHECK( u->signatureKeyID().empty() );
+  BOOST_CHECK_EQUAL( cache.size(), usize );
+
+  // same size, different mtime
+  struct ::timespec times[2] = { { 0, UTIME_OMIT }, { PathInfo( rpm ).mtime() + 10, 0 } };
+  BOOST_REQUIRE_EQUAL( ::utimensat( AT_FDCWD, rpm.c_str(), times, 0 ), 0 );
+  BOOST_CHECK( cache.get( rpm ).get() != u.get() );
+
+  // removed
+  BOOST_REQUIRE_EQUAL( filesystem::unlink( rpm ), 0 );
+  BOOST_CHECK( ! cache.get( rpm ) );
+}
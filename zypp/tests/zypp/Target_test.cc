@@ -12,6 +12,7 @@
 #include <zypp/ZYpp.h>
 #include <zypp/ZYppFactory.h>
 #include <zypp/TmpPath.h>
+#include <zypp/target/rpm/RpmDb.h>
 
 using boost::unit_test::test_case;
 using namespace zypp;
@@ -54,3 +55,39 @@ BOOST_AUTO_TEST_CASE(target_test)
     BOOST_CHECK_EQUAL( dlabel.summary, "A cool distribution" );
     BOOST_CHECK_EQUAL( dlabel.shortName, "" );
 }
+
+BOOST_AUTO_TEST_CASE(batch_queries)
+{
+    filesystem::TmpDir tmp;
+
+    ZYpp::Ptr z = getZYpp();
+    z->initializeTarget( tmp.path() );
+
+    target::rpm::RpmDb & rpmdb( z->target()->rpmDb() );
+    rpmdb.installPackage( Pathname(TESTS_SRC_DIR) / "/zypp/data/RpmPkgSigCheck/unsigned.rpm",
+                          target::rpm::RPMINST_JUSTDB|target::rpm::RPMINST_NODEPS|target::rpm::RPMINST_NODIGEST|target::rpm::RPMINST_NOSIGNATURE );
+
+    const std::vector<std::string> names { "pkg-test42", "no-such-package" };
+    BOOST_CHECK( rpmdb.hasPackage( names ) == std::vector<bool>({ true, false }) );
+    BOOST_CHECK( rpmdb.hasProvides( names ) == std::vector<bool>({ true, false }) );
+    BOOST_CHECK( rpmdb.hasRequiredBy( names ) == std::vector<bool>({ false, false }) );
+
+    // pkg-test42 owns no files
+    const std::vector<std::string> files { "/usr/share/doc/packages/pkg-test42", "/etc/passwd" };
+    BOOST_CHECK( rpmdb.hasFile( files ) == std::vector<bool>({ false, false }) );
+    BOOST_CHECK( rpmdb.hasFile( files, "pkg-test42" ) == std::vector<bool>({ false, false }) );
+    BOOST_CHECK( rpmdb.whoOwnsFile( files ) == std::vector<std::string>({ "", "" }) );
+    BOOST_CHECK( z->target()->providesFile( "pkg-test42", files ) == std::vector<bool>({ false, false }) );
+    BOOST_CHECK( z->target()->whoOwnsFile( files ) == rpmdb.whoOwnsFile( files ) );
+
+    // batch and single key lookups agree
+    for ( const std::string & name : names )
+    {
+      BOOST_CHECK_EQUAL( rpmdb.hasPackage( std::vector<std::string>{ name } )[0], rpmdb.hasPackage( name ) );
+      BOOST_CHECK_EQUAL( rpmdb.hasProvides( std::vector<std::string>{ name } )[0], rpmdb.hasProvides( name ) );
+    }
+    for ( const std::string & file : files )
+      BOOST_CHECK_EQUAL( rpmdb.hasFile( std::vector<std::string>{ file }, "pkg-test42" )[0], rpmdb.hasFile( file, "pkg-test42" ) );
+
+    z->finishTarget();
+}
@@ -0,0 +1,46 @@
+// Boost.Test
+#include <boost/test/unit_test.hpp>
+
+#include <sstream>
+#include <zypp-core/base/XzStream>
+#include <zypp-core/base/GzStream>
+#include <zypp-core/Pathname.h>
+#include <zypp-core/base/InputStream>
+#include <zypp/PathInfo.h>
+
+#define DATADIR (zypp::Pathname(TESTS_SRC_DIR) / "/zypp/data/InputStream")
+
+namespace
+{
+  std::string slurp( std::istream & str_r )
+  {
+    std::ostringstream ret;
+    ret << str_r.rdbuf();
+    return ret.str();
+  }
+}
+
+BOOST_AUTO_TEST_CASE(xz_read)
+{
+  const zypp::Pathname file = DATADIR / "big.txt.xz";
+  BOOST_REQUIRE_EQUAL( zypp::filesystem::zipType( file ), zypp::filesystem::ZT_XZ );
+
+  zypp::ifgzstream ref( (DATADIR / "big.txt.gz").c_str() );
+  std::string expected { slurp( ref ) };
+  BOOST_REQUIRE( ! expected.empty() );
+
+  {
+    zypp::ifxzstream str( file.c_str() );
+    BOOST_REQUIRE ( str.is_open() );
+    BOOST_REQUIRE ( !str.getbuf().canWrite() );
+    BOOST_REQUIRE ( str.getbuf().canRead() );
+    // two concatenated streams
+    BOOST_CHECK_EQUAL( slurp( str ), expected + expected );
+  }
+
+  {
+    zypp::InputStream iStr( file );
+    BOOST_REQUIRE( typeid( iStr.stream() ) == typeid( zypp::ifxzstream& ) );
+    BOOST_CHECK_EQUAL( iStr.size(), -1 );
+  }
+}
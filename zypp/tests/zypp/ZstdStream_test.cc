@@ -0,0 +1,51 @@
+// Boost.Test
+#include <boost/test/unit_test.hpp>
+
+#include <sstream>
+#include <zypp-core/base/ZstdStream>
+#include <zypp-core/base/GzStream>
+#include <zypp-core/Pathname.h>
+#include <zypp-core/base/InputStream>
+#include <zypp/PathInfo.h>
+
+#define DATADIR (zypp::Pathname(TESTS_SRC_DIR) / "/zypp/data/InputStream")
+
+namespace
+{
+  std::string slurp( std::istream & str_r )
+  {
+    std::ostringstream ret;
+    ret << str_r.rdbuf();
+    return ret.str();
+  }
+}
+
+BOOST_AUTO_TEST_CASE(zstd_read)
+{
+  const zypp::Pathname file = DATADIR / "big.txt.zst";
+  BOOST_REQUIRE_EQUAL( zypp::filesystem::zipType( file ), zypp::filesystem::ZT_ZSTD );
+
+  zypp::ifgzstream ref( (DATADIR / "big.txt.gz").c_str() );
+  std::string expected { slurp( ref ) };
+  BOOST_REQUIRE( ! expected.empty() );
+
+  {
+    zypp::ifzstdstream str( file.c_str() );
+    BOOST_REQUIRE ( str.is_open() );
+    BOOST_REQUIRE ( !str.getbuf().canWrite() );
+    BOOST_REQUIRE ( str.getbuf().canRead() );
+    BOOST_CHECK_EQUAL( slurp( str ), expected );
+  }
+
+  {
+    // concatenated frames
+    zypp::ifzstdstream str( (DATADIR / "concat.txt.zst").c_str() );
+    BOOST_CHECK_EQUAL( slurp( str ), "Hello World\nzypp\nHello World\nzypp\n" );
+  }
+
+  {
+    zypp::InputStream iStr( file );
+    BOOST_REQUIRE( typeid( iStr.stream() ) == typeid( zypp::ifzstdstream& ) );
+    BOOST_CHECK_EQUAL( iStr.size(), -1 );
+  }
+}
@@ -0,0 +1,66 @@
+#include <boost/test/unit_test.hpp>
+#include <zypp-core/base/WorkerPool_p.h>
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+#define BOOST_TEST_MODULE WorkerPool
+
+using zypp::WorkerPool;
+
+BOOST_AUTO_TEST_CASE( maxThreads )
+{
+  BOOST_CHECK_GE( WorkerPool::defaultThreads(), 1U );
+  BOOST_CHECK_EQUAL( WorkerPool().maxThreads(), WorkerPool::defaultThreads() );
+  BOOST_CHECK_EQUAL( WorkerPool( 3 ).maxThreads(), 3U );
+}
+
+BOOST_AUTO_TEST_CASE( waitAll )
+{
+  std::atomic<unsigned> done { 0 };
+  std::atomic<unsigned> running { 0 };
+  std::atomic<unsigned> maxRunning { 0 };
+
+  WorkerPool pool( 2 );
+  for ( unsigned i = 0; i < 10; ++i )
+  {
+    pool.enqueue( [&]() {
+      unsigned now = ++running;
+      for ( unsigned seen = maxRunning; seen < now && ! maxRunning.compare_exchange_weak( seen, now ); )
+      {;}
+      std::this_thread::sleep_for( std::chrono::milliseconds( 10 ) );
+      --running;
+      ++done;
+    } );
+  }
+  pool.waitAll();
+  BOOST_CHECK_EQUAL( done, 10U );
+  BOOST_CHECK_LE( maxRunning, 2U );
+
+  // pool is reusable after waitAll
+  pool.enqueue( [&]() { ++done; } );
+  pool.waitAll();
+  BOOST_CHECK_EQUAL( done, 11U );
+}
+
+BOOST_AUTO_TEST_CASE( dtorWaits )
+{
+  std::atomic<unsigned> done { 0 };
+  {
+    WorkerPool pool( 4 );
+    for ( unsigned i = 0; i < 8; ++i )
+      pool.enqueue( [&]() { std::this_thread::sleep_for( std::chrono::milliseconds( 5 ) ); ++done; } );
+  }
+  BOOST_CHECK_EQUAL( done, 8U );
+}
+
+BOOST_AUTO_TEST_CASE( throwingJob )
+{
+  std::atomic<unsigned> done { 0 };
+  WorkerPool pool( 1 );
+  pool.enqueue( []() { throw std::runtime_error( "oops" ); } );
+  pool.enqueue( [&]() { ++done; } );
+  pool.waitAll();
+  BOOST_CHECK_EQUAL( done, 1U );
+}
@@ -294,6 +294,20 @@ void nwdispatcher_download( bool withSSL )
     BOOST_REQUIRE( checkFilesum(targetFile.path(), zypp::CheckSum::sha1("f1d2d2f924e986ac86fdf7b36c94bcdf32beec15")) );
   }
 
+  // download a full file and compute its checksum
+  {
+    zypp::filesystem::TmpFile targetFile;
+    zyppng::NetworkRequest::Ptr reqDLFile = std::make_shared<zyppng::NetworkRequest>( weburl, targetFile.path() );
+    reqDLFile->transferSettings() = set;
+    BOOST_REQUIRE_MESSAGE( reqDLFile->setFileChecksumType( zypp::Digest::sha1() ), "Unable to set checksum type" );
+    disp->enqueue( reqDLFile );
+    if ( disp->count () ) ev->run();
+    BOOST_TEST_REQ_SUCCESS( reqDLFile );
+
+    BOOST_REQUIRE_EQUAL( reqDLFile->fileChecksum(), zypp::CheckSum::sha1("f1d2d2f924e986ac86fdf7b36c94bcdf32beec15") );
+    BOOST_REQUIRE( checkFilesum(targetFile.path(), zypp::CheckSum::sha1("f1d2d2f924e986ac86fdf7b36c94bcdf32beec15")) );
+  }
+
   // download a full file using a open range starting from 0 but checksum should fail
   {
     zypp::filesystem::TmpFile targetFile;
@@ -0,0 +1,120 @@
+#include "argparse.h"
+
+#include <chrono>
+#include <fstream>
+#include <iostream>
+
+#include <zypp-core/base/String.h>
+#include <zypp/Digest.h>
+#include <zypp/PathInfo.h>
+#include <zypp/TmpPath.h>
+
+using std::cout;
+using std::cerr;
+using std::endl;
+using namespace zypp;
+
+static std::string appname { "NO_NAME" };
+
+int errexit( const std::string & msg_r = std::string(), int exit_r = 100 )
+{
+  if ( ! msg_r.empty() )
+    cerr << endl << appname << ": ERR: " << msg_r << endl << endl;
+  return exit_r;
+}
+
+int usage( const argparse::Options & options_r, int return_r = 0 )
+{
+  cerr << "USAGE: " << appname << " [OPTION]... [FILE]..." << endl;
+  cerr << "    Benchmark computing the sha256, sha1 and md5 digests of a" << endl;
+  cerr << "    synthetic file or of the FILEs given: one stream per digest" << endl;
+  cerr << "    vs. a single MultiDigest pass." << endl;
+  cerr << options_r << endl;
+  return return_r;
+}
+
+/** Call \a fnc_r \a rounds_r times; print the time and throughput per call. */
+template <class TFnc>
+void bench( const std::string & label_r, unsigned rounds_r, ByteCount size_r, TFnc && fnc_r )
+{
+  std::string result;
+  auto start { std::chrono::steady_clock::now() };
+  for ( unsigned r = 0; r < rounds_r; ++r )
+    result = fnc_r();
+  std::chrono::duration<double> elapsed { std::chrono::steady_clock::now() - start };
+  double perCall = elapsed.count() / rounds_r;
+  cout << str::form( "%-16s %10.2f ms/call %8.1f MiB/s  %s", label_r.c_str(), perCall * 1000,
+                     double(size_r) / perCall / ByteCount::MB.factor(), result.substr( 0, 16 ).c_str() ) << endl;
+}
+
+int main( int argc, char * argv[] )
+{
+  appname = Pathname::basename( argv[0] );
+
+  unsigned rounds = 5;
+  unsigned size = 256;
+
+  argparse::Options options;
+  options.add()
+    ( "help,h",	"Print help and exit." )
+    ( "rounds",	"Digest each file ROUNDS times (default 5).", argparse::Option::Arg::required )
+    ( "size",	"Size of the synthetic file in MiB (default 256).", argparse::Option::Arg::required )
+    ;
+  auto result = options.parse( argc, argv );
+
+  if ( result.count( "help" ) )
+    return usage( options );
+
+  if ( result.count( "rounds" ) )
+    rounds = str::strtonum<unsigned>( result["rounds"].arg() );
+  if ( ! rounds )
+    return errexit( "ROUNDS must be > 0" );
+  if ( result.count( "size" ) )
+    size = str::strtonum<unsigned>( result["size"].arg() );
+
+  filesystem::TmpDir tmpdir;
+  std::vector<std::string> files { result.positionals() };
+  if ( files.empty() )
+  {
+    Pathname file { tmpdir.path() / "synthetic" };
+    std::ofstream out( file.c_str() );
+    std::string block( ByteCount::MB.factor(), '\0' );
+    for ( unsigned i = 0; i < size; ++i )
+    {
+      for ( size_t c = 0; c < block.size(); ++c )
+        block[c] = char( ( c * 31 + i ) & 0xff );
+      out << block;
+    }
+    files.push_back( file.asString() );
+  }
+
+  const std::vector<std::string> names { Digest::sha256(), Digest::sha1(), Digest::md5() };
+  for ( const std::string & file : files )
+  {
+    PathInfo pi { file };
+    if ( ! pi.isFile() )
+      return errexit( "Not a file: " + file );
+    cout << file << " (" << ByteCount( pi.size() ) << ")" << endl;
+
+    bench( "stream each", rounds, pi.size(), [&]() {
+      std::string ret;
+      for ( const std::string & name : names )
+      {
+        std::ifstream istr( file.c_str() );
+        ret = Digest::digest( name, istr );
+      }
+      return ret;
+    } );
+    bench( "checksum each", rounds, pi.size(), [&]() {
+      std::string ret;
+      for ( const std::string & name : names )
+        ret = filesystem::checksum( file, name );
+      return ret;
+    } );
+    bench( "multidigest", rounds, pi.size(), [&]() {
+      return MultiDigest::fileDigests( names, file )[Digest::md5()];
+    } );
+  }
+
+  return 0;
+}
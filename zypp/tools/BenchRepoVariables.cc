@@ -0,0 +1,99 @@
+#include "argparse.h"
+
+#include <chrono>
+#include <iostream>
+
+#include <zypp-core/base/String.h>
+#include <zypp/ZYppFactory.h>
+#include <zypp/repo/RepoVariables.h>
+
+using std::cout;
+using std::cerr;
+using std::endl;
+using namespace zypp;
+
+static std::string appname { "NO_NAME" };
+
+int errexit( const std::string & msg_r = std::string(), int exit_r = 100 )
+{
+  if ( ! msg_r.empty() )
+    cerr << endl << appname << ": ERR: " << msg_r << endl << endl;
+  return exit_r;
+}
+
+int usage( const argparse::Options & options_r, int return_r = 0 )
+{
+  cerr << "USAGE: " << appname << " [OPTION]... [STRING]..." << endl;
+  cerr << "    Benchmark the repo variables expansion of some typical" << endl;
+  cerr << "    repo urls or of the STRINGs given." << endl;
+  cerr << options_r << endl;
+  return return_r;
+}
+
+/** Call \a fnc_r \a rounds_r times; print the time per call. */
+template <class TFnc>
+void bench( const std::string & label_r, unsigned rounds_r, TFnc && fnc_r )
+{
+  std::string result;
+  auto start { std::chrono::steady_clock::now() };
+  for ( unsigned r = 0; r < rounds_r; ++r )
+    result = fnc_r( r );
+  std::chrono::duration<double,std::nano> elapsed { std::chrono::steady_clock::now() - start };
+  cout << str::form( "%-16s %10.1f ns/call  %s", label_r.c_str(), elapsed.count() / rounds_r, result.c_str() ) << endl;
+}
+
+int main( int argc, char * argv[] )
+{
+  appname = Pathname::basename( argv[0] );
+
+  unsigned rounds = 100000;
+
+  argparse::Options options;
+  options.add()
+    ( "help,h",	"Print help and exit." )
+    ( "rounds",	"Expand each string ROUNDS times (default 100000).", argparse::Option::Arg::required )
+    ;
+  auto result = options.parse( argc, argv );
+
+  if ( result.count( "help" ) )
+    return usage( options );
+
+  if ( result.count( "rounds" ) )
+    rounds = str::strtonum<unsigned>( result["rounds"].arg() );
+  if ( ! rounds )
+    return errexit( "ROUNDS must be > 0" );
+
+  std::vector<std::string> strings { result.positionals() };
+  if ( strings.empty() )
+  {
+    strings = {
+      "https://download.opensuse.org/update/leap/15.6/oss/",
+      "https://download.opensuse.org/distribution/leap/$releasever/repo/oss/",
+      "https://updates.example.com/SUSE/Products/SLE-Module-Basesystem/${releasever_major}-SP${releasever_minor}/$basearch/product/",
+    };
+  }
+
+  // go...
+  try
+  {
+    ZYpp::Ptr zypp { getZYpp() };	// the variables are evaluated in the context of a zypp instance
+    repo::RepoVariablesStringReplacer stringReplacer;
+    repo::RepoVariablesUrlReplacer urlReplacer;
+
+    for ( const std::string & str : strings )
+    {
+      cout << str << endl;
+      bench( "string", rounds, [&]( unsigned ) { return stringReplacer( str ); } );
+      bench( "string (1st)", rounds, [&]( unsigned r ) { return stringReplacer( str + "?r=" + str::numstring( r ) ); } );
+      Url url { str };
+      bench( "url", rounds, [&]( unsigned ) { return urlReplacer( url ).asString(); } );
+      bench( "url (1st)", rounds/10+1, [&]( unsigned r ) { return urlReplacer( Url( str + "?r=" + str::numstring( r ) ) ).asString(); } );
+    }
+  }
+  catch ( const Exception & excpt )
+  {
+    return errexit( excpt.asUserHistory() );
+  }
+
+  return 0;
+}
@@ -0,0 +1,134 @@
+#include "argparse.h"
+
+#include <chrono>
+#include <fstream>
+#include <iostream>
+
+#include <zypp-core/base/GzStream>
+#include <zypp-core/base/String.h>
+#include <zypp/TmpPath.h>
+#include <zypp/RepoInfo.h>
+#include <zypp/parser/RepoindexFileReader.h>
+#include <zypp/parser/yum/RepomdFileReader.h>
+
+using std::cout;
+using std::cerr;
+using std::endl;
+using namespace zypp;
+
+static std::string appname { "NO_NAME" };
+
+int errexit( const std::string & msg_r = std::string(), int exit_r = 100 )
+{
+  if ( ! msg_r.empty() )
+    cerr << endl << appname << ": ERR: " << msg_r << endl << endl;
+  return exit_r;
+}
+
+int usage( const argparse::Options & options_r, int return_r = 0 )
+{
+  cerr << "USAGE: " << appname << " [OPTION]... [FILE]..." << endl;
+  cerr << "    Benchmark the repoindex.xml parser on synthetic files" << endl;
+  cerr << "    or on the repoindex.xml or repomd.xml FILEs given." << endl;
+  cerr << options_r << endl;
+  return return_r;
+}
+
+/** Write a repoindex.xml with \a repos_r entries (gzipped if \a gz_r). */
+void writeRepoindex( const Pathname & file_r, unsigned repos_r, bool gz_r )
+{
+  std::ofstream plain;
+  ofgzstream gzipped;
+  std::ostream & out { gz_r ? static_cast<std::ostream &>(gzipped) : plain };
+  if ( gz_r )
+    gzipped.open( file_r.c_str() );
+  else
+    plain.open( file_r.c_str() );
+
+  out << "<repoindex ttl=\"86400\" arch=\"x86_64\" releasever=\"15.6\">" << endl;
+  for ( unsigned i = 0; i < repos_r; ++i )
+  {
+    out << "<repo"
+        << " alias=\"Repo_" << i << "\""
+        << " name=\"Synthetic repository %{alias} for %{arch}\""
+        << " url=\"https://updates.example.com/SUSE/Products/Product-" << i << "/%{releasever}/%{arch}/product/\""
+        << " distro_target=\"sle-15-%{arch}\""
+        << " priority=\"" << 90 + i % 20 << "\""
+        << " enabled=\"" << ( i % 3 ? "true" : "false" ) << "\""
+        << " autorefresh=\"true\""
+        << " gpgcheck=\"1\""
+        << " keeppackages=\"0\""
+        << "/>" << endl;
+  }
+  out << "</repoindex>" << endl;
+}
+
+/** Parse \a file_r \a rounds_r times; print the time per round. */
+void bench( const Pathname & file_r, unsigned rounds_r )
+{
+  bool repomd { file_r.basename() == "repomd.xml" };
+  unsigned items = 0;
+  auto start { std::chrono::steady_clock::now() };
+  for ( unsigned r = 0; r < rounds_r; ++r )
+  {
+    items = 0;
+    if ( repomd )
+      parser::yum::RepomdFileReader( file_r, [&items]( OnMediaLocation &&, const std::string & ) { ++items; return true; } );
+    else
+      parser::RepoindexFileReader( file_r, [&items]( const RepoInfo & ) { ++items; return true; } );
+  }
+  std::chrono::duration<double,std::milli> elapsed { std::chrono::steady_clock::now() - start };
+  cout << str::form( "%-40s %7u items  %9.3f ms/parse  (%u rounds)",
+                     file_r.basename().c_str(), items, elapsed.count() / rounds_r, rounds_r ) << endl;
+}
+
+int main( int argc, char * argv[] )
+{
+  appname = Pathname::basename( argv[0] );
+
+  unsigned rounds = 10;
+
+  argparse::Options options;
+  options.add()
+    ( "help,h",	"Print help and exit." )
+    ( "rounds",	"Parse each file ROUNDS times (default 10).", argparse::Option::Arg::required )
+    ;
+  auto result = options.parse( argc, argv );
+
+  if ( result.count( "help" ) )
+    return usage( options );
+
+  if ( result.count( "rounds" ) )
+    rounds = str::strtonum<unsigned>( result["rounds"].arg() );
+  if ( ! rounds )
+    return errexit( "ROUNDS must be > 0" );
+
+  // go...
+  try
+  {
+    if ( result.positionals().empty() )
+    {
+      filesystem::TmpDir tmp;
+      for ( unsigned repos : { 1000U, 10000U, 50000U } )
+      {
+        for ( bool gz : { false, true } )
+        {
+          Pathname file { tmp.path() / str::form( "repoindex-%u.xml%s", repos, gz ? ".gz" : "" ) };
+          writeRepoindex( file, repos, gz );
+          bench( file, rounds );
+        }
+      }
+    }
+    else
+    {
+      for ( const std::string & file : result.positionals() )
+        bench( file, rounds );
+    }
+  }
+  catch ( const Exception & excpt )
+  {
+    return errexit( excpt.asUserHistory() );
+  }
+
+  return 0;
+}
@@ -13,9 +13,12 @@
 #include <iostream>
 #include <chrono>
 #include <list>
+#include <optional>
 
 #include <zypp-core/base/Logger.h>
+#include <zypp-core/Digest.h>
 #include <zypp-core/ExternalProgram.h>
+#include <zypp-core/fs/RememberedChecksums_p.h>
 #include <zypp-core/base/String.h>
 #include <zypp-core/base/Gettext.h>
 #include <utility>
@@ -85,6 +88,18 @@ namespace internal {
       return _bytesWritten;
     }
 
+    /** Compute a checksum of type \a type_r of the data written. */
+    void computeChecksum( const std::string & type_r )
+    {
+      _digest.emplace();
+      if ( ! _digest->create( type_r ) )
+        _digest.reset();
+    }
+
+    /** The checksum of the data written (if \ref computeChecksum was called). */
+    CheckSum checksum()
+    { return _digest ? CheckSum( _digest->name(), _digest->digest() ) : CheckSum(); }
+
   private:
     CURL *      _curl;
     AutoFILE    _file;
@@ -105,6 +120,7 @@ namespace internal {
     curl_off_t _dnlNow	 = 0.0;	///< Bytes downloaded now
 
     ByteCount _bytesWritten = 0; ///< Bytes actually written into the file
+    std::optional<Digest> _digest; ///< Digest of the bytes written
 
     int    _dnlPercent= 0;	///< Percent completed or 0 if _dnlTotal is unknown
 
@@ -185,6 +201,8 @@ namespace internal {
 
     auto written = fwrite( ptr, 1, bytes, _file );
     _bytesWritten += written;
+    if ( _digest )
+      _digest->update( ptr, written );
     return written;
   }
 
@@ -693,6 +711,8 @@ void MediaCurl::getFileCopyFromMirror(const int mirror, const OnMediaLocation &s
 
       // Set callback and perform.
       internal::ProgressData progressData( file, curl, settings.timeout(), fileurl, srcFile.downloadSize(), &report );
+      if ( ! srcFile.checksum().empty() )
+        progressData.computeChecksum( srcFile.checksum().type() );	// so the FileChecker needs not to read the file again
 
       ret = curl_easy_setopt( curl, CURLOPT_WRITEDATA,  &progressData  );
       if ( ret != 0 ) {
@@ -798,6 +818,7 @@ void MediaCurl::getFileCopyFromMirror(const int mirror, const OnMediaLocation &s
           ZYPP_THROW(MediaWriteException(dest));
         }
         destNew.resetDispose();	// no more need to unlink it
+        filesystem::rememberChecksum( dest, progressData.checksum() );
       }
 
       DBG << "done: " << PathInfo(dest) << endl;
@@ -13,6 +13,7 @@
 #include <iostream>
 
 #include <zypp-core/base/Logger.h>
+#include <zypp-core/fs/RememberedChecksums_p.h>
 #include <zypp-core/ExternalProgram.h>
 #include <zypp-core/base/String.h>
 #include <zypp-core/base/Gettext.h>
@@ -32,8 +33,19 @@
 
 #include <zypp-curl/ng/network/networkrequestdispatcher.h>
 #include <zypp-curl/ng/network/request.h>
-
+#include <zypp-core/ng/base/eventloop.h>
+#include <zypp-core/ng/base/SocketNotifier>
+#include <zypp-core/ng/base/private/threaddata_p.h>
+#include <zypp-core/ng/thread/Wakeup>
+#include <zypp-media/mediaconfig.h>
+
+#include <atomic>
+#include <condition_variable>
 #include <cstdlib>
+#include <list>
+#include <map>
+#include <mutex>
+#include <thread>
 #include <sys/types.h>
 #include <sys/stat.h>
 #include <sys/mount.h>
@@ -65,12 +77,216 @@ namespace zypp {
 
   namespace media {
 
+    ///////////////////////////////////////////////////////////////////
+    /// \class MediaCurl2::Prefetch
+    /// \brief Downloads batches of files in background threads.
+    ///
+    /// Each batch runs its own EventLoop and NetworkRequestDispatcher
+    /// in a thread of its own. The files are tracked by their location
+    /// below the attach point; \ref take waits for a pending download.
+    ///////////////////////////////////////////////////////////////////
+    struct MediaCurl2::Prefetch
+    {
+      /** Everything the thread needs to know about a file. */
+      struct Job
+      {
+        Pathname _filename;	///< on the media, for logging
+        Pathname _dest;		///< below the attach point
+        ManagedFile _tmp;
+        Url _url;
+        TransferSettings _settings;
+        ByteCount _size;
+        CheckSum _checksum;
+      };
+
+      ~Prefetch()
+      { stop(); }
+
+      /** Whether \a dest_r is pending or was prefetched. */
+      bool known( const Pathname & dest_r )
+      {
+        std::lock_guard<std::mutex> lk( _lock );
+        return _files.count( dest_r );
+      }
+
+      /** Start downloading \a jobs_r in a new thread. */
+      void start( std::vector<Job> jobs_r )
+      {
+        {
+          std::lock_guard<std::mutex> lk( _lock );
+          for ( const auto & job : jobs_r )
+            _files[job._dest] = File{ State::Pending, job._url };
+        }
+
+        _batches.remove_if( []( Batch & batch_r ) {
+          if ( ! batch_r._done )
+            return false;
+          batch_r._thread.join();
+          return true;
+        } );
+
+        long maxConnections = MediaConfig::instance().download_max_concurrent_connections();
+        Batch & batch { _batches.emplace_back() };
+        batch._thread = std::thread( [this, &batch, maxConnections, jobs = std::move(jobs_r)]() mutable {
+          run( jobs, maxConnections );
+          batch._done = true;
+        } );
+      }
+
+      /** Whether \a dest_r was prefetched (from \a url_r). Waits while the
+       * download is pending. The file is forgotten afterwards.
+       */
+      bool take( const Pathname & dest_r, Url & url_r )
+      {
+        std::unique_lock<std::mutex> lk( _lock );
+        auto it = _files.find( dest_r );
+        if ( it == _files.end() )
+          return false;
+
+        if ( it->second._state == State::Pending ) {
+          DBG << "Waiting for prefetched file " << dest_r << endl;
+          _cv.wait( lk, [&it]() { return it->second._state != State::Pending; } );
+        }
+        bool ret = ( it->second._state == State::Done );
+        url_r = it->second._url;
+        _files.erase( it );
+        return ret;
+      }
+
+      /** Cancel all downloads and forget about all files. */
+      void stop()
+      {
+        if ( ! _batches.empty() ) {
+          _stop.notify();
+          for ( auto & batch : _batches )
+            batch._thread.join();
+          _batches.clear();
+          _stop.ack();
+        }
+        std::lock_guard<std::mutex> lk( _lock );
+        _files.clear();
+      }
+
+    private:
+      enum class State { Pending, Done, Failed };
+
+      struct File
+      {
+        State _state;
+        Url _url;	///< downloaded from
+      };
+
+      struct Batch
+      {
+        std::thread _thread;
+        std::atomic<bool> _done { false };
+      };
+
+      /** The thread downloading a batch. */
+      void run( std::vector<Job> & jobs_r, long maxConnections_r )
+      {
+        zyppng::blockAllSignalsForCurrentThread();
+        zyppng::ThreadData::current().setName( "Zypp-Prefetch" );
+
+        auto ev = zyppng::EventLoop::create();
+        auto dispatcher = std::make_shared<zyppng::NetworkRequestDispatcher>();
+        dispatcher->setMaximumConcurrentConnections( maxConnections_r );
+
+        unsigned done = 0;
+        std::vector<zyppng::NetworkRequestRef> requests;
+        std::vector<zyppng::connection> signalConnections;
+        for ( auto & job : jobs_r ) {
+          auto req = std::make_shared<zyppng::NetworkRequest>( job._url, job._tmp, zyppng::NetworkRequest::WriteShared /*do not truncate*/ );
+          req->transferSettings() = job._settings;
+          req->setExpectedFileSize( job._size );
+          if ( ! job._checksum.empty() )
+            req->setExpectedFileChecksum( job._checksum );	// verified while downloading
+          signalConnections.push_back( req->sigFinished().connect( [&]( zyppng::NetworkRequest & req_r, const zyppng::NetworkRequestError & err ) {
+            bool ok = finish( job, req_r, err );
+            if ( ok )
+              ++done;
+            setState( job._dest, ok ? State::Done : State::Failed );
+          }) );
+          requests.push_back( std::move(req) );
+        }
+
+        signalConnections.push_back( dispatcher->sigQueueFinished().connect( [&]( zyppng::NetworkRequestDispatcher & ) {
+          ev->quit();
+        }) );
+        auto stopWatch = _stop.makeNotifier();
+        signalConnections.push_back( stopWatch->sigActivated().connect( [&]( const zyppng::SocketNotifier &, int ) {
+          dispatcher->cancelAll( "Prefetch cancelled" );
+          ev->quit();
+        }) );
+        zypp_defer {
+          std::for_each( signalConnections.begin(), signalConnections.end(), []( auto &conn ) { conn.disconnect(); });
+        };
+
+        dispatcher->run();
+        for ( auto & req : requests )
+          dispatcher->enqueue( req );
+        if ( dispatcher->count() )
+          ev->run();
+
+        // don't leave anyone waiting
+        for ( const auto & job : jobs_r )
+          setState( job._dest, State::Failed, /*pendingOnly*/true );
+
+        MIL << "Prefetched " << done << " of " << jobs_r.size() << " files" << endl;
+      }
+
+      /** Verify and move a finished download into place. Anything not perfect is left to getFileCopy. */
+      static bool finish( Job & job_r, zyppng::NetworkRequest & req_r, const zyppng::NetworkRequestError & err_r )
+      {
+        if ( err_r.isError() ) {
+          DBG << "Prefetching " << job_r._filename << " failed: " << err_r.toString() << endl;
+          return false;
+        }
+        CheckSum checksum { req_r.fileChecksum() };	// verified by the request
+        if ( ! job_r._checksum.empty() && checksum.empty() ) {
+          // checksum type not supported by the request
+          if ( ! filesystem::is_checksum( job_r._tmp, job_r._checksum ) ) {
+            WAR << "Prefetching " << job_r._filename << " failed: checksum mismatch" << endl;
+            return false;
+          }
+        }
+        if ( ::chmod( job_r._tmp->c_str(), filesystem::applyUmaskTo( 0644 ) ) ) {
+          ERR << "Failed to chmod file " << job_r._tmp << endl;
+        }
+        if ( filesystem::rename( job_r._tmp, job_r._dest ) != 0 )
+          return false;
+        job_r._tmp.resetDispose();
+        filesystem::rememberChecksum( job_r._dest, checksum );
+        return true;
+      }
+
+      void setState( const Pathname & dest_r, State state_r, bool pendingOnly_r = false )
+      {
+        {
+          std::lock_guard<std::mutex> lk( _lock );
+          auto it = _files.find( dest_r );
+          if ( it == _files.end() || ( pendingOnly_r && it->second._state != State::Pending ) )
+            return;
+          it->second._state = state_r;
+        }
+        _cv.notify_all();
+      }
+
+    private:
+      std::mutex _lock;			///< locks _files
+      std::condition_variable _cv;	///< notified when a file is no longer pending
+      std::map<Pathname,File> _files;
+      std::list<Batch> _batches;
+      zyppng::Wakeup _stop;
+    };
+
     MediaCurl2::MediaCurl2(const MirroredOrigin origin_r,
                            const Pathname & attach_point_hint_r )
       : MediaNetworkCommonHandler( origin_r, attach_point_hint_r,
                                    "/", // urlpath at attachpoint
                                    true ) // does_download
       , _executor( std::make_shared<internal::MediaNetworkRequestExecutor>() )
+      , _prefetch( std::make_unique<Prefetch>() )
     {
 
       MIL << "MediaCurl2::MediaCurl2(" << origin_r.authority().url() << ", " << attach_point_hint_r << ")" << endl;
@@ -96,6 +312,9 @@ namespace zypp {
       }
     }
 
+    MediaCurl2::~MediaCurl2()
+    { try { release(); } catch(...) {} }
+
     ///////////////////////////////////////////////////////////////////
 
     void MediaCurl2::checkProtocol(const Url &url) const
@@ -113,6 +332,7 @@ namespace zypp {
     {
       // clear effective settings
       clearTransferSettings();
+      _prefetch->stop();
     }
 
     ///////////////////////////////////////////////////////////////////
@@ -133,6 +353,22 @@ namespace zypp {
       OptionalDownloadProgressReport reportfilter( srcFile.optional() );
       callback::SendReport<DownloadProgressReport> report;
 
+      // Downloaded by precacheFiles? Take it and forget about it.
+      const Pathname & precached { localPath( filename ).absolutename() };
+      Url precachedUrl;
+      if ( _prefetch->take( precached, precachedUrl ) && PathInfo( precached ).isFile() ) {
+        DBG << "Using prefetched file " << precached << endl;
+        // Report the download, it just happened earlier.
+        report->start( precachedUrl, target );
+        if ( target.absolutename() != precached && filesystem::hardlinkCopy( precached, target ) != 0 ) {
+          report->finish( precachedUrl, DownloadProgressReport::ERROR, "Can't hardlink/copy the prefetched file" );
+          ZYPP_THROW( MediaWriteException( target ) );
+        }
+        report->progress( 100, precachedUrl );
+        report->finish( precachedUrl, DownloadProgressReport::NO_ERROR, "" );
+        return;
+      }
+
       const auto &mirrOrder = mirrorOrder (srcFile);
       for ( unsigned mirr : mirrOrder ) {
         MIL << "Trying to fetch file " << srcFile << " via URL: " << _origin[mirr].url() << std::endl;
@@ -207,6 +443,8 @@ namespace zypp {
     #endif
           if ( !done ) {
             r._req->resetRequestRanges();
+            if ( !srcFile.checksum().empty() )
+              r._req->setFileChecksumType( srcFile.checksum().type() );	// so the FileChecker needs not to read the file again
             const_cast<MediaCurl2 *>(this)->executeRequest ( r, &report );
           }
 
@@ -248,6 +486,7 @@ namespace zypp {
             ZYPP_THROW(MediaWriteException(dest));
           }
           destNew.resetDispose();	// no more need to unlink it
+          filesystem::rememberChecksum( dest, r._req->fileChecksum() );
 
           DBG << "done: " << PathInfo(dest) << endl;
 
@@ -336,6 +575,61 @@ namespace zypp {
       return false;
     }
 
+    void MediaCurl2::precacheFiles( const std::vector<OnMediaLocation> & files )
+    {
+      if ( files.empty() || !isAttached() )
+        return;
+
+      std::vector<Prefetch::Job> jobs;
+      jobs.reserve( files.size() );
+
+      for ( const auto & file : files ) {
+        // zchunk files are assembled by getFileCopy
+        if ( !file.deltafile().empty() )
+          continue;
+
+        Pathname dest { localPath( file.filename() ).absolutename() };
+        if ( _prefetch->known( dest ) )
+          continue;
+
+        const auto & mirrOrder = mirrorOrder( file );
+        if ( mirrOrder.empty() )
+          continue;
+        const auto & myOrigin = _origin[mirrOrder.front()];
+        if ( !myOrigin.url().isValid() || myOrigin.url().getHost().empty() )
+          continue;
+
+        if ( assert_dir( dest.dirname() ) )
+          continue;
+
+        ManagedFile tmp { dest.extend( ".new.zypp.XXXXXX" ) }; {
+          AutoFREE<char> buf { ::strdup( (*tmp).c_str() ) };
+          if ( !buf )
+            continue;
+          AutoFD tmp_fd { ::mkostemp( buf, O_CLOEXEC ) };
+          if ( tmp_fd == -1 )
+            continue;
+          tmp = ManagedFile( (*buf), filesystem::unlink );
+        }
+
+        Prefetch::Job job;
+        job._filename = file.filename();
+        job._dest     = std::move(dest);
+        job._tmp      = std::move(tmp);
+        job._url      = clearQueryString( getFileUrl( mirrOrder.front(), file.filename() ) );
+        job._settings = myOrigin.getConfig<TransferSettings>( MIRR_SETTINGS_KEY.data() );
+        job._size     = file.downloadSize();
+        job._checksum = file.checksum();
+        jobs.push_back( std::move(job) );
+      }
+
+      if ( jobs.empty() )
+        return;
+
+      MIL << "Prefetching " << jobs.size() << " files" << endl;
+      _prefetch->start( std::move(jobs) );
+    }
+
     bool MediaCurl2::tryZchunk( RequestData &reqData, const OnMediaLocation &srcFile, const Pathname &target, callback::SendReport<DownloadProgressReport> &report )
     {
 #ifdef ENABLE_ZCHUNK_COMPRESSION
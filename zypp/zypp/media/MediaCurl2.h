@@ -19,6 +19,8 @@
 
 #include <curl/curl.h>
 
+#include <memory>
+
 namespace zyppng {
   ZYPP_FWD_DECL_TYPE_WITH_REFS (EventDispatcher);
   ZYPP_FWD_DECL_TYPE_WITH_REFS (NetworkRequestDispatcher);
@@ -80,7 +82,23 @@ class MediaCurl2 : public MediaNetworkCommonHandler
     MediaCurl2(const MirroredOrigin origin_r,
                const Pathname & attach_point_hint_r );
 
-    ~MediaCurl2() override { try { release(); } catch(...) {} }
+    ~MediaCurl2() override;
+
+    /**
+     * Start downloading \a files into the attach point in the background.
+     *
+     * The files are downloaded concurrently in a thread of their own and
+     * the call returns immediately. A later \ref getFile for one of them
+     * waits until its download is done and then uses the downloaded file.
+     *
+     * Each file is tried on its first mirror only and its checksum (if
+     * known) is verified as soon as it arrives. A file that fails for
+     * whatever reason (including a server asking for credentials) is
+     * silently dropped; \ref getFileCopy will download it again and
+     * report the error as usual. Pending downloads are cancelled when
+     * the media is released.
+     */
+    void precacheFiles( const std::vector<OnMediaLocation> & files ) override;
 
   protected:
     /**
@@ -100,6 +118,8 @@ class MediaCurl2 : public MediaNetworkCommonHandler
 
   private:
     internal::MediaNetworkRequestExecutorRef _executor;
+    struct Prefetch;
+    std::unique_ptr<Prefetch> _prefetch; ///< background downloads started by \ref precacheFiles
 };
 ZYPP_DECLARE_OPERATORS_FOR_FLAGS(MediaCurl2::RequestOptions);
 
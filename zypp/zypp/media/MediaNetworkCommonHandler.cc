@@ -130,6 +130,20 @@ namespace zypp::media
   }
 
   void MediaNetworkCommonHandler::getDir( const Pathname & dirname, bool recurse_r ) const
+  {
+    // List the whole tree first. This way a backend supporting precacheFiles
+    // can download the files in parallel while we provide them one by one.
+    std::vector<OnMediaLocation> files;
+    listDirFiles( files, dirname, recurse_r );
+
+    if ( files.size() > 1 )
+      const_cast<MediaNetworkCommonHandler *>(this)->precacheFiles( files );
+
+    for ( const auto & file : files )
+      getFile( file );
+  }
+
+  void MediaNetworkCommonHandler::listDirFiles( std::vector<OnMediaLocation> & files_r, const Pathname & dirname, bool recurse_r ) const
   {
     filesystem::DirContent content;
     getDirInfo( content, dirname, /*dots*/false );
@@ -141,11 +155,11 @@ namespace zypp::media
         switch ( it->type ) {
         case filesystem::FT_NOT_AVAIL: // old directory.yast contains no typeinfo at all
         case filesystem::FT_FILE:
-          getFile( OnMediaLocation( filename ) );
+          files_r.push_back( OnMediaLocation( filename ) );
           break;
         case filesystem::FT_DIR: // newer directory.yast contain at least directory info
           if ( recurse_r ) {
-            getDir( filename, recurse_r );
+            listDirFiles( files_r, filename, recurse_r );
           } else {
             res = assert_dir( localPath( filename ) );
             if ( res ) {
@@ -88,6 +88,13 @@ namespace zypp
 
       std::vector<unsigned> mirrorOrder( const OnMediaLocation &loc ) const;
 
+      /**
+       * Append the files in \a dirname (and below, if \a recurse_r) to \a files_r,
+       * in the order \ref getDir provides them. Subdirectories not descended into
+       * are created below the attach point.
+       **/
+      void listDirFiles( std::vector<OnMediaLocation> & files_r, const Pathname & dirname, bool recurse_r ) const;
+
     public:
 
       // standard auth procedure, shared with CommitPackagePreloader
@@ -87,7 +87,7 @@ namespace zyppng {
     /*!
      * How much bytes does this queue has to download / process,
      * for pending requests this is only set if the \ref ProvideSpec
-     * has a expected download size set.
+     * has a expected download size or a \ref SCHEDULER_WORK_SIZE set.
      */
     zypp::ByteCount expectedProvideSize() const;
 
@@ -23,6 +23,7 @@ namespace zyppng {
   // request related settings:
   constexpr std::string_view NETWORK_METALINK_ENABLED("zypp-nw-metalink-enabled");  //< Enable or disable metalink for a specific request
   constexpr std::string_view HANDLER_SPECIFIC_DEVICES("zypp-req-specific-devices"); //< Limit the request to a set of devices. Devices are comma seperated.
+  constexpr std::string_view SCHEDULER_WORK_SIZE("zypp-req-work-size");             //< Bytes a CPU bound request has to process. Only used to balance the workers, not reported as download size.
 }
 
 #endif
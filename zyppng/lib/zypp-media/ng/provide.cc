@@ -7,6 +7,7 @@
 #include <zypp-core/base/DtorReset>
 #include <zypp-core/fs/PathInfo.h>
 #include <zypp-media/MediaException>
+#include <zypp-media/ng/provide-configvars.h>
 #include <zypp-media/FileCheckException>
 #include <zypp-media/CDTools>
 
@@ -18,6 +19,56 @@ L_ENV_CONSTR_DEFINE_FUNC(ZYPP_MEDIA_PROVIDER_DEBUG)
 
 namespace zyppng {
 
+  namespace {
+    /** Max. number of CPU bound workers; \c ZYPP_MEDIA_CPU_WORKERS overrides the default. */
+    int cpuWorkerLimit()
+    {
+      static const int limit = []() {
+        int ret =
+#ifdef _SC_NPROCESSORS_ONLN
+          sysconf(_SC_NPROCESSORS_ONLN) * 2;
+#else
+          constants::DEFAULT_CPU_WORKERS;
+#endif
+        if ( ret <= 0 )
+          ret = constants::DEFAULT_CPU_WORKERS;
+
+        const char *envval = ::getenv( "ZYPP_MEDIA_CPU_WORKERS" );
+        if ( envval ) {
+          int val = zypp::str::strtonum<int>( envval );
+          if ( val > 0 ) {
+            ret = val;
+            MIL << "ZYPP_MEDIA_CPU_WORKERS: using max. " << ret << " CPU bound workers" << std::endl;
+          } else {
+            WAR << "ZYPP_MEDIA_CPU_WORKERS: ignoring invalid value '" << envval << "'" << std::endl;
+          }
+        }
+        return ret;
+      }();
+      return limit;
+    }
+
+    /** Hardlink \a source_r to \a target_r if both are on the same filesystem.
+     * This needs no copy worker and saves a request roundtrip per file. Copying
+     * the data (and all errors) are left to the worker.
+     */
+    bool hardlinkInProcess( const zypp::Pathname &source_r, const zypp::Pathname &target_r )
+    {
+      zypp::PathInfo spi( source_r, zypp::PathInfo::LSTAT );
+      if ( !spi.isFile() )
+        return false;
+
+      zypp::PathInfo tpi( target_r, zypp::PathInfo::LSTAT );
+      if ( tpi.isExist() ) {
+        if ( tpi.dev() == spi.dev() && tpi.ino() == spi.ino() )
+          return true;
+        if ( zypp::filesystem::unlink( target_r ) != 0 )
+          return false;
+      }
+      return ::link( source_r.c_str(), target_r.c_str() ) == 0;
+    }
+  } // namespace
+
   ProvidePrivate::ProvidePrivate(zypp::filesystem::Pathname &&workDir, Provide &pub)
     : BasePrivate(pub)
     , _workDir( std::move(workDir) )
@@ -79,12 +130,7 @@ namespace zyppng {
       return;
     }
 
-    const int cpuLimit =
-#ifdef _SC_NPROCESSORS_ONLN
-      sysconf(_SC_NPROCESSORS_ONLN) * 2;
-#else
-      DEFAULT_CPU_WORKERS;
-#endif
+    const int cpuLimit = cpuWorkerLimit();
 
     // helper lambda to find the worker that is idle for the longest time
     constexpr auto findLaziestWorker = []( const auto &workerQueues, const auto &idleNames  ) {
@@ -111,6 +157,16 @@ namespace zyppng {
       return candidate;
     };
 
+    // helper lambda to find an unused name for a new CPU bound queue; after idle queues were
+    // decomissioned the number of existing ones may already be taken
+    const auto cpuQueueName = [this]( const std::string &scheme, int hint ) {
+      std::string ret;
+      do {
+        ret = zypp::str::Format("%1%#%2%") % scheme % hint++;
+      } while ( _workerQueues.count( ret ) );
+      return ret;
+    };
+
     // clean up old media
 
     for ( auto iMedia = _attachedMediaInfos.begin(); iMedia != _attachedMediaInfos.end();  ) {
@@ -544,8 +600,7 @@ namespace zyppng {
 
               item->setActiveUrl(url);
 
-              auto str = zypp::str::Format("%1%#%2%") % scheme % existingSchemeWorkers;
-              _workerQueues[str] = q;
+              _workerQueues[cpuQueueName( scheme, existingSchemeWorkers )] = q;
               q->enqueue( item );
               i = queue.erase(i);
               continue;
@@ -563,10 +618,16 @@ namespace zyppng {
             MIL_PRV << "No free CPU slots, looking for the best existing worker" << std::endl;
 
             if( possibleWorkers.size () ) {
+              // the worker with the least bytes to process, a file of unknown size counts as one request
               std::vector<ProvideQueue *>::iterator candidate = possibleWorkers.begin();
+              zypp::ByteCount candidateSize = (*candidate)->expectedProvideSize();
               for ( auto i = candidate+1; i != possibleWorkers.end(); i++ ) {
-                if ( (*i)->activeRequests () < (*candidate)->activeRequests () )
+                const zypp::ByteCount size = (*i)->expectedProvideSize();
+                if ( size < candidateSize
+                     || ( size == candidateSize && (*i)->requestCount () < (*candidate)->requestCount () ) ) {
                   candidate = i;
+                  candidateSize = size;
+                }
               }
 
               // this is not really required because we are not doing redirect checks
@@ -601,8 +662,7 @@ namespace zyppng {
 
                 item->setActiveUrl(url);
 
-                auto str = zypp::str::Format("%1%#%2%") % scheme % ( existingSchemeWorkers + 1 );
-                _workerQueues[str] = q;
+                _workerQueues[cpuQueueName( scheme, existingSchemeWorkers )] = q;
                 q->enqueue( item );
                 i = queue.erase(i);
                 continue;
@@ -1138,7 +1198,8 @@ namespace zyppng {
 
     zypp::Url url("chksum:///");
     url.setPathName( p );
-    auto fut = provide( url, zyppng::ProvideFileSpec().setCustomHeaderValue( "chksumType", algorithm ) )
+    // the file size lets the scheduler spread the requests across the workers
+    auto fut = provide( url, zyppng::ProvideFileSpec().setCustomHeaderValue( "chksumType", algorithm ).setCustomHeaderValue( std::string(SCHEDULER_WORK_SIZE), int64_t( zypp::PathInfo( p ).size() ) ) )
       | and_then( [algorithm]( zyppng::ProvideRes &&chksumRes ) {
         if ( chksumRes.headers().contains(algorithm) ) {
           try {
@@ -1156,9 +1217,14 @@ namespace zyppng {
   {
     using namespace zyppng::operators;
 
+    if ( hardlinkInProcess( source, target ) ) {
+      DBG << "Hardlinked " << source << " -> " << target << std::endl;
+      return makeReadyResult( expected<zypp::ManagedFile>::success( zypp::ManagedFile( target, zypp::filesystem::unlink ) ) );
+    }
+
     zypp::Url url("copy:///");
     url.setPathName( source );
-    auto fut = provide( url, ProvideFileSpec().setDestFilenameHint( target  ))
+    auto fut = provide( url, ProvideFileSpec().setDestFilenameHint( target  ).setCustomHeaderValue( std::string(SCHEDULER_WORK_SIZE), int64_t( zypp::PathInfo( source ).size() ) ) )
       | and_then( [&]( ProvideRes &&copyRes ) {
           return expected<zypp::ManagedFile>::success( copyRes.asManagedFile() );
       } );
@@ -279,23 +279,21 @@ namespace zyppng {
   zypp::ByteCount ProvideQueue::expectedProvideSize() const
   {
     zypp::ByteCount dlSize;
-    for ( const auto &i : _waitQueue ) {
+    const auto &addSize = [&]( const auto &i ) {
       if ( i.isDetachRequest () )
-        continue;
-
-      auto &reqRef = i._request;
-      if ( reqRef->code() != ProvideMessage::Code::Prov )
-        continue;
-      dlSize += reqRef->provideMessage().value( ProvideMsgFields::ExpectedFilesize, int64_t(0) ).asInt64();
-    }
-    for ( const auto &i : _activeItems ) {
-      if ( i.isDetachRequest () )
-        continue;
+        return;
       auto &reqRef = i._request;
       if ( reqRef->code() != ProvideMessage::Code::Prov )
-        continue;
-      dlSize += reqRef->provideMessage().value( ProvideMsgFields::ExpectedFilesize, int64_t(0) ).asInt64();
-    }
+        return;
+      const auto &msg = reqRef->provideMessage();
+      dlSize += msg.value( ProvideMsgFields::ExpectedFilesize, int64_t(0) ).asInt64();
+      // CPU bound requests tell the size of the data to process
+      dlSize += msg.value( SCHEDULER_WORK_SIZE, int64_t(0) ).asInt64();
+    };
+    for ( const auto &i : _waitQueue )
+      addSize( i );
+    for ( const auto &i : _activeItems )
+      addSize( i );
     return dlSize;
   }
 
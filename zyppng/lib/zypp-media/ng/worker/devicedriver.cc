@@ -135,6 +135,9 @@ namespace zyppng::worker
     dev._mountPoint = zypp::Pathname();
   }
 
+  void DeviceDriver::prepareFile ( const AttachedMedia &, const zypp::Pathname & )
+  { }
+
   bool DeviceDriver::isVolatile () const
   {
     return false;
@@ -122,6 +122,13 @@ namespace zyppng::worker
        */
       std::unordered_map<std::string, AttachedMedia> &attachedMedia();
 
+      /*!
+       * Called by the \ref MountingWorker before it looks up \a path below the attach point of \a media.
+       * Drivers not mounting a real filesystem can use this to make the file available there on demand.
+       * The default implementation does nothing.
+       */
+      virtual void prepareFile ( const AttachedMedia &media, const zypp::Pathname &path );
+
       /*!
        * Returns true if the worker handles volatile devices ( e.g. DVDs ).
        * The default impl returns false.
@@ -116,6 +116,17 @@ namespace zyppng::worker
             return;
           }
 
+          try {
+            _driver->prepareFile( i->second, path );
+          } catch ( const zypp::Exception &e ) {
+            ZYPP_CAUGHT(e);
+            provideFailed( req->_spec.requestId()
+              , zyppng::ProvideMessage::Code::InternalError
+              , false
+              , e );
+            return;
+          }
+
           const auto &locPath = i->second._dev->_mountPoint / i->second._attachRoot / path;
 
           MIL << "Trying to find file: " << locPath << std::endl;
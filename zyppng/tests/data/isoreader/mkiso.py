@@ -0,0 +1,116 @@
+#!/usr/bin/env python3
+# Writes the minimal ISO9660 images used by IsoReader_test:
+#
+#   mkiso.py <plain|joliet|rockridge|multiextent|badextent|badce|baddir> <image>
+#
+# All images contain the same tree:
+#   /media.1/media
+#   /Readme.TXT
+#   /dir/sub/deep file.bin   (5000 bytes, byte i is (i*7)&0xff)
+# The rockridge image in addition has a symlink /link -> Readme.TXT,
+# the multiextent image stores 'deep file.bin' in two extents.
+# The bad* images are rockridge images with one malformed location.
+import struct, sys
+
+BS = 2048
+mode, out = sys.argv[1], sys.argv[2]
+rockridge = mode in ( 'rockridge', 'badextent', 'badce', 'baddir' )
+
+big = bytes( ( i * 7 ) & 0xff for i in range( 5000 ) )
+tree = { 'media.1': { 'media': b'SUSE - Test\n20240101\n1\n' }, 'Readme.TXT': b'hello\n', 'dir': { 'sub': { 'deep file.bin': big } } }
+
+blocks = {}
+next_lba = [ 20 ]
+
+def alloc( n ):
+    l = next_lba[0]
+    next_lba[0] += ( n + BS - 1 ) // BS or 1
+    return l
+
+def both32( v ): return struct.pack( '<I', v ) + struct.pack( '>I', v )
+def both16( v ): return struct.pack( '<H', v ) + struct.pack( '>H', v )
+
+def isoname( n, isdir ):
+    base = n.upper().replace( ' ', '_' ).replace( '-', '_' )
+    return ( base if isdir else base + ';1' ).encode()
+
+def rec( name, lba, size, isdir, su = b'', flags = 0 ):
+    pad = b'' if len( name ) % 2 else b'\0'
+    body = bytes( [0] ) + both32( lba ) + both32( size ) + bytes( 7 ) + bytes( [ flags | ( 2 if isdir else 0 ), 0, 0 ] ) + both16( 1 ) + bytes( [ len( name ) ] ) + name + pad + su
+    if ( 1 + len( body ) ) % 2:
+        body += b'\0'
+    return bytes( [ 1 + len( body ) ] ) + body
+
+def nm( n ):
+    d = bytes( [0] ) + n.encode()
+    return b'NM' + bytes( [ 4 + len( d ), 1 ] ) + d
+
+def px( m ): return b'PX' + bytes( [ 36, 1 ] ) + both32( m ) + both32( 1 ) + both32( 0 ) + both32( 0 )
+def ce( lba, off, ln ): return b'CE' + bytes( [ 28, 1 ] ) + both32( lba ) + both32( off ) + both32( ln )
+
+def build( tree, joliet, parent = None, root = False ):
+    dir_lba = alloc( BS )
+    recs = []
+    for name, v in sorted( tree.items() ):
+        isdir = isinstance( v, dict )
+        if isdir:
+            lba, size = build( v, joliet, dir_lba )
+            if mode == 'baddir' and name == 'dir':
+                size = 0xFFFFFFF0
+        else:
+            lba, size = alloc( len( v ) ), len( v )
+            blocks[lba] = v
+            if mode == 'badextent' and name == 'Readme.TXT':
+                lba = 0x7FFFFFFF
+        if joliet:
+            nb = name.encode( 'utf-16-be' ) + ( b'' if isdir else ';1'.encode( 'utf-16-be' ) )
+        else:
+            nb = isoname( name, isdir )
+        su = b''
+        if rockridge:
+            su = nm( name ) + px( 0o40755 if isdir else 0o100644 )
+            if mode == 'badce' and name == 'Readme.TXT':
+                su += ce( dir_lba, 0, 0xFFFFFFFF )
+        if mode == 'multiextent' and not isdir and len( v ) > BS:
+            # the first extent must be a multiple of the block size
+            recs.append( rec( nb, lba, BS, False, su, 0x80 ) )
+            recs.append( rec( nb, lba + 1, size - BS, False, su ) )
+        else:
+            recs.append( rec( nb, lba, size, isdir, su ) )
+    if rockridge and root and not joliet:
+        dot = rec( b'\0', dir_lba, BS, True, b'SP' + bytes( [ 7, 1, 0xBE, 0xEF, 0 ] ) )
+        recs.append( rec( b'LINK.;1', 0, 0, False, nm( 'link' ) + px( 0o120777 ) + b'SL' + bytes( [ 17, 1, 0, 0, 10 ] ) + b'Readme.TXT' ) )
+    else:
+        dot = rec( b'\0', dir_lba, BS, True )
+    data = dot + rec( b'\1', parent or dir_lba, BS, True ) + b''.join( recs )
+    assert len( data ) <= BS
+    blocks[dir_lba] = data
+    return dir_lba, BS
+
+def vd( t, root_lba, joliet = False ):
+    d = bytearray( BS )
+    d[0] = t
+    d[1:6] = b'CD001'
+    d[6] = 1
+    if joliet:
+        d[88:91] = b'%/E'
+    d[128:132] = both16( BS )
+    d[156:190] = rec( b'\0', root_lba, BS, True )
+    return bytes( d )
+
+root_lba, _ = build( tree, False, None, True )
+vds = [ vd( 1, root_lba ) ]
+if mode == 'joliet':
+    vds.append( vd( 2, build( tree, True, None, True )[0], True ) )
+term = bytearray( BS )
+term[0] = 255
+term[1:6] = b'CD001'
+term[6] = 1
+vds.append( bytes( term ) )
+
+img = bytearray( next_lba[0] * BS )
+for n, d in enumerate( vds ):
+    img[( 16 + n ) * BS:( 17 + n ) * BS] = d
+for l, b in blocks.items():
+    img[l * BS:l * BS + len( b )] = b
+open( out, 'wb' ).write( img )
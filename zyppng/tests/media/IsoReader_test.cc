@@ -0,0 +1,116 @@
+#include <zypp-core/Pathname.h>
+#include <zypp-core/base/Exception.h>
+#include <zypp-core/fs/PathInfo.h>
+#include <zypp/TmpPath.h>
+
+#include <isoreader.h>
+
+#include <tests/lib/TestTools.h>
+
+#include <boost/test/unit_test.hpp>
+#include <boost/test/data/test_case.hpp>
+
+#include <algorithm>
+#include <list>
+
+// the images are created by data/isoreader/mkiso.py
+#define DATADIR ( zypp::Pathname( TESTS_SRC_DIR ) / "data" / "isoreader" )
+
+namespace bdata = boost::unit_test::data;
+
+namespace
+{
+  std::string deepFileContent()
+  {
+    std::string ret;
+    for ( unsigned i = 0; i < 5000; ++i )
+      ret += char( ( i * 7 ) & 0xff );
+    return ret;
+  }
+
+  std::string extracted( IsoReader &reader, const zypp::Pathname &path )
+  {
+    zypp::filesystem::TmpDir tmp;
+    const auto &entry = reader.lookup( path );
+    BOOST_REQUIRE( entry );
+    BOOST_REQUIRE( !entry->_isDir );
+    reader.extract( *entry, tmp.path() / "file" );
+    return TestTools::readFile( tmp.path() / "file" );
+  }
+}
+
+BOOST_DATA_TEST_CASE( read_images,
+                      bdata::make( { "plain", "joliet", "rockridge", "multiextent" } ) ^ bdata::make( { "iso9660", "joliet", "rockridge", "iso9660" } ),
+                      image, nameFormat )
+{
+  IsoReader reader( DATADIR / ( std::string(image) + ".iso" ) );
+  BOOST_CHECK_EQUAL( reader.nameFormat(), nameFormat );
+
+  // plain ISO9660 names are mapped like the kernel does
+  const bool plain = ( reader.nameFormat() == "iso9660" );
+  const zypp::Pathname readme { plain ? "/readme.txt" : "/Readme.TXT" };
+  const zypp::Pathname deepFile { plain ? "/dir/sub/deep_file.bin" : "/dir/sub/deep file.bin" };
+
+  BOOST_CHECK( reader.lookup( "/" )->_isDir );
+  BOOST_CHECK( reader.lookup( "/dir/sub" )->_isDir );
+  BOOST_CHECK( !reader.lookup( "/nope" ) );
+  BOOST_CHECK( !reader.lookup( readme / "nope" ) );
+
+  std::vector<std::string> expectRoot { "dir", "media.1", readme.basename() };
+  std::sort( expectRoot.begin(), expectRoot.end() );
+  auto root = reader.list( "/" );
+  std::sort( root.begin(), root.end() );
+  BOOST_CHECK_EQUAL_COLLECTIONS( root.begin(), root.end(), expectRoot.begin(), expectRoot.end() );
+  BOOST_CHECK( reader.list( readme ).empty() );
+
+  BOOST_CHECK_EQUAL( extracted( reader, readme ), "hello\n" );
+  BOOST_CHECK_EQUAL( extracted( reader, "/media.1/media" ), "SUSE - Test\n20240101\n1\n" );
+
+  const auto &deep = reader.lookup( deepFile );
+  BOOST_REQUIRE( deep );
+  BOOST_CHECK_EQUAL( deep->_size, 5000U );
+  BOOST_CHECK_EQUAL( deep->_extents.size(), std::string(image) == "multiextent" ? 2U : 1U );
+  BOOST_CHECK( extracted( reader, deepFile ) == deepFileContent() );
+}
+
+BOOST_AUTO_TEST_CASE( rockridge_symlinks_are_skipped )
+{
+  IsoReader reader( DATADIR / "rockridge.iso" );
+  BOOST_CHECK( !reader.lookup( "/link" ) );
+  const auto &root = reader.list( "/" );
+  BOOST_CHECK( std::find( root.begin(), root.end(), "link" ) == root.end() );
+}
+
+BOOST_AUTO_TEST_CASE( malformed_images )
+{
+  zypp::filesystem::TmpDir tmp;
+
+  // not an ISO image at all
+  BOOST_CHECK_THROW( IsoReader( DATADIR / "mkiso.py" ), zypp::Exception );
+  BOOST_CHECK_THROW( IsoReader( DATADIR / "missing.iso" ), zypp::Exception );
+
+  // a file extent beyond the end of the image
+  {
+    IsoReader reader( DATADIR / "badextent.iso" );
+    const auto &entry = reader.lookup( "/Readme.TXT" );
+    BOOST_REQUIRE( entry );
+    BOOST_CHECK_THROW( reader.extract( *entry, tmp.path() / "file" ), zypp::Exception );
+    BOOST_CHECK( !zypp::PathInfo( tmp.path() / "file" ).isExist() );
+    std::list<std::string> left;
+    zypp::filesystem::readdir( left, tmp.path() );
+    BOOST_CHECK( left.empty() );
+  }
+
+  // a continuation area of 4GiB
+  {
+    IsoReader reader( DATADIR / "badce.iso" );
+    BOOST_CHECK_THROW( reader.lookup( "/Readme.TXT" ), zypp::Exception );
+  }
+
+  // a directory of 4GiB
+  {
+    IsoReader reader( DATADIR / "baddir.iso" );
+    BOOST_CHECK( reader.lookup( "/dir" ) );
+    BOOST_CHECK_THROW( reader.lookup( "/dir/sub" ), zypp::Exception );
+  }
+}
@@ -18,7 +18,9 @@
 #include <shared/tvm/tvmsettings.h>
 
 #include <iostream>
+#include <optional>
 #include <fstream>
+#include <unistd.h>
 
 #include <tests/lib/WebServer.h>
 #include <tests/lib/TestTools.h>
@@ -94,6 +96,83 @@ BOOST_AUTO_TEST_CASE( http_prov )
   BOOST_REQUIRE_EQUAL( sum, std::string("63b4a45ec881d90b83c2e6af7bcbfa78") );
 }
 
+BOOST_AUTO_TEST_CASE( copy_file )
+{
+  auto ev = zyppng::EventLoop::create ();
+
+  const auto &workerPath = zypp::Pathname ( ZYPPNG_WORKERS_DIR );
+  zypp::filesystem::TmpDir provideRoot;
+
+  auto prov = zyppng::Provide::create ( provideRoot );
+  prov->setWorkerPath ( workerPath );
+  prov->start();
+
+  const zypp::Pathname source { provideRoot.path() / "source" };
+  {
+    std::ofstream out( source.c_str() );
+    out << "copy me";
+  }
+  const auto & content = []( const zypp::Pathname & file_r ) {
+    std::ifstream in( file_r.c_str() );
+    return std::string( std::istreambuf_iterator<char>( in ), std::istreambuf_iterator<char>() );
+  };
+
+  // returns whether the copy was done without asking a worker
+  const auto & copyFile = [&]( const zypp::Pathname & target_r ) {
+    auto op = prov->copyFile( source, target_r );
+    const bool inProcess = op->isReady();
+
+    std::optional<zyppng::expected<zypp::ManagedFile>> res;
+    op->onReady([&]( zyppng::expected<zypp::ManagedFile> &&res_r ){
+      ev->quit();
+      res = std::move(res_r);
+    });
+    if ( !res )
+      ev->run();
+
+    BOOST_REQUIRE( res && res->is_valid() );
+    (*res)->resetDispose();
+    BOOST_CHECK_EQUAL( (*res)->value(), target_r );
+    BOOST_CHECK_EQUAL( content( target_r ), "copy me" );
+    return inProcess;
+  };
+
+  // same filesystem: hardlinked in process
+  const zypp::Pathname target { provideRoot.path() / "target" };
+  BOOST_CHECK( copyFile( target ) );
+  BOOST_CHECK_EQUAL( zypp::PathInfo( target ).ino(), zypp::PathInfo( source ).ino() );
+
+  // target already is the source
+  BOOST_CHECK( copyFile( target ) );
+  BOOST_CHECK_EQUAL( zypp::PathInfo( target ).ino(), zypp::PathInfo( source ).ino() );
+
+  // an existing target is replaced
+  zypp::filesystem::unlink( target );
+  {
+    std::ofstream out( target.c_str() );
+    out << "existing target";
+  }
+  BOOST_CHECK( copyFile( target ) );
+  BOOST_CHECK_EQUAL( zypp::PathInfo( target ).ino(), zypp::PathInfo( source ).ino() );
+
+  // another filesystem: the copy worker does it
+  std::optional<zypp::filesystem::TmpDir> otherFs;
+  for ( const zypp::Pathname & dir : { zypp::Pathname("/dev/shm"), zypp::Pathname(TESTS_BUILD_DIR), zypp::Pathname("/var/tmp") } ) {
+    zypp::PathInfo pi( dir );
+    if ( pi.isDir() && pi.dev() != zypp::PathInfo( provideRoot.path() ).dev() && ::access( dir.c_str(), W_OK ) == 0 ) {
+      otherFs.emplace( dir );
+      break;
+    }
+  }
+  if ( !otherFs ) {
+    BOOST_TEST_MESSAGE( "No second filesystem to copy to, skipping the copy worker case" );
+    return;
+  }
+  const zypp::Pathname otherTarget { otherFs->path() / "target" };
+  BOOST_CHECK( !copyFile( otherTarget ) );
+  BOOST_CHECK( zypp::PathInfo( otherTarget ).ino() != zypp::PathInfo( source ).ino() );
+}
+
 BOOST_AUTO_TEST_CASE( http_attach )
 {
   using namespace zyppng::operators;
@@ -80,12 +80,16 @@ class ChksumProvider : public zyppng::worker::ProvideWorker
         return;
       }
 
-      std::string chksumType;
-      try {
-        chksumType = req->_spec.value( std::string_view("chksumType") ).asString();
-      } catch ( const zypp::Exception &excp ) {
-        ZYPP_CAUGHT(excp);
-
+      // several checksum types may be requested, the file is read just once
+      std::vector<std::string> chksumTypes;
+      for ( const auto & val : req->_spec.values( std::string_view("chksumType") ) ) {
+        if ( !val.isString() || val.asString().empty() ) {
+          chksumTypes.clear();
+          break;
+        }
+        chksumTypes.push_back( val.asString() );
+      }
+      if ( chksumTypes.empty() ) {
         std::string err = zypp::str::Str() << "No or invalid chksumType in request";
         ERR << err << std::endl;
 
@@ -110,9 +114,15 @@ class ChksumProvider : public zyppng::worker::ProvideWorker
         return;
       }
 
-      std::string filesum = zypp::filesystem::checksum( file, chksumType );
-      DBG << "Calculated checksum for : " << file << " with type: " << chksumType << " is " << filesum << std::endl;
-      provideSuccess( req->_spec.requestId(), false, file, {{chksumType, {filesum}}} );
+      const auto & filesums = zypp::filesystem::checksums( file, chksumTypes );
+      zyppng::HeaderValueMap extra;
+      for ( const std::string & chksumType : chksumTypes ) {
+        auto it = filesums.find( chksumType );
+        const std::string & filesum = ( it != filesums.end() ? it->second : std::string() );
+        DBG << "Calculated checksum for : " << file << " with type: " << chksumType << " is " << filesum << std::endl;
+        extra.set( chksumType, filesum );
+      }
+      provideSuccess( req->_spec.requestId(), false, file, extra );
     }
 
     void cancel(const std::deque<zyppng::worker::ProvideWorkerItemRef>::iterator &i ) override {
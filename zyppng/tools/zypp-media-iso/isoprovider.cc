@@ -9,6 +9,7 @@
 #include "isoprovider.h"
 #include <zypp-media/ng/private/providedbg_p.h>
 #include <zypp-media/ng/MediaVerifier>
+#include <zypp-media/ng/ProvideSpec>
 
 #include <zypp-core/fs/TmpPath.h>
 #include <zypp-core/fs/PathInfo.h>
@@ -16,9 +17,44 @@
 #include <iostream>
 #include <fstream>
 
+#include <unistd.h>
+
 #undef ZYPP_BASE_LOGGER_LOGGROUP
 #define ZYPP_BASE_LOGGER_LOGGROUP "IsoProvider"
 
+namespace {
+  const std::string isoReaderProperty { "isoReader" };
+
+  /*!
+   * Returns the \ref IsoReader serving \a dev, if the image is not mounted.
+   */
+  std::shared_ptr<IsoReader> isoReaderOf ( const zyppng::worker::Device &dev )
+  {
+    auto i = dev._properties.find( isoReaderProperty );
+    if ( i == dev._properties.end() )
+      return {};
+    return std::any_cast<std::shared_ptr<IsoReader>>( i->second );
+  }
+
+  /*!
+   * Whether to loop mount the image rather than reading it in process. This is needed for
+   * filesystems other than ISO9660 and if the client reads the attached tree directly via
+   * the local mount point (\ref zyppng::ATTACH_LOCAL_TREE, e.g. plaindir repos). An image
+   * read in process provides just the directories there, files are extracted on demand.
+   * ZYPP_MEDIA_ISO_MOUNT=1 always mounts.
+   */
+  bool mountImage ( const std::string &filesystem, bool localTree )
+  {
+    if ( localTree || ( filesystem != "auto" && filesystem != "iso9660" ) )
+      return true;
+    static const bool mount = [](){
+      const char *env = ::getenv( "ZYPP_MEDIA_ISO_MOUNT" );
+      return env && zypp::str::strToTrue( env );
+    }();
+    return mount;
+  }
+}
+
 RaiiHelper::~RaiiHelper()
 {
   _backingDriver->detachMedia( id );
@@ -101,15 +137,26 @@ zyppng::worker::AttachResult IsoProvider::mountDevice ( const uint32_t id, const
       }
     }
 
-    // first check if we have that device already
+    const int mediaNr = extras.value( zyppng::AttachMsgFields::MediaNr, 1 ).asInt();
+    const bool localTree = extras.value( zyppng::ATTACH_LOCAL_TREE, false ).asBool();
+
+    // images read in process need the files checked by isDesiredMedium to be extracted first
+    const auto &prepareMedium = [&]( const zyppng::worker::Device &dev ) {
+      extractFromImage( dev, relAttachRoot );
+      if ( verifier )
+        extractFromImage( dev, relAttachRoot / verifier->mediaFilePath( mediaNr ) );
+    };
+
+    // first check if we have that device already (an image read in process can't serve the local tree)
     const auto &devs = knownDevices();
     auto i = std::find_if( devs.begin(), devs.end(), [&]( const auto &d ) {
-      return d->_name == fullIsoUrl.asString();
+      return d->_name == fullIsoUrl.asString() && !( localTree && isoReaderOf( *d ) );
     });
     if ( i != devs.end() )  {
       // if we can find the device, isDesiredMedium needs to return true,
       // otherwise URL and verifier do not match and its not the desired medium
-      auto res = isDesiredMedium( attachUrl, (*i)->_mountPoint / relAttachRoot, verifier, extras.value( zyppng::AttachMsgFields::MediaNr, 1 ).asInt() );
+      prepareMedium( **i );
+      auto res = isDesiredMedium( attachUrl, (*i)->_mountPoint / relAttachRoot, verifier, mediaNr );
       if ( !res ) {
         try {
           std::rethrow_exception( res.error() );
@@ -127,6 +174,16 @@ zyppng::worker::AttachResult IsoProvider::mountDevice ( const uint32_t id, const
           );
         }
       } else {
+        try {
+          extractDirs( **i, relAttachRoot );
+        } catch( const zypp::Exception &e ) {
+          ZYPP_CAUGHT(e);
+          return zyppng::worker::AttachResult::error(
+            zyppng::ProvideMessage::Code::MountFailed
+            , false
+            , e
+          );
+        }
         attachedMedia().insert( std::make_pair( attachId, zyppng::worker::AttachedMedia{ *i, relAttachRoot } ) );
         return zyppng::worker::AttachResult::success( (*i)->_mountPoint / relAttachRoot );
       }
@@ -168,6 +225,59 @@ zyppng::worker::AttachResult IsoProvider::mountDevice ( const uint32_t id, const
           , false );
       }
 
+      // read the image in process if possible, this needs neither root nor a loop device
+      std::shared_ptr<IsoReader> reader;
+      if ( !mountImage( filesystem, localTree ) ) {
+        try {
+          reader = std::make_shared<IsoReader>( isopath );
+        } catch ( const zypp::Exception &e ) {
+          ZYPP_CAUGHT(e);
+          MIL << "Can't read " << isopath << " in process, mounting it." << std::endl;
+        }
+      }
+
+      if ( reader ) {
+        zypp::Pathname newAp = createAttachPoint( attachRoot() );
+        if ( newAp.empty() ) {
+          return zyppng::worker::AttachResult::error(
+            zyppng::ProvideMessage::Code::MountFailed
+            , "Failed to create attach directory."
+            , false
+          );
+        }
+
+        auto devPtr    = std::make_shared<zyppng::worker::Device>( zyppng::worker::Device{
+          ._name       = fullIsoUrl.asString(),
+          ._maj_nr = 0,
+          ._min_nr = 0,
+          ._mountPoint = newAp,
+          ._ephemeral  = true, // forget about the device after we are finished with it
+          ._properties = {}
+        });
+        devPtr->_properties["raiiHelper"] = hlpr;
+        devPtr->_properties[isoReaderProperty] = reader;
+
+        try {
+          prepareMedium( *devPtr );
+          if ( !isDesiredMedium( attachUrl, newAp / relAttachRoot, verifier, mediaNr ) )
+            ZYPP_THROW( zypp::media::MediaNotDesiredException( attachUrl ) );
+          extractDirs( *devPtr, relAttachRoot );
+        } catch ( const zypp::Exception &e ) {
+          ZYPP_CAUGHT(e);
+          unmountDevice( *devPtr );
+          return zyppng::worker::AttachResult::error(
+            zyppng::ProvideMessage::Code::MountFailed
+            , false
+            , e
+          );
+        }
+
+        MIL << "Reading " << isopath << " in process, serving " << relAttachRoot << " from " << newAp << std::endl;
+        knownDevices().push_back( devPtr );
+        attachedMedia().insert( std::make_pair( attachId, zyppng::worker::AttachedMedia{ devPtr, relAttachRoot } ) );
+        return zyppng::worker::AttachResult::success( devPtr->_mountPoint / relAttachRoot );
+      }
+
       // we have everything we need, let's try to mount it
       zypp::media::Mount mount;
       zypp::Pathname newAp;
@@ -225,7 +335,7 @@ zyppng::worker::AttachResult IsoProvider::mountDevice ( const uint32_t id, const
         }
 
         // if we reach this place, mount worked -> YAY, lets see if that is the desired medium!
-        auto isDesired = isDesiredMedium( attachUrl, newAp / relAttachRoot, verifier, extras.value( zyppng::AttachMsgFields::MediaNr, 1 ).asInt() );
+        auto isDesired = isDesiredMedium( attachUrl, newAp / relAttachRoot, verifier, mediaNr );
         if ( !isDesired ) {
           try {
             mount.umount( newAp.asString() );
@@ -397,3 +507,65 @@ zyppng::worker::AttachResult IsoProvider::mountDevice ( const uint32_t id, const
       , false);
   }
 }
+
+void IsoProvider::prepareFile ( const zyppng::worker::AttachedMedia &media, const zypp::Pathname &path )
+{
+  if ( media._dev )
+    extractFromImage( *media._dev, media._attachRoot / path );
+}
+
+void IsoProvider::unmountDevice ( zyppng::worker::Device &dev )
+{
+  if ( !isoReaderOf( dev ) ) {
+    DeviceDriver::unmountDevice( dev );
+    return;
+  }
+
+  // nothing mounted, just remove the directories and the files extracted on demand
+  if ( dev._mountPoint.empty() )
+    return;
+  zypp::filesystem::recursive_rmdir( dev._mountPoint );
+  dev._mountPoint = zypp::Pathname();
+}
+
+void IsoProvider::extractFromImage ( const zyppng::worker::Device &dev, const zypp::Pathname &path )
+{
+  const auto &reader = isoReaderOf( dev );
+  if ( !reader || dev._mountPoint.empty() )
+    return;
+
+  // absolutename() makes sure we never leave the mount point
+  const auto &relPath = path.absolutename();
+  const auto &target  = dev._mountPoint / relPath;
+  if ( zypp::PathInfo( target ).isExist() )
+    return;
+
+  const auto &entry = reader->lookup( relPath );
+  if ( !entry )
+    return;
+
+  if ( entry->_isDir ) {
+    zypp::filesystem::assert_dir( target );
+    return;
+  }
+
+  MIL << "Extracting " << relPath << " from " << reader->image() << std::endl;
+  zypp::filesystem::assert_dir( target.dirname() );
+  reader->extract( *entry, target );
+}
+
+void IsoProvider::extractDirs ( const zyppng::worker::Device &dev, const zypp::Pathname &path )
+{
+  const auto &reader = isoReaderOf( dev );
+  if ( !reader || dev._mountPoint.empty() )
+    return;
+
+  const auto &relPath = path.absolutename();
+  const auto &entry = reader->lookup( relPath );
+  if ( !entry || !entry->_isDir )
+    return;
+
+  zypp::filesystem::assert_dir( dev._mountPoint / relPath );
+  for ( const auto &name : reader->list( relPath ) )
+    extractDirs( dev, relPath / name );
+}
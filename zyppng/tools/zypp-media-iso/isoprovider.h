@@ -14,6 +14,7 @@
 #include "smbprovider.h"
 #include "diskprovider.h"
 #include "nfsprovider.h"
+#include "isoreader.h"
 
 
 struct RaiiHelper
@@ -31,7 +32,30 @@ class IsoProvider : public zyppng::worker::DeviceDriver
 
     zyppng::worker::AttachResult mountDevice ( const uint32_t id, const zypp::Url &attachUrl, const std::string &attachId, const std::string &label, const zyppng::HeaderValueMap &extras ) override;
 
+    /*!
+     * Images read by the \ref IsoReader are not mounted, just the directories of the attached
+     * tree are created below the attach point. This extracts \a path if it is still missing there.
+     */
+    void prepareFile ( const zyppng::worker::AttachedMedia &media, const zypp::Pathname &path ) override;
+
+  protected:
+    void unmountDevice ( zyppng::worker::Device &dev ) override;
+
   private:
+    /*!
+     * Makes \a path ( relative to the image root ) of the \ref IsoReader image of \a dev available
+     * below its mount point. Does nothing if it does not exist in the image.
+     */
+    void extractFromImage ( const zyppng::worker::Device &dev, const zypp::Pathname &path );
+
+    /*!
+     * Creates the directory \a path and all directories below it, but no files. Clients
+     * may check for directories via the local mount point (e.g. the repo type probing).
+     * Files are extracted on demand by \ref prepareFile. Clients reading files via the local
+     * mount point request \ref zyppng::ATTACH_LOCAL_TREE, the image is mounted then.
+     */
+    void extractDirs ( const zyppng::worker::Device &dev, const zypp::Pathname &path );
+
     std::shared_ptr<DirProvider>  _dirWorker;
     std::shared_ptr<DiskProvider> _diskWorker;
     std::shared_ptr<NfsProvider>  _nfsWorker;
@@ -0,0 +1,401 @@
+/*---------------------------------------------------------------------\
+|                          ____ _   __ __ ___                          |
+|                         |__  / \ / / . \ . \                         |
+|                           / / \ V /|  _/  _/                         |
+|                          / /__ | | | | | |                           |
+|                         /_____||_| |_| |_|                           |
+|                                                                      |
+\---------------------------------------------------------------------*/
+#include "isoreader.h"
+
+#include <zypp-core/base/Exception.h>
+#include <zypp-core/base/Logger.h>
+#include <zypp-core/base/String.h>
+#include <zypp-core/fs/PathInfo.h>
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <iterator>
+
+#undef ZYPP_BASE_LOGGER_LOGGROUP
+#define ZYPP_BASE_LOGGER_LOGGROUP "IsoReader"
+
+namespace
+{
+  constexpr uint64_t systemAreaBlocks = 16;  //< volume descriptors start after the system area
+  constexpr size_t   dirRecordMin     = 34;  //< size of a directory record with a 1 byte name
+  constexpr uint64_t dirSizeMax       = 64 * 1024 * 1024; //< sanity limit for directories read at once
+
+  // ISO9660 stores most numbers in both byte orders, we read the little endian ones
+  inline uint32_t le32( std::string_view d, size_t off )
+  {
+    return uint32_t( uint8_t(d[off]) ) | uint32_t( uint8_t(d[off+1]) ) << 8 | uint32_t( uint8_t(d[off+2]) ) << 16 | uint32_t( uint8_t(d[off+3]) ) << 24;
+  }
+
+  inline uint16_t le16( std::string_view d, size_t off )
+  {
+    return uint16_t( uint8_t(d[off]) ) | uint16_t( uint8_t(d[off+1]) ) << 8;
+  }
+
+  /** The UCS-2 (big endian) Joliet name \a name as UTF-8. */
+  std::string fromUcs2( std::string_view name )
+  {
+    std::string ret;
+    for ( size_t i = 0; i + 1 < name.size(); i += 2 ) {
+      unsigned ch = unsigned( uint8_t(name[i]) ) << 8 | uint8_t(name[i+1]);
+      if ( ch < 0x80 ) {
+        ret += char(ch);
+      } else if ( ch < 0x800 ) {
+        ret += char( 0xC0 | ch >> 6 );
+        ret += char( 0x80 | ( ch & 0x3F ) );
+      } else {
+        ret += char( 0xE0 | ch >> 12 );
+        ret += char( 0x80 | ( ( ch >> 6 ) & 0x3F ) );
+        ret += char( 0x80 | ( ch & 0x3F ) );
+      }
+    }
+    return ret;
+  }
+
+  /** Strip the ";<version>" suffix of an ISO9660 file name. */
+  std::string stripVersion( std::string name )
+  {
+    auto pos = name.rfind( ';' );
+    if ( pos != std::string::npos )
+      name.erase( pos );
+    return name;
+  }
+
+  /** The plain ISO9660 name \a name mapped like the kernel does ( map=normal ). */
+  std::string plainName( std::string_view name, bool isDir )
+  {
+    std::string ret { zypp::str::toLower( std::string(name) ) };
+    if ( !isDir ) {
+      ret = stripVersion( std::move(ret) );
+      if ( ret.size() > 1 && ret.back() == '.' )
+        ret.pop_back();
+    }
+    return ret;
+  }
+
+  /** Create an \ref IsoReader::Entry from the directory record \a rec. */
+  IsoReader::Entry entryFromRecord( std::string_view rec, uint32_t blockSize )
+  {
+    IsoReader::Entry e;
+    e._isDir = uint8_t(rec[25]) & 0x02;
+    e._size  = le32( rec, 10 );
+    e._extents.push_back( { uint64_t( le32( rec, 2 ) + uint8_t(rec[1]) ) * blockSize, e._size } );
+    return e;
+  }
+} // namespace
+
+IsoReader::IsoReader( const zypp::Pathname &image )
+  : _image( image )
+  , _fd( ::open( image.c_str(), O_RDONLY | O_CLOEXEC ) )
+{
+  if ( _fd == -1 )
+    ZYPP_THROW( zypp::Exception( zypp::str::Str() << "Can't open ISO image " << image << ": " << zypp::str::strerror( errno ) ) );
+
+  struct stat st;
+  if ( ::fstat( _fd, &st ) != 0 )
+    ZYPP_THROW( zypp::Exception( zypp::str::Str() << "Can't stat ISO image " << image << ": " << zypp::str::strerror( errno ) ) );
+  _imageSize = st.st_size;
+
+  std::optional<Entry> primaryRoot;
+  std::optional<Entry> jolietRoot;
+
+  // volume descriptors are always 2048 bytes, regardless of the logical block size
+  for ( uint64_t sector = systemAreaBlocks; ; ++sector ) {
+    const std::string &vd = read( sector * 2048, 2048 );
+    if ( vd.compare( 1, 5, "CD001" ) != 0 )
+      break;
+
+    const uint8_t type = vd[0];
+    if ( type == 255 )  // terminator
+      break;
+
+    if ( type == 1 && !primaryRoot ) {
+      _blockSize = le16( vd, 128 );
+      if ( _blockSize != 512 && _blockSize != 1024 && _blockSize != 2048 )
+        ZYPP_THROW( zypp::Exception( zypp::str::Str() << "Unsupported logical block size " << _blockSize << " in ISO image " << image ) );
+      primaryRoot = entryFromRecord( std::string_view(vd).substr( 156, dirRecordMin ), _blockSize );
+    }
+    else if ( type == 2 && !jolietRoot ) {
+      // Joliet is a supplementary volume descriptor using one of these UCS-2 escape sequences
+      const std::string_view esc = std::string_view(vd).substr( 88, 3 );
+      if ( esc == "%/@" || esc == "%/C" || esc == "%/E" )
+        jolietRoot = entryFromRecord( std::string_view(vd).substr( 156, dirRecordMin ), le16( vd, 128 ) );
+    }
+  }
+
+  if ( !primaryRoot )
+    ZYPP_THROW( zypp::Exception( zypp::str::Str() << "No ISO9660 filesystem in " << image ) );
+
+  // Rock Ridge is announced by a SUSP "SP" entry in the '.' record of the root directory
+  const std::string &rootData = read( primaryRoot->_extents.front().first, _blockSize );
+  const size_t dotLen = uint8_t(rootData[0]);
+  if ( dotLen >= dirRecordMin + 7 && dotLen <= rootData.size() ) {
+    const std::string_view su = std::string_view(rootData).substr( dirRecordMin, dotLen - dirRecordMin );
+    if ( su.substr( 0, 2 ) == "SP" && uint8_t(su[4]) == 0xBE && uint8_t(su[5]) == 0xEF ) {
+      _names = Names::RockRidge;
+      _suspSkip = uint8_t(su[6]);
+    }
+  }
+
+  if ( _names != Names::RockRidge && jolietRoot ) {
+    _names = Names::Joliet;
+    _root = *jolietRoot;
+  } else {
+    _root = *primaryRoot;
+  }
+  _root._isDir = true;
+
+  MIL << "Opened ISO image " << image << " using " << nameFormat() << " names" << std::endl;
+}
+
+std::string IsoReader::nameFormat() const
+{
+  switch ( _names ) {
+    case Names::RockRidge: return "rockridge";
+    case Names::Joliet:    return "joliet";
+    case Names::Plain:     break;
+  }
+  return "iso9660";
+}
+
+std::string IsoReader::read( uint64_t offset, uint64_t len ) const
+{
+  // offsets and lengths are taken from the image, never trust them
+  if ( offset > _imageSize || len > _imageSize - offset )
+    ZYPP_THROW( zypp::Exception( zypp::str::Str() << "Invalid data location in ISO image " << _image ) );
+
+  std::string ret( len, '\0' );
+  uint64_t done = 0;
+  while ( done < len ) {
+    ssize_t res = ::pread( _fd, ret.data() + done, len - done, offset + done );
+    if ( res < 0 && errno == EINTR )
+      continue;
+    if ( res < 0 )
+      ZYPP_THROW( zypp::Exception( zypp::str::Str() << "Can't read ISO image " << _image << ": " << zypp::str::strerror( errno ) ) );
+    if ( res == 0 )
+      ZYPP_THROW( zypp::Exception( zypp::str::Str() << "ISO image " << _image << " is truncated" ) );
+    done += res;
+  }
+  return ret;
+}
+
+std::optional<std::string> IsoReader::rockRidgeName( std::string_view susp, Entry &entry, bool &skip ) const
+{
+  std::optional<std::string> name;
+  std::string area;         // a continuation area being parsed
+  std::string continuation; // the next one
+  unsigned areas = 0;
+
+  while ( true ) {
+    while ( susp.size() >= 4 ) {
+      const std::string_view sig = susp.substr( 0, 2 );
+      const size_t len = uint8_t(susp[2]);
+      if ( len < 4 || len > susp.size() )
+        break;
+      const std::string_view data = susp.substr( 4, len - 4 );
+
+      if ( sig == "NM" && !data.empty() ) {
+        // flags: 0x02 current dir, 0x04 parent dir, the name may be continued in the next NM entry
+        if ( !( uint8_t(data[0]) & 0x06 ) ) {
+          if ( !name )
+            name = std::string();
+          name->append( data.substr( 1 ) );
+        }
+      }
+      else if ( sig == "CE" && data.size() >= 24 ) {
+        // the system use area continues elsewhere, within a single block
+        const uint32_t ceOffset = le32( data, 8 );
+        const uint32_t ceLen    = le32( data, 16 );
+        if ( ceOffset > _blockSize || ceLen > _blockSize - ceOffset )
+          ZYPP_THROW( zypp::Exception( zypp::str::Str() << "Invalid continuation area in ISO image " << _image ) );
+        continuation = read( uint64_t( le32( data, 0 ) ) * _blockSize + ceOffset, ceLen );
+      }
+      else if ( sig == "PX" && data.size() >= 8 ) {
+        // symlinks, sockets etc. are not provided
+        const uint32_t mode = le32( data, 0 );
+        if ( !S_ISREG(mode) && !S_ISDIR(mode) )
+          skip = true;
+      }
+      else if ( sig == "RE" ) {
+        // a relocated directory, it is listed again at its original place via "CL"
+        skip = true;
+      }
+      else if ( sig == "CL" && data.size() >= 8 ) {
+        // placeholder of a directory relocated elsewhere; its size is in its own '.' record
+        const uint64_t offset = uint64_t( le32( data, 0 ) ) * _blockSize;
+        const std::string &dot = read( offset, dirRecordMin );
+        entry._isDir = true;
+        entry._size  = le32( dot, 10 );
+        entry._extents = { { offset, entry._size } };
+      }
+      else if ( sig == "ST" ) {
+        break;
+      }
+      susp.remove_prefix( len );
+    }
+
+    if ( continuation.empty() || ++areas > 16 )
+      break;
+    area = std::move(continuation);
+    continuation.clear();
+    susp = area;
+  }
+  return name;
+}
+
+IsoReader::Directory IsoReader::readDirectory( const Entry &dir ) const
+{
+  Directory ret;
+  std::string lastMultiExtent;
+
+  for ( const auto &[ offset, length ] : dir._extents ) {
+    if ( length > dirSizeMax )
+      ZYPP_THROW( zypp::Exception( zypp::str::Str() << "Directory too large in ISO image " << _image ) );
+    const std::string &data = read( offset, length );
+    size_t pos = 0;
+    while ( pos < data.size() ) {
+      const size_t recLen = uint8_t(data[pos]);
+      if ( recLen == 0 ) {
+        // records do not cross block boundaries, the rest of the block is padding
+        pos = ( pos / _blockSize + 1 ) * _blockSize;
+        continue;
+      }
+      if ( recLen < dirRecordMin || pos + recLen > data.size() )
+        ZYPP_THROW( zypp::Exception( zypp::str::Str() << "Invalid directory record in ISO image " << _image ) );
+
+      const std::string_view rec = std::string_view(data).substr( pos, recLen );
+      pos += recLen;
+
+      const size_t nameLen = uint8_t(rec[32]);
+      if ( dirRecordMin - 1 + nameLen > recLen )
+        ZYPP_THROW( zypp::Exception( zypp::str::Str() << "Invalid directory record in ISO image " << _image ) );
+      const std::string_view rawName = rec.substr( 33, nameLen );
+      if ( nameLen == 1 && ( rawName[0] == '\0' || rawName[0] == '\1' ) )
+        continue; // '.' and '..'
+
+      Entry entry = entryFromRecord( rec, _blockSize );
+      const uint8_t flags = rec[25];
+
+      std::string name;
+      switch ( _names ) {
+        case Names::RockRidge: {
+          const size_t suOff = 33 + nameLen + ( nameLen % 2 ? 0 : 1 ) + _suspSkip;
+          bool skip = false;
+          std::optional<std::string> rrName;
+          if ( suOff < recLen )
+            rrName = rockRidgeName( rec.substr( suOff ), entry, skip );
+          if ( skip )
+            continue;
+          name = rrName ? *rrName : plainName( rawName, entry._isDir );
+          break;
+        }
+        case Names::Joliet:
+          name = stripVersion( fromUcs2( rawName ) );
+          break;
+        case Names::Plain:
+          name = plainName( rawName, entry._isDir );
+          break;
+      }
+      if ( name.empty() || name == "." || name == ".." || name.find( '/' ) != std::string::npos )
+        continue;
+
+      // files of 4GiB and more are stored as consecutive records of the same name
+      auto i = ret.find( name );
+      if ( i != ret.end() && name == lastMultiExtent ) {
+        i->second._size += entry._size;
+        i->second._extents.push_back( entry._extents.front() );
+      } else {
+        ret[name] = std::move(entry);
+      }
+      lastMultiExtent = ( flags & 0x80 ) ? name : std::string();
+    }
+  }
+  return ret;
+}
+
+const IsoReader::Directory &IsoReader::directory( const std::string &path, const Entry &dir )
+{
+  auto i = _dirs.find( path );
+  if ( i == _dirs.end() )
+    i = _dirs.insert( { path, readDirectory( dir ) } ).first;
+  return i->second;
+}
+
+std::optional<IsoReader::Entry> IsoReader::lookup( const zypp::Pathname &path )
+{
+  std::vector<std::string> comps;
+  zypp::str::split( path.absolutename().asString(), std::back_inserter(comps), "/" );
+
+  Entry current = _root;
+  std::string currentPath = "/";
+  for ( const auto &comp : comps ) {
+    if ( !current._isDir )
+      return {};
+
+    const Directory &dir = directory( currentPath, current );
+    auto i = dir.find( comp );
+    if ( i == dir.end() )
+      return {};
+    current = i->second;
+    currentPath = ( zypp::Pathname(currentPath) / comp ).asString();
+  }
+  return current;
+}
+
+std::vector<std::string> IsoReader::list( const zypp::Pathname &path )
+{
+  std::vector<std::string> ret;
+  const auto &entry = lookup( path );
+  if ( !entry || !entry->_isDir )
+    return ret;
+
+  for ( const auto &[ name, e ] : directory( path.absolutename().asString(), *entry ) )
+    ret.push_back( name );
+  return ret;
+}
+
+void IsoReader::extract( const Entry &entry, const zypp::Pathname &target ) const
+{
+  if ( entry._isDir )
+    ZYPP_THROW( zypp::Exception( zypp::str::Str() << "Can't extract directory to " << target ) );
+
+  // write to a temporary file first, so a failure never leaves a partial target file behind
+  const zypp::Pathname &tmp = target.extend( ".XXXXXX" );
+  std::string tmpName = tmp.asString();
+  zypp::AutoFD out( ::mkostemp( tmpName.data(), O_CLOEXEC ) );
+  if ( out == -1 )
+    ZYPP_THROW( zypp::Exception( zypp::str::Str() << "Can't create " << tmp << ": " << zypp::str::strerror( errno ) ) );
+
+  try {
+    constexpr uint64_t chunkSize = 1024 * 1024;
+    for ( const auto &[ offset, length ] : entry._extents ) {
+      for ( uint64_t done = 0; done < length; ) {
+        const std::string &chunk = read( offset + done, std::min( chunkSize, length - done ) );
+        for ( size_t written = 0; written < chunk.size(); ) {
+          ssize_t res = ::write( out, chunk.data() + written, chunk.size() - written );
+          if ( res < 0 && errno == EINTR )
+            continue;
+          if ( res < 0 )
+            ZYPP_THROW( zypp::Exception( zypp::str::Str() << "Can't write " << target << ": " << zypp::str::strerror( errno ) ) );
+          written += res;
+        }
+        done += chunk.size();
+      }
+    }
+    ::fchmod( out, 0644 );
+    if ( zypp::filesystem::rename( tmpName, target ) != 0 )
+      ZYPP_THROW( zypp::Exception( zypp::str::Str() << "Can't rename " << tmpName << " to " << target ) );
+  } catch ( ... ) {
+    zypp::filesystem::unlink( tmpName );
+    throw;
+  }
+}
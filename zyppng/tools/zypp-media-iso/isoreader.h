@@ -0,0 +1,98 @@
+/*---------------------------------------------------------------------\
+|                          ____ _   __ __ ___                          |
+|                         |__  / \ / / . \ . \                         |
+|                           / / \ V /|  _/  _/                         |
+|                          / /__ | | | | | |                           |
+|                         /_____||_| |_| |_|                           |
+|                                                                      |
+\---------------------------------------------------------------------*/
+#ifndef ZYPP_NG_TOOLS_ISOREADER_H_INCLUDED
+#define ZYPP_NG_TOOLS_ISOREADER_H_INCLUDED
+
+#include <zypp-core/Pathname.h>
+#include <zypp-core/AutoDispose.h>
+
+#include <cstdint>
+#include <map>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+/*!
+ * Reads files from an ISO9660 image without mounting it.
+ *
+ * File names are taken from the Rock Ridge extension if the image has one,
+ * otherwise from the Joliet tree. Plain ISO9660 names are mapped like the
+ * kernel does by default (lowercase, version suffix stripped).
+ * Directories are read on demand and cached.
+ *
+ * Only regular files and directories are provided. Rock Ridge symlinks,
+ * device files etc. are skipped and not found by \ref lookup.
+ *
+ * Locations and sizes read from the image are checked against the image
+ * size, a malformed image results in a zypp::Exception.
+ */
+class IsoReader
+{
+  public:
+    struct Entry
+    {
+      bool _isDir = false;
+      uint64_t _size = 0;
+      std::vector<std::pair<uint64_t,uint64_t>> _extents; //!< offset and length of the data in the image
+    };
+
+    /*!
+     * Opens the ISO9660 image \a image.
+     * \throws zypp::Exception if the file can not be read or is not an ISO9660 image
+     */
+    IsoReader( const zypp::Pathname &image );
+
+    const zypp::Pathname &image() const
+    { return _image; }
+
+    /*!
+     * Returns the name of the directory tree used: "rockridge", "joliet" or "iso9660".
+     */
+    std::string nameFormat() const;
+
+    /*!
+     * Returns the entry for \a path (relative to the root of the image), if it exists.
+     * \throws zypp::Exception if the image can not be read
+     */
+    std::optional<Entry> lookup( const zypp::Pathname &path );
+
+    /*!
+     * Returns the names of the entries in the directory \a path, empty if it is no directory.
+     * \throws zypp::Exception if the image can not be read
+     */
+    std::vector<std::string> list( const zypp::Pathname &path );
+
+    /*!
+     * Writes the content of the file \a entry to \a target.
+     * \throws zypp::Exception on error
+     */
+    void extract( const Entry &entry, const zypp::Pathname &target ) const;
+
+  private:
+    enum class Names { RockRidge, Joliet, Plain };
+    using Directory = std::map<std::string, Entry>;
+
+    std::string read( uint64_t offset, uint64_t len ) const;
+    Directory readDirectory( const Entry &dir ) const;
+    const Directory &directory( const std::string &path, const Entry &dir );
+    std::optional<std::string> rockRidgeName( std::string_view susp, Entry &entry, bool &skip ) const;
+
+    zypp::Pathname _image;
+    zypp::AutoFD _fd;
+    uint64_t _imageSize = 0;
+    uint32_t _blockSize = 2048;
+    Names _names = Names::Plain;
+    unsigned _suspSkip = 0;
+    Entry _root;
+    std::unordered_map<std::string, Directory> _dirs;
+};
+
+#endif